@@ -0,0 +1,153 @@
+/**
+ * boot_profile.h
+ * Boot timeline: when each bring-up phase started and ended, and on which
+ * core, printed once the last one has finished.
+ *
+ *   int h = bootBegin("lvgl");  ...  bootEnd(h);     a timed phase
+ *   bootMark("first frame");                         a point in time
+ *
+ * Phases may run in parallel on other tasks (the I2C probe and the MCP2515
+ * configuration run on the CAN core while setup() builds the first screen).
+ * Such a task calls bootParallelBegin() before it is created and
+ * bootParallelEnd() when its part is done; bootProfileComplete() turns true
+ * after setup() has called bootProfileSetupDone() and every parallel part
+ * has ended.  The timeline is then read-only and printed line by line:
+ *
+ *       0.2 ms +   0.3 ms  c1 |#                             | nvs
+ *       0.1 ms +  41.2 ms  c0 |##############################| i2c + rtc
+ *       0.5 ms +   3.1 ms  c0 |###                           | mcp2515
+ *       0.6 ms +  12.8 ms  c1 |##########                    | lvgl
+ *      13.5 ms             c1 |         |                    | first frame
+ *
+ * Times are micros() since reset on the device, since start-up on the host.
+ * Phase names must be string literals (only the pointer is kept).
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#define BOOT_PROFILE_MAX   24   // phases and marks recorded, the rest are dropped
+#define BOOT_PROFILE_BAR   30   // width of the timeline bar in characters
+
+enum BootSpanState : uint8_t { BOOT_RUNNING, BOOT_DONE, BOOT_MARK };
+
+struct BootSpan {
+    const char   *name;
+    uint32_t      startUs;
+    uint32_t      endUs;
+    uint8_t       core;
+    BootSpanState state;
+};
+
+static BootSpan              s_bootSpans[BOOT_PROFILE_MAX];
+static std::atomic<uint32_t> s_bootSpanNext{0};
+static std::atomic<int>      s_bootPending{1};   // setup() itself, plus parallel parts
+
+static inline uint8_t _bootCore(void) {
+#if defined(ESP_PLATFORM)
+    return (uint8_t)xPortGetCoreID();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Start timing a phase.
+ * @return its handle for bootEnd(), or -1 if the timeline is full
+ */
+static int bootBegin(const char *name) {
+    uint32_t i = s_bootSpanNext.fetch_add(1, std::memory_order_relaxed);
+    if (i >= BOOT_PROFILE_MAX) return -1;
+    uint32_t now = micros();
+    s_bootSpans[i] = { name, now, now, _bootCore(), BOOT_RUNNING };
+    return (int)i;
+}
+
+static void bootEnd(int h) {
+    if (h < 0) return;
+    s_bootSpans[h].endUs = micros();
+    s_bootSpans[h].state = BOOT_DONE;
+}
+
+/** Record a point in time, e.g. the first frame reaching the panel. */
+static void bootMark(const char *name) {
+    int h = bootBegin(name);
+    if (h >= 0) s_bootSpans[h].state = BOOT_MARK;
+}
+
+/** A phase is about to be started on another task; call before creating it. */
+static inline void bootParallelBegin(void) {
+    s_bootPending.fetch_add(1, std::memory_order_relaxed);
+}
+
+/** That task's boot work is done (its spans are ended). */
+static inline void bootParallelEnd(void) {
+    s_bootPending.fetch_sub(1, std::memory_order_release);
+}
+
+/** setup() has finished its own phases. */
+static inline void bootProfileSetupDone(void) {
+    s_bootPending.fetch_sub(1, std::memory_order_release);
+}
+
+/** True once every phase has ended: the timeline can be read. */
+static inline bool bootProfileComplete(void) {
+    return s_bootPending.load(std::memory_order_acquire) == 0;
+}
+
+/** Number of recorded phases and marks. */
+static inline int bootProfileCount(void) {
+    uint32_t n = s_bootSpanNext.load(std::memory_order_relaxed);
+    return n < BOOT_PROFILE_MAX ? (int)n : BOOT_PROFILE_MAX;
+}
+
+/** End of the last phase (µs): how long the whole bring-up took. */
+static uint32_t bootProfileEndUs(void) {
+    uint32_t end = 0;
+    for (int i = 0; i < bootProfileCount(); i++) {
+        if (s_bootSpans[i].endUs > end) end = s_bootSpans[i].endUs;
+    }
+    return end;
+}
+
+/**
+ * Phase i as one timeline line (see the top of this file) into buf.
+ * @return buf
+ */
+static char *bootProfileLine(int i, char *buf, size_t size) {
+    const BootSpan &s = s_bootSpans[i];
+    uint32_t total = bootProfileEndUs();
+    if (total == 0) total = 1;
+    char bar[BOOT_PROFILE_BAR + 1];
+    memset(bar, ' ', BOOT_PROFILE_BAR);
+    bar[BOOT_PROFILE_BAR] = '\0';
+    int from = (int)((uint64_t)s.startUs * (BOOT_PROFILE_BAR - 1) / total);
+    int to   = s.state == BOOT_RUNNING
+             ? BOOT_PROFILE_BAR - 1
+             : (int)((uint64_t)s.endUs * (BOOT_PROFILE_BAR - 1) / total);
+    for (int c = from; c <= to && c < BOOT_PROFILE_BAR; c++) {
+        bar[c] = s.state == BOOT_MARK ? '|' : '#';
+    }
+
+    if (s.state == BOOT_MARK) {
+        snprintf(buf, size, "%7.1f ms             c%u |%s| %s",
+                 s.startUs / 1000.0f, (unsigned)s.core, bar, s.name);
+    } else if (s.state == BOOT_RUNNING) {
+        snprintf(buf, size, "%7.1f ms +  running  c%u |%s| %s",
+                 s.startUs / 1000.0f, (unsigned)s.core, bar, s.name);
+    } else {
+        snprintf(buf, size, "%7.1f ms + %5.1f ms  c%u |%s| %s",
+                 s.startUs / 1000.0f, (s.endUs - s.startUs) / 1000.0f,
+                 (unsigned)s.core, bar, s.name);
+    }
+    return buf;
+}
@@ -0,0 +1,39 @@
+/**
+ * can_backend.h
+ * The CAN controller the CAN task reads, chosen at build time (CAN_BACKEND).
+ *
+ *   CAN_BACKEND_MCP2515   can_mcp2515.h – the external MCP2515 on SPI: two
+ *                         receive buffers, six acceptance filters, one SPI
+ *                         burst per frame (mcp2515_rx.h)
+ *   CAN_BACKEND_TWAI      can_twai.h – the ESP32-S3's own TWAI controller:
+ *                         the driver's ISR moves frames into a queue of
+ *                         CAN_TWAI_RX_QUEUE_LEN, so a frame costs no SPI
+ *                         traffic; two acceptance filters (dual-filter mode)
+ *
+ * Each defines a class with the same members, typedef'd to CanBackend:
+ *
+ *   name()                  "mcp2515" / "twai", for logs and the boot timeline
+ *   begin()                 bitrate, the decoder's acceptance filters, start;
+ *                           call on the CAN task, which then owns the backend
+ *   wait(ms)                sleep until frames may be pending, at most ms
+ *   takeIrqUs()             micros() of the interrupt not yet serviced, or 0
+ *   read(out[2])            up to two pending frames; 0 once none are left
+ *   pollErrors()            error state into can_health.h, every
+ *                           CAN_HEALTH_POLL_MS
+ *   format(buf, size)       receive cost since the last call, for [CANB]
+ *
+ * The simulator and benches use host versions of both, over models of the
+ * hardware (sim/can_backend_host.h).
+ */
+
+#pragma once
+
+#include "config.h"
+
+#if CAN_BACKEND == CAN_BACKEND_TWAI
+#include "can_twai.h"
+typedef CanTwaiBackend CanBackend;
+#else
+#include "can_mcp2515.h"
+typedef CanMcp2515Backend CanBackend;
+#endif
@@ -0,0 +1,297 @@
+/**
+ * can_filter.h
+ * MCP2515 acceptance-filter planner.
+ *
+ * The controller has two receive buffers.  RXB0 checks a frame against
+ * filters RXF0–1 under MASK0 and RXB1 against RXF2–5 under MASK1; a frame
+ * passes a filter when (id & mask) == (filter & mask).  Exact filters
+ * therefore cover at most six ids; beyond that a mask has to leave bits
+ * free, and every filter then admits 2^free ids, most of them unwanted.
+ *
+ * canFilterPlan() takes the standard (11-bit) ids the decoder needs and
+ * chooses both masks and all six filters so the fewest other ids get
+ * through.  The search is exhaustive, with three cuts that cannot lose the
+ * best plan:
+ *
+ *   - only bits on which the wanted ids differ are ever left free (freeing
+ *     any other bit doubles a buffer's acceptance and merges nothing);
+ *   - a mask is only scored if it is tight: every free bit varies within
+ *     one of the buffer's classes (ids equal under the mask).  Fixing a bit
+ *     that does not keeps the same classes at half the acceptance;
+ *   - a buffer's mask stops widening once 2^free alone admits as many ids
+ *     as the best plan so far.
+ *
+ * For every MASK0 by ascending number of free bits, RXB0 takes none, one or
+ * two of the wanted ids' classes.  RXB1 takes the rest in at most four
+ * classes, found by growing the set of bits MASK1 fixes one at a time and
+ * abandoning a set once it separates more than four.  The score is the
+ * exact number of ids either buffer admits.
+ *
+ * Planning takes microseconds for a handful of ids and milliseconds for a
+ * dozen or two from one ECU's range; it runs once, at start-up.
+ * bench_can_filter checks the plans against a brute-force search.
+ *
+ * The ESP32's TWAI controller in dual-filter mode poses the same problem
+ * with one filter per mask: canFilterPlanBanks(..., 1, 1) plans it, and
+ * canFilterTwaiDual() turns the plan into the driver's code and mask.
+ *
+ *   CanFilterPlan plan;
+ *   if (!canFilterPlan(plan, ids, count)) ...write plan.mask[] / plan.filter[]
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CAN_FILTER_MAX_IDS  32          // wanted ids a plan can cover
+#define CAN_FILTER_ID_BITS  11
+#define CAN_FILTER_ID_MASK  0x7FFu
+
+/** Masks and filters for the MCP2515, plus what they let through. */
+struct CanFilterPlan {
+    uint16_t mask[2];       // MASK0 (RXB0), MASK1 (RXB1)
+    uint16_t filter[6];     // RXF0–1 under MASK0, RXF2–5 under MASK1
+    uint16_t accepted;      // standard ids admitted by either buffer
+    uint16_t unwanted;      // ... that were not asked for
+};
+
+/** True if a standard id passes the plan's filters. */
+static inline bool canFilterAccepts(const CanFilterPlan &plan, uint32_t id) {
+    for (int f = 0; f < 6; f++) {
+        uint16_t m = plan.mask[f < 2 ? 0 : 1];
+        if (((id ^ plan.filter[f]) & m) == 0) return true;
+    }
+    return false;
+}
+
+// ── Search ────────────────────────────────────────────────────────────────────
+
+/** The wanted ids' classes (distinct id & mask) under one mask. */
+struct _CanFilterClasses {
+    uint16_t value[CAN_FILTER_MAX_IDS];
+    uint16_t first[CAN_FILTER_MAX_IDS];     // an id of the class
+    uint16_t varying[CAN_FILTER_MAX_IDS];   // bits its ids differ on
+    uint32_t members[CAN_FILTER_MAX_IDS];   // bit i: ids[i]
+    uint8_t  count;
+};
+
+/** Working state of one canFilterPlan() call. */
+struct _CanFilterSearch {
+    uint16_t ids[CAN_FILTER_MAX_IDS];
+    uint8_t  count;
+    uint8_t  filters0, filters1;            // filters under MASK0 (1–2) and MASK1 (1–4)
+    uint32_t withBit[CAN_FILTER_ID_BITS];   // bit i: ids[i] has that bit set
+    // RXB0 of the candidate being completed
+    uint16_t mask0;
+    uint16_t value0[2];
+    uint8_t  used0;
+    // best so far
+    CanFilterPlan best;
+    uint32_t bestAccepted;
+};
+
+/** Bits on which the ids selected by set differ. */
+static inline uint16_t _canFilterVarying(const _CanFilterSearch &s, uint32_t set) {
+    uint16_t ref = 0, varying = 0;
+    bool first = true;
+    for (uint8_t i = 0; i < s.count; i++) {
+        if (!(set & (1u << i))) continue;
+        if (first) { ref = s.ids[i]; first = false; }
+        varying |= s.ids[i] ^ ref;
+    }
+    return varying;
+}
+
+/** Classes of the ids selected by set under mask. */
+static inline void _canFilterClassify(const _CanFilterSearch &s, uint32_t set, uint16_t mask,
+                                      _CanFilterClasses &c) {
+    c.count = 0;
+    for (uint8_t i = 0; i < s.count; i++) {
+        if (!(set & (1u << i))) continue;
+        uint16_t v = s.ids[i] & mask;
+        uint8_t k = 0;
+        while (k < c.count && c.value[k] != v) k++;
+        if (k == c.count) {
+            c.value[k]   = v;
+            c.first[k]   = s.ids[i];
+            c.varying[k] = 0;
+            c.members[k] = 0;
+            c.count++;
+        }
+        c.varying[k] |= s.ids[i] ^ c.first[k];
+        c.members[k] |= 1u << i;
+    }
+}
+
+/** Ids admitted by both filter (a, ma) and filter (b, mb). */
+static inline uint32_t _canFilterOverlap(uint16_t a, uint16_t ma, uint16_t b, uint16_t mb) {
+    uint16_t both = ma & mb;
+    if ((a ^ b) & both) return 0;
+    return 1u << (CAN_FILTER_ID_BITS - __builtin_popcount(ma | mb));
+}
+
+/** Keep (mask1, values1) with the current RXB0 if it admits fewer ids. */
+static inline void _canFilterConsider(_CanFilterSearch &s, uint16_t mask1,
+                                      const uint16_t *values1, uint8_t used1) {
+    uint32_t per0 = 1u << (CAN_FILTER_ID_BITS - __builtin_popcount(s.mask0));
+    uint32_t per1 = 1u << (CAN_FILTER_ID_BITS - __builtin_popcount(mask1));
+    if (used1 * per1 >= s.bestAccepted) return;
+    uint32_t accepted = s.used0 * per0 + used1 * per1;
+    for (uint8_t a = 0; a < s.used0; a++) {
+        for (uint8_t b = 0; b < used1; b++) {
+            accepted -= _canFilterOverlap(s.value0[a], s.mask0, values1[b], mask1);
+        }
+    }
+    if (accepted >= s.bestAccepted) return;
+
+    // An unused buffer repeats an exact filter for a wanted id: it admits
+    // nothing new.  Unused filters repeat their buffer's first one.
+    CanFilterPlan &p = s.best;
+    p.mask[0] = s.used0 ? s.mask0 : CAN_FILTER_ID_MASK;
+    p.mask[1] = used1   ? mask1   : CAN_FILTER_ID_MASK;
+    for (uint8_t f = 0; f < 2; f++) {
+        p.filter[f] = s.used0 ? s.value0[f < s.used0 ? f : 0] : s.ids[0];
+    }
+    for (uint8_t f = 0; f < 4; f++) {
+        p.filter[2 + f] = used1 ? values1[f < used1 ? f : 0] : s.ids[0];
+    }
+    s.bestAccepted = accepted;
+}
+
+/**
+ * RXB1 for the ids in rest, given the current RXB0.  RXB1's classes are told
+ * apart by the varying bits its mask fixes ("split" bits); the others are
+ * left free.  Split sets grow one bit at a time, each bit splitting the
+ * classes found so far (bitsets of ids); a set that separates more classes
+ * than RXB1 has filters is not grown further.
+ */
+static inline void _canFilterBank1Split(_CanFilterSearch &s, uint16_t varying, uint16_t split,
+                                        const uint32_t *classes, uint8_t used, uint8_t nextBit) {
+    // Only tight masks are worth scoring: every free bit varies in a class
+    uint16_t freeBits = varying & ~split, inside = 0;
+    for (uint8_t b = 0; b < CAN_FILTER_ID_BITS; b++) {
+        if (!(freeBits & (1u << b))) continue;
+        for (uint8_t k = 0; k < used; k++) {
+            uint32_t set = classes[k] & s.withBit[b];
+            if (set && set != classes[k]) { inside |= 1u << b; break; }
+        }
+    }
+    if (inside == freeBits) {
+        uint16_t mask = CAN_FILTER_ID_MASK & ~freeBits;
+        uint16_t values[4];
+        for (uint8_t k = 0; k < used; k++) values[k] = s.ids[__builtin_ctz(classes[k])] & mask;
+        _canFilterConsider(s, mask, values, used);
+    }
+
+    for (uint8_t b = nextBit; b < CAN_FILTER_ID_BITS; b++) {
+        if (!(varying & (1u << b))) continue;
+        uint32_t next[4];
+        uint8_t  n = 0;
+        for (uint8_t k = 0; k < used && n <= 4; k++) {
+            const uint32_t halves[2] = { classes[k] & s.withBit[b], classes[k] & ~s.withBit[b] };
+            for (uint32_t h : halves) {
+                if (!h) continue;
+                if (n < 4) next[n] = h;
+                n++;
+            }
+        }
+        if (n <= s.filters1) _canFilterBank1Split(s, varying, split | (1u << b), next, n, b + 1);
+    }
+}
+
+static inline void _canFilterBank1(_CanFilterSearch &s, uint32_t rest) {
+    if (!rest) {
+        _canFilterConsider(s, CAN_FILTER_ID_MASK, nullptr, 0);
+        return;
+    }
+    _canFilterBank1Split(s, _canFilterVarying(s, rest), 0, &rest, 1, 0);
+}
+
+/**
+ * Plan the acceptance filters for count standard ids (duplicates allowed),
+ * with filters0 (1–2) filters under MASK0 and filters1 (1–4) under MASK1.
+ * Filters a bank does not have repeat its first one in the plan.
+ * @return nullptr, or why no plan was made (plan is then left untouched)
+ */
+static inline const char *canFilterPlanBanks(CanFilterPlan &plan, const uint32_t *ids, size_t count,
+                                             uint8_t filters0, uint8_t filters1) {
+    if (count == 0) return "no ids";
+    _CanFilterSearch s;
+    s.count    = 0;
+    s.filters0 = filters0 < 2 ? 1 : 2;
+    s.filters1 = filters1 < 1 ? 1 : filters1 > 4 ? 4 : filters1;
+    for (size_t i = 0; i < count; i++) {
+        if (ids[i] > CAN_FILTER_ID_MASK) return "extended id";
+        uint8_t k = 0;
+        while (k < s.count && s.ids[k] != ids[i]) k++;
+        if (k < s.count) continue;
+        if (s.count == CAN_FILTER_MAX_IDS) return "too many ids";
+        s.ids[s.count++] = (uint16_t)ids[i];
+    }
+    uint32_t all = s.count == 32 ? 0xFFFFFFFFu : (1u << s.count) - 1;
+    for (uint8_t b = 0; b < CAN_FILTER_ID_BITS; b++) {
+        s.withBit[b] = 0;
+        for (uint8_t i = 0; i < s.count; i++) {
+            if (s.ids[i] & (1u << b)) s.withBit[b] |= 1u << i;
+        }
+    }
+
+    // Start from "accept everything", which any real plan beats
+    s.bestAccepted = (1u << CAN_FILTER_ID_BITS) + 1;
+
+    // RXB0 unused: RXB1 alone covers every id
+    s.mask0 = CAN_FILTER_ID_MASK;
+    s.used0 = 0;
+    _canFilterBank1(s, all);
+
+    uint16_t varying = _canFilterVarying(s, all);
+    uint8_t  levels  = __builtin_popcount(varying);
+    _CanFilterClasses c;
+    for (uint8_t freeBits = 0; freeBits <= levels; freeBits++) {
+        uint32_t per = 1u << freeBits;
+        if (per >= s.bestAccepted) break;
+        uint16_t sub = 0;
+        do {
+            if (__builtin_popcount(sub) == freeBits) {
+                s.mask0 = CAN_FILTER_ID_MASK & ~sub;
+                _canFilterClassify(s, all, s.mask0, c);
+                // RXB0 takes class a, or classes a and b (b > a)
+                for (uint8_t a = 0; a < c.count; a++) {
+                    uint8_t lastB = s.filters0 > 1 ? c.count : a + 1;
+                    for (uint8_t b = a; b < lastB; b++) {
+                        if ((c.varying[a] | c.varying[b]) != sub) continue;   // a tighter mask does better
+                        s.used0 = b == a ? 1 : 2;
+                        if (s.used0 * per >= s.bestAccepted) continue;
+                        s.value0[0] = c.value[a];
+                        s.value0[1] = c.value[b];
+                        _canFilterBank1(s, all & ~(c.members[a] | c.members[b]));
+                    }
+                }
+            }
+            sub = (uint16_t)((sub - varying) & varying);
+        } while (sub);
+    }
+
+    plan = s.best;
+    plan.accepted = (uint16_t)s.bestAccepted;
+    plan.unwanted = (uint16_t)(s.bestAccepted - s.count);
+    return nullptr;
+}
+
+/** The MCP2515's filters: two under MASK0, four under MASK1. */
+static inline const char *canFilterPlan(CanFilterPlan &plan, const uint32_t *ids, size_t count) {
+    return canFilterPlanBanks(plan, ids, count, 2, 4);
+}
+
+/**
+ * A canFilterPlanBanks(..., 1, 1) plan as TWAI dual-filter acceptance code
+ * and mask (twai_filter_config_t, single_filter false).  Filter 1 takes
+ * RXF0 under MASK0, filter 2 RXF2 under MASK1.  TWAI masks are inverted –
+ * a set bit is "don't care" – and the RTR bit and data bits are left free.
+ */
+static inline void canFilterTwaiDual(const CanFilterPlan &plan, uint32_t &code, uint32_t &mask) {
+    code = ((uint32_t)plan.filter[0] << 21) | ((uint32_t)plan.filter[2] << 5);
+    mask = ((uint32_t)(~plan.mask[0] & CAN_FILTER_ID_MASK) << 21) | 0x001F0000u
+         | ((uint32_t)(~plan.mask[1] & CAN_FILTER_ID_MASK) << 5)  | 0x0000001Fu;
+}
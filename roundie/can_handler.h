@@ -2,9 +2,12 @@
  * can_handler.h
  * CAN bus message parsing for Haltech CAN V2 protocol.
  *
- * All multi-byte values are little-endian (LSB first).
+ * The signal layout lives in tools/haltech_v2.sig and is compiled into
+ * can_signals.h by tools/dbc2header.py; add channels there, not here.
+ * Every listed message is decoded, but only those carrying a displayed or
+ * logged channel get acceptance filters (CanMessage::wanted).
  *
- * Message layout:
+ * Layout of the displayed channels (all multi-byte values little-endian):
  *   0x3D0 (8 bytes):
  *     Bytes 0-1  uint16 LE  Lambda          raw × 0.001  → Lambda value
  *     Bytes 2-3  int16  LE  Boost Pressure  raw × 0.1    → kPa absolute
@@ -22,60 +25,211 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "can_queue.h"
+#include "can_signals.h"
+#include "seqlock.h"
+#include "trace.h"
+#include "can_health.h"
+#include "can_filter.h"
+#include "sensor_filter.h"
+#include "sensor_stats.h"
+#if DATA_LOG
+#include "data_logger.h"
+#endif
 
-// ── Live sensor data (updated by parseCAN) ───────────────────────────────────
-extern float g_lambda;          // dimensionless lambda (e.g. 1.0)
-extern float g_boostKpa;        // kPa absolute
-extern float g_fuelPressKpa;    // kPa
-extern uint16_t g_rpm;          // RPM
-extern float g_coolantC;        // °C
-extern float g_oilPressKpa;     // kPa
+// ── Live sensor data ──────────────────────────────────────────────────────────
+// The decoder folds frames into g_sensorWork (decoder thread only), each
+// sample filtered and stamped with its frame's reception time, and then
+// publishes the whole record through the g_sensors seqlock.  Every other
+// context – UI, logger, alerts – takes a consistent copy with readSensors(),
+// so boost and lambda on screen always come from the same published state.
+
+/** Versioned snapshot of every decoded channel. */
+struct SensorRecord {
+    uint32_t version;                   // bumped on every publish
+    uint32_t tsUs;                      // micros() stamp of the newest frame folded in
+    float    ch[SENSOR_CHANNEL_COUNT];  // indexed by SensorChannel
+    uint32_t chUs[SENSOR_CHANNEL_COUNT];  // reception time of each channel's sample (0 = none)
+};
+#define SENSOR_RECORD_INIT  { 0, 0, SENSOR_CHANNEL_DEFAULTS, {} }
+
+/**
+ * Set of displayed SensorChannels (CH_x < SENSOR_DISPLAY_COUNT), one bit
+ * each (takeSensorChanges(), ui_runtime.h).
+ */
+typedef uint64_t SensorMask;
+static_assert(SENSOR_DISPLAY_COUNT >= 1 && SENSOR_DISPLAY_COUNT <= 64,
+              "displayed channels must fit a SensorMask");
+
+/** Bit of a displayed SensorChannel in a SensorMask. */
+#define SENSOR_CH_BIT(ch)      ((SensorMask)1 << (ch))
+#define SENSOR_DISPLAY_MASK    (~(SensorMask)0 >> (64 - SENSOR_DISPLAY_COUNT))
+
+extern SensorRecord          g_sensorWork;   // decoder-private working copy
+extern SeqLock<SensorRecord> g_sensors;      // published snapshot
 
 /**
- * Parse a raw CAN frame and update the global sensor variables.
+ * Decode a raw CAN frame into the decoder's working record (not published).
+ *
+ * The id is mapped to its message descriptor with an O(1) table lookup, then
+ * the message's decoder – an instantiation of decodeCanSignals() over its
+ * constexpr descriptors (can_signal.h) – is called.  Unknown ids and short
+ * frames are ignored.
  *
  * @param id    11-bit CAN identifier
  * @param len   number of data bytes (DLC)
- * @param data  pointer to the data bytes (little-endian)
+ * @param data  pointer to the data bytes
+ * @return true if the frame updated any channel
  */
-inline void parseCAN(uint32_t id, uint8_t len, const uint8_t *data) {
-    switch (id) {
-        case CAN_ID_LAMBDA_BOOST_FUELPRES: {
-            if (len < 6) break;
-            // Lambda: bytes 0-1, uint16 LE, scale × 0.001
-            uint16_t rawLambda = (uint16_t)data[0] | ((uint16_t)data[1] << 8);
-            g_lambda = rawLambda * 0.001f;
-
-            // Boost pressure: bytes 2-3, int16 LE, scale × 0.1 → kPa absolute
-            int16_t rawBoost = (int16_t)((uint16_t)data[2] | ((uint16_t)data[3] << 8));
-            g_boostKpa = rawBoost * 0.1f;
-
-            // Fuel pressure: bytes 4-5, int16 LE, scale × 0.1 → kPa
-            int16_t rawFuel = (int16_t)((uint16_t)data[4] | ((uint16_t)data[5] << 8));
-            g_fuelPressKpa = rawFuel * 0.1f;
-            break;
-        }
+inline bool decodeCAN(uint32_t id, uint8_t len, const uint8_t *data) {
+    int m = canMessageIndex(id);
+    if (m < 0) return false;
+    const CanMessage &msg = kCanMessages[m];
+    if (len < msg.minDlc) return false;
+    msg.decode(len, data, g_sensorWork.ch);
+    return true;
+}
 
-        case CAN_ID_RPM: {
-            if (len < 2) break;
-            // RPM: bytes 0-1, uint16 LE, direct value
-            g_rpm = (uint16_t)data[0] | ((uint16_t)data[1] << 8);
-            break;
+/**
+ * Decode a raw CAN frame as decodeCAN() does, then pass each channel it
+ * carries through that channel's SENSOR_FILTERS filter (sensor_filter.h)
+ * and stamp it with tsUs; the filtered value is folded into the session
+ * statistics (sensor_stats.h).  With DATA_LOG, the unfiltered values are
+ * logged first (data_logger.h).  Not published.  Decoder thread only.
+ *
+ * @param tsUs  micros() reception timestamp of the frame
+ * @return true if the frame updated any channel
+ */
+inline bool decodeFilteredCAN(uint32_t id, uint8_t len, const uint8_t *data, uint32_t tsUs) {
+    static const SensorFilterCfg kFilters[] = SENSOR_FILTERS;
+    static_assert(sizeof(kFilters) / sizeof(kFilters[0]) == SENSOR_CHANNEL_COUNT,
+                  "SENSOR_FILTERS needs one entry per channel");
+    static SensorFilterState     state[SENSOR_CHANNEL_COUNT];
+    if (!decodeCAN(id, len, data)) return false;
+
+    const CanMessage &msg = kCanMessages[canMessageIndex(id)];
+#if DATA_LOG
+    dataLogFrame(msg, g_sensorWork.ch, tsUs);
+#endif
+    for (unsigned i = msg.firstSignal; i < (unsigned)msg.firstSignal + msg.signalCount; i++) {
+        uint8_t c = kCanSignals[i].channel;
+        g_sensorWork.ch[c]   = sensorFilterStep(kFilters[c], state[c], g_sensorWork.ch[c], tsUs);
+        g_sensorWork.chUs[c] = tsUs;
+        sensorStatsAdd(c, g_sensorWork.ch[c]);
+    }
+    return true;
+}
+
+/** Displayed channels changed in a publish since the last takeSensorChanges(). */
+inline SensorMask &_sensorChanges(void) {
+    static SensorMask mask = 0;
+    return mask;
+}
+
+/**
+ * Publish the working record, and the statistics with it, to readers.
+ * Decoder thread only.
+ * Displayed channels whose value differs from the previous publish are
+ * added to the mask returned by takeSensorChanges().
+ * @param tsUs  reception timestamp of the newest frame it contains
+ */
+inline void publishSensors(uint32_t tsUs) {
+    static float shown[SENSOR_CHANNEL_COUNT] = SENSOR_CHANNEL_DEFAULTS;
+    SensorMask changed = 0;
+    for (int ch = 0; ch < SENSOR_DISPLAY_COUNT; ch++) {
+        if (g_sensorWork.ch[ch] != shown[ch]) {
+            shown[ch] = g_sensorWork.ch[ch];
+            changed |= SENSOR_CH_BIT(ch);
         }
+    }
+    _sensorChanges() |= changed;
+
+    g_sensorWork.version++;
+    g_sensorWork.tsUs = tsUs;
+    g_sensors.write(g_sensorWork);
+    sensorStatsPublish();
+}
+
+/**
+ * Displayed channels changed by publishes since the previous call, so a consumer can skip work for values that did not move.
+ * Decoder thread only.
+ */
+inline SensorMask takeSensorChanges(void) {
+    SensorMask mask = _sensorChanges();
+    _sensorChanges() = 0;
+    return mask;
+}
 
-        case CAN_ID_COOLANT_OILPRES: {
-            if (len < 4) break;
-            // Coolant temp: bytes 0-1, int16 LE, scale × 0.1 → °C
-            int16_t rawCoolant = (int16_t)((uint16_t)data[0] | ((uint16_t)data[1] << 8));
-            g_coolantC = rawCoolant * 0.1f;
+/** Take a consistent copy of the latest published sensor record.  Any thread. */
+inline SensorRecord readSensors(void) {
+    return g_sensors.read();
+}
 
-            // Oil pressure: bytes 2-3, int16 LE, scale × 0.1 → kPa
-            int16_t rawOil = (int16_t)((uint16_t)data[2] | ((uint16_t)data[3] << 8));
-            g_oilPressKpa = rawOil * 0.1f;
-            break;
+/**
+ * Decode and filter a raw CAN frame and publish the result immediately.
+ *
+ * @param id    11-bit CAN identifier
+ * @param len   number of data bytes (DLC)
+ * @param data  pointer to the data bytes
+ */
+inline void parseCAN(uint32_t id, uint8_t len, const uint8_t *data) {
+    TRACE_SCOPE("parseCAN");
+    uint32_t now = micros();
+    if (decodeFilteredCAN(id, len, data, now)) publishSensors(now);
+}
+
+/**
+ * Drain queued frames through the decoder in batches of CAN_DRAIN_BATCH,
+ * publishing one sensor record per batch.  Each frame is counted by ID,
+ * with its time in the queue, for can_health.h.  Consumer side of the RX queue and
+ * sole writer of g_sensors – call from a single thread only.
+ *
+ * @param q          RX queue filled by the CAN receive context
+ * @param maxFrames  upper bound on frames parsed by this call (defaults to one
+ *                   full queue, so a flooded bus cannot starve the caller;
+ *                   the CAN task passes canDrainBudget())
+ * @return number of frames parsed
+ */
+template <size_t N>
+inline size_t drainCANQueue(CanFrameQueue<N> &q, size_t maxFrames = N) {
+    TRACE_SCOPE("drainCANQueue");
+    CanRxFrame batch[CAN_DRAIN_BATCH];
+    size_t total = 0;
+    while (total < maxFrames) {
+        size_t want = maxFrames - total;
+        if (want > CAN_DRAIN_BATCH) want = CAN_DRAIN_BATCH;
+        size_t n = q.popBatch(batch, want);
+        if (n == 0) break;
+        bool changed = false;
+        uint32_t now = micros();
+        for (size_t i = 0; i < n; i++) {
+            const struct can_frame &f = batch[i].frame;
+            canHealthFrame(f.can_id, now - batch[i].tsUs);
+            changed |= decodeFilteredCAN(f.can_id, f.can_dlc, f.data, batch[i].tsUs);
         }
+        if (changed) publishSensors(batch[n - 1].tsUs);
+        total += n;
+    }
+    return total;
+}
 
-        default:
-            break;
+/**
+ * Acceptance filters for the wanted messages – those carrying a displayed
+ * or logged channel (can_filter.h) – so the controller drops every other
+ * frame before it costs an SPI read, with filters0 / filters1 filters under
+ * the two masks.
+ * @return nullptr, or why no plan was made (then accept every frame)
+ */
+inline const char *canDecoderFilterPlanBanks(CanFilterPlan &plan, uint8_t filters0, uint8_t filters1) {
+    uint32_t ids[CAN_MESSAGE_COUNT];
+    size_t   n = 0;
+    for (size_t i = 0; i < CAN_MESSAGE_COUNT; i++) {
+        if (kCanMessages[i].wanted) ids[n++] = kCanMessages[i].id;
     }
+    return canFilterPlanBanks(plan, ids, n, filters0, filters1);
+}
+
+/** The decoder's filters for the MCP2515 (two under MASK0, four under MASK1). */
+inline const char *canDecoderFilterPlan(CanFilterPlan &plan) {
+    return canDecoderFilterPlanBanks(plan, 2, 4);
 }
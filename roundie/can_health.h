@@ -0,0 +1,260 @@
+/**
+ * can_health.h
+ * CAN bus health accounting and the adaptive decode budget of the CAN task.
+ *
+ * Counted by the CAN task (the decoding thread), read by whoever reports:
+ *
+ *   per ID       frames decoded, as frames/s per report window; the first
+ *                CAN_HEALTH_MAX_IDS IDs seen get their own counter, the rest
+ *                are summed as "other"
+ *   controller   MCP2515 error flags (EFLG) polled every CAN_HEALTH_POLL_MS
+ *                (the TWAI backend maps its status onto the same bits):
+ *                receive buffer overflows (RX0OVR/RX1OVR – sticky, so one
+ *                count per poll that found the flag, not per frame lost),
+ *                entries into error-passive (RXEP/TXEP) and bus-off (TXBO),
+ *                and the receive/transmit error counters
+ *   latency      INT edge to the frame being read off the chip, and read to
+ *                decode (time spent in the RX queue), as histograms
+ *
+ * The decode budget: drainCANQueue() runs on the same task that empties the
+ * controller, whose CAN_HW_RX_BUFFERS buffers (the MCP2515's two, or the
+ * TWAI driver's queue) fill in CAN_HW_RX_BUFFERS / rate.
+ * Decoding a long backlog in one go would let them overflow, so each pass
+ * decodes at most the frames that fit CAN_DRAIN_DUTY of that time, at the
+ * measured cost per frame – the whole queue on a quiet bus, a few batches
+ * at full load – and goes back to the chip before decoding the rest.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+
+// MCP2515 EFLG bits
+#define CAN_EFLG_RX1OVR  0x80
+#define CAN_EFLG_RX0OVR  0x40
+#define CAN_EFLG_TXBO    0x20
+#define CAN_EFLG_TXEP    0x10
+#define CAN_EFLG_RXEP    0x08
+
+/** Latency histogram: CAN_LATENCY_BINS bins of CAN_LATENCY_BIN_US. */
+struct CanLatencyHist {
+    std::atomic<uint32_t> bins[CAN_LATENCY_BINS];
+    std::atomic<uint32_t> maxUs{0};
+};
+
+/**
+ * Accumulated since the last canHealthReport().  Written by the CAN task,
+ * read and reset by whoever reports, hence atomic.
+ */
+struct CanHealth {
+    std::atomic<uint32_t> ids[CAN_HEALTH_MAX_IDS];       // CAN ID + 1, 0 = free
+    std::atomic<uint32_t> frames[CAN_HEALTH_MAX_IDS];
+    std::atomic<uint32_t> otherFrames{0};
+    std::atomic<uint32_t> rx0Overflows{0};
+    std::atomic<uint32_t> rx1Overflows{0};
+    std::atomic<uint32_t> errorPassive{0};               // entries into error-passive
+    std::atomic<uint32_t> busOff{0};                     // entries into bus-off
+    std::atomic<uint8_t>  eflg{0};                       // latest EFLG
+    std::atomic<uint8_t>  rec{0}, tec{0};                // latest error counters
+    std::atomic<uint32_t> budget{CAN_RX_QUEUE_LEN};      // current decode budget
+    CanLatencyHist        irqLatency;                    // INT → read
+    CanLatencyHist        queueLatency;                  // read → decode
+    uint32_t              lastQueueDropped = 0;          // reporter side
+};
+
+static CanHealth s_canHealth;
+
+static inline void _canHistAdd(CanLatencyHist &h, uint32_t us) {
+    uint32_t bin = us / CAN_LATENCY_BIN_US;
+    if (bin >= CAN_LATENCY_BINS) bin = CAN_LATENCY_BINS - 1;
+    h.bins[bin].fetch_add(1, std::memory_order_relaxed);
+    if (us > h.maxUs.load(std::memory_order_relaxed)) h.maxUs.store(us, std::memory_order_relaxed);
+}
+
+// ── CAN task side ─────────────────────────────────────────────────────────────
+
+/** A frame was decoded queueUs after it was read off the controller. */
+static inline void canHealthFrame(uint32_t id, uint32_t queueUs) {
+    CanHealth &h = s_canHealth;
+    _canHistAdd(h.queueLatency, queueUs);
+    for (int i = 0; i < CAN_HEALTH_MAX_IDS; i++) {
+        uint32_t slot = h.ids[i].load(std::memory_order_relaxed);
+        if (slot == id + 1) {
+            h.frames[i].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (slot == 0) {                      // first frame with this ID
+            h.frames[i].fetch_add(1, std::memory_order_relaxed);
+            h.ids[i].store(id + 1, std::memory_order_release);
+            return;
+        }
+    }
+    h.otherFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+/** The first frame after an INT edge was read us after the edge. */
+static inline void canHealthIrqLatency(uint32_t us) {
+    _canHistAdd(s_canHealth.irqLatency, us);
+}
+
+/** Latest controller error state: EFLG and the RX/TX error counters. */
+static inline void canHealthController(uint8_t eflg, uint8_t rec, uint8_t tec) {
+    CanHealth &h = s_canHealth;
+    uint8_t prev = h.eflg.load(std::memory_order_relaxed);
+    if (eflg & CAN_EFLG_RX0OVR) h.rx0Overflows.fetch_add(1, std::memory_order_relaxed);
+    if (eflg & CAN_EFLG_RX1OVR) h.rx1Overflows.fetch_add(1, std::memory_order_relaxed);
+    const uint8_t passive = CAN_EFLG_RXEP | CAN_EFLG_TXEP;
+    if ((eflg & passive) && !(prev & passive)) h.errorPassive.fetch_add(1, std::memory_order_relaxed);
+    if ((eflg & CAN_EFLG_TXBO) && !(prev & CAN_EFLG_TXBO)) h.busOff.fetch_add(1, std::memory_order_relaxed);
+    h.eflg.store(eflg, std::memory_order_relaxed);
+    h.rec.store(rec, std::memory_order_relaxed);
+    h.tec.store(tec, std::memory_order_relaxed);
+}
+
+// ── Decode budget ─────────────────────────────────────────────────────────────
+
+struct CanDrainBudget {
+    uint32_t lastPushed = 0;      // queue pushes at the previous pass
+    uint32_t lastUs     = 0;
+    float    ratePerUs  = 0.0f;   // arrivals, exponentially averaged
+    float    costUs     = 0.0f;   // decode time per frame, exponentially averaged
+};
+
+/**
+ * Frames the coming drainCANQueue() may decode, from the arrivals since the
+ * previous call (pushed = the queue's pushed() count).
+ */
+static inline uint32_t canDrainBudget(CanDrainBudget &b, uint32_t pushed, uint32_t nowUs,
+                                      uint32_t maxFrames) {
+    uint32_t arrived = pushed - b.lastPushed;
+    uint32_t dt      = nowUs - b.lastUs;
+    b.lastPushed = pushed;
+    b.lastUs     = nowUs;
+    if (dt) b.ratePerUs += ((float)arrived / dt - b.ratePerUs) * 0.125f;
+
+    uint32_t budget = maxFrames;
+    if (b.ratePerUs > 0.0f && b.costUs > 0.0f) {
+        float fillUs = CAN_HW_RX_BUFFERS / b.ratePerUs;
+        float frames = fillUs * CAN_DRAIN_DUTY / b.costUs;
+        if (frames < (float)maxFrames) budget = (uint32_t)frames;
+    }
+    if (budget < CAN_DRAIN_BATCH) budget = CAN_DRAIN_BATCH;
+    s_canHealth.budget.store(budget, std::memory_order_relaxed);
+    return budget;
+}
+
+/** drainCANQueue() decoded frames in us. */
+static inline void canDrainCost(CanDrainBudget &b, size_t frames, uint32_t us) {
+    if (!frames) return;
+    float per = (float)us / frames;
+    b.costUs = b.costUs > 0.0f ? b.costUs + (per - b.costUs) * 0.125f : per;
+}
+
+// ── Reporting ─────────────────────────────────────────────────────────────────
+
+struct CanLatencyReport {
+    uint32_t count;
+    uint32_t p50Us, p99Us;        // upper edge of the percentile's bin
+    uint32_t maxUs;
+};
+
+struct CanHealthReport {
+    uint8_t          ids;
+    uint32_t         id[CAN_HEALTH_MAX_IDS];
+    uint32_t         perSec[CAN_HEALTH_MAX_IDS];
+    uint32_t         otherPerSec;
+    uint32_t         rx0Overflows, rx1Overflows;
+    uint32_t         queueDropped;
+    uint32_t         errorPassive, busOff;
+    uint8_t          eflg, rec, tec;
+    uint32_t         budget;
+    CanLatencyReport irq, queue;
+};
+
+static inline CanLatencyReport _canHistReport(CanLatencyHist &h) {
+    CanLatencyReport r = {};
+    uint32_t counts[CAN_LATENCY_BINS];
+    for (int i = 0; i < CAN_LATENCY_BINS; i++) {
+        counts[i] = h.bins[i].exchange(0, std::memory_order_relaxed);
+        r.count += counts[i];
+    }
+    r.maxUs = h.maxUs.exchange(0, std::memory_order_relaxed);
+    const uint32_t want50 = (r.count * 50 + 99) / 100, want99 = (r.count * 99 + 99) / 100;
+    uint32_t seen = 0;
+    for (int i = 0; i < CAN_LATENCY_BINS && r.count; i++) {
+        seen += counts[i];
+        uint32_t edge = (uint32_t)(i + 1) * CAN_LATENCY_BIN_US;
+        if (edge > r.maxUs) edge = r.maxUs;
+        if (!r.p50Us && seen >= want50) r.p50Us = edge;
+        if (!r.p99Us && seen >= want99) { r.p99Us = edge; break; }
+    }
+    return r;
+}
+
+/**
+ * Summarise and reset the window of periodMs.
+ * @param queueDropped  the RX queue's dropped() count (frames lost in software)
+ */
+static inline CanHealthReport canHealthReport(uint32_t periodMs, uint32_t queueDropped) {
+    CanHealth &h = s_canHealth;
+    CanHealthReport r = {};
+    uint32_t div = periodMs ? periodMs : 1;
+    for (int i = 0; i < CAN_HEALTH_MAX_IDS; i++) {
+        uint32_t slot = h.ids[i].load(std::memory_order_acquire);
+        if (!slot) break;
+        r.id[r.ids]       = slot - 1;
+        r.perSec[r.ids++] = (uint32_t)((uint64_t)h.frames[i].exchange(0) * 1000u / div);
+    }
+    r.otherPerSec  = (uint32_t)((uint64_t)h.otherFrames.exchange(0) * 1000u / div);
+    r.rx0Overflows = h.rx0Overflows.exchange(0);
+    r.rx1Overflows = h.rx1Overflows.exchange(0);
+    r.queueDropped = queueDropped - h.lastQueueDropped;
+    h.lastQueueDropped = queueDropped;
+    r.errorPassive = h.errorPassive.exchange(0);
+    r.busOff       = h.busOff.exchange(0);
+    r.eflg         = h.eflg.load();
+    r.rec          = h.rec.load();
+    r.tec          = h.tec.load();
+    r.budget       = h.budget.load();
+    r.irq          = _canHistReport(h.irqLatency);
+    r.queue        = _canHistReport(h.queueLatency);
+    return r;
+}
+
+/**
+ * The report as one line, e.g. "0x3D0 50/s 0x3D1 50/s other 0/s | overflow
+ * rx0 0 rx1 0 queue 0 | error-passive 0 bus-off 0 rec 0 tec 0 eflg 00 |
+ * int→read p50<25 p99<50 max 31 us | queue p50<25 p99<75 max 60 us |
+ * budget 256", into buf.
+ * @return buf
+ */
+static inline char *canHealthFormat(const CanHealthReport &r, char *buf, size_t size) {
+    size_t n = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < r.ids && n < size; i++) {
+        int w = snprintf(buf + n, size - n, "0x%03lX %lu/s ", (unsigned long)r.id[i],
+                         (unsigned long)r.perSec[i]);
+        if (w < 0) return buf;
+        n += (size_t)w;
+    }
+    if (n < size) {
+        snprintf(buf + n, size - n,
+                 "other %lu/s | overflow rx0 %lu rx1 %lu queue %lu | "
+                 "error-passive %lu bus-off %lu rec %u tec %u eflg %02X | "
+                 "int→read p50<%lu p99<%lu max %lu us | queue p50<%lu p99<%lu max %lu us | "
+                 "budget %lu",
+                 (unsigned long)r.otherPerSec, (unsigned long)r.rx0Overflows,
+                 (unsigned long)r.rx1Overflows, (unsigned long)r.queueDropped,
+                 (unsigned long)r.errorPassive, (unsigned long)r.busOff,
+                 (unsigned)r.rec, (unsigned)r.tec, (unsigned)r.eflg,
+                 (unsigned long)r.irq.p50Us, (unsigned long)r.irq.p99Us,
+                 (unsigned long)r.irq.maxUs, (unsigned long)r.queue.p50Us,
+                 (unsigned long)r.queue.p99Us, (unsigned long)r.queue.maxUs,
+                 (unsigned long)r.budget);
+    }
+    return buf;
+}
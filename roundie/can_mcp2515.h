@@ -0,0 +1,145 @@
+/**
+ * can_mcp2515.h
+ * CAN backend for the external MCP2515 on SPI (CAN_BACKEND_MCP2515, see
+ * can_backend.h).
+ *
+ * The driver library configures the chip – bitrate, the decoder's
+ * acceptance filters (can_filter.h), normal mode – and polls its error
+ * flags; frames are read with the burst path in mcp2515_rx.h.  With
+ * CAN_INT_PIN wired, the INT edge wakes the CAN task; without it the task
+ * polls every tick.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <mcp2515.h>
+#include <atomic>
+#include "config.h"
+#include "can_handler.h"
+#include "can_health.h"
+#include "mcp2515_rx.h"
+#include "task_signal.h"
+
+class CanMcp2515Backend {
+public:
+    const char *name(void) const { return "mcp2515"; }
+
+    /** Bitrate, acceptance filters, normal mode, INT armed – on the CAN task. */
+    void begin(void) {
+        m_signal.bindCurrentTask();
+        SPI.begin(CAN_SPI_SCK, CAN_SPI_MISO, CAN_SPI_MOSI, CAN_SPI_CS);
+        m_chip.reset();
+        if (m_chip.setBitrate(CAN_SPEED, MCP_8MHZ) == MCP2515::ERROR_OK) {
+            Serial.println("[CAN] Bitrate set");
+        } else {
+            Serial.println("[CAN] WARNING: setBitrate failed – check MCP2515 crystal");
+        }
+
+        // Accept only the ids the decoder handles; the masks and filters are
+        // planned from its message table (can_filter.h)
+        CanFilterPlan plan;
+        if (const char *err = canDecoderFilterPlan(plan)) {
+            Serial.printf("[CAN] WARNING: no filter plan (%s) – accepting every frame\n", err);
+            plan.mask[0] = plan.mask[1] = 0;
+            memset(plan.filter, 0, sizeof(plan.filter));
+        } else {
+            Serial.printf("[CAN] Filters admit %u ids, %u unwanted\n",
+                          (unsigned)plan.accepted, (unsigned)plan.unwanted);
+        }
+        static const MCP2515::RXF kFilters[6] = {
+            MCP2515::RXF0, MCP2515::RXF1, MCP2515::RXF2,
+            MCP2515::RXF3, MCP2515::RXF4, MCP2515::RXF5,
+        };
+        m_chip.setFilterMask(MCP2515::MASK0, false, plan.mask[0]);
+        m_chip.setFilterMask(MCP2515::MASK1, false, plan.mask[1]);
+        for (int f = 0; f < 6; f++) m_chip.setFilter(kFilters[f], false, plan.filter[f]);
+
+        m_chip.setNormalMode();
+        Serial.println("[CAN] MCP2515 ready");
+
+#if CAN_INT_PIN >= 0
+        // Attached here so the ISR runs on the CAN core, next to its task
+        pinMode(CAN_INT_PIN, INPUT);
+        attachInterruptArg(digitalPinToInterrupt(CAN_INT_PIN), _isr, this, FALLING);
+        Serial.println("[CAN] Interrupt-driven RX enabled");
+#endif
+    }
+
+    /**
+     * Until INT fires or timeoutMs passes; 0 returns at once.  The timeout
+     * also re-arms RX if a falling edge was missed while INT was held low.
+     */
+    void wait(uint32_t timeoutMs) {
+#if CAN_INT_PIN >= 0
+        m_signal.wait(timeoutMs);
+#else
+        if (timeoutMs) vTaskDelay(1);
+#endif
+    }
+
+    uint32_t takeIrqUs(void) { return m_irqUs.exchange(0, std::memory_order_relaxed); }
+
+    /** RX STATUS, then one burst per full buffer (mcp2515_rx.h). */
+    uint8_t read(struct can_frame out[2]) {
+        uint8_t n = mcp2515ReadFrames(m_rx, out);
+#if CAN_INT_PIN >= 0
+        // Both buffers empty yet INT still low: an error flag holds it
+        if (n == 0 && digitalRead(CAN_INT_PIN) == LOW) m_errorPending = true;
+#endif
+        return n;
+    }
+
+    /**
+     * Every CAN_HEALTH_POLL_MS, or as soon as an error flag holds INT low:
+     * the error flags and counters into can_health.h, clearing the (sticky)
+     * RX overflow flags once counted.  ERRIF (set on every EFLG change) and
+     * MERRF are cleared too – the library enables both in CANINTE, and while
+     * either is set INT stays low and no frame makes a falling edge.
+     */
+    void pollErrors(void) {
+        uint32_t now = millis();
+        if (now - m_lastPollMs < CAN_HEALTH_POLL_MS && !m_errorPending) return;
+        m_lastPollMs   = now;
+        m_errorPending = false;
+        uint8_t eflg = m_chip.getErrorFlags();
+        if (eflg & (CAN_EFLG_RX0OVR | CAN_EFLG_RX1OVR)) m_chip.clearRXnOVRFlags();
+        uint8_t intf = m_chip.getInterrupts();
+        if (intf & MCP2515::CANINTF_ERRIF) m_chip.clearERRIF();
+        if (intf & MCP2515::CANINTF_MERRF) m_chip.clearMERR();
+        canHealthController(eflg, m_chip.errorCountRX(), m_chip.errorCountTX());
+    }
+
+    /** SPI transactions, bytes and time per frame (mcp2515RxFormat()). */
+    char *format(char *buf, size_t size) {
+        return mcp2515RxFormat(mcp2515RxReport(m_rx), buf, size);
+    }
+
+private:
+    MCP2515               m_chip{CAN_SPI_CS, CAN_SPI_CLOCK};
+    Mcp2515Rx             m_rx = { _spi, nullptr, {} };
+    TaskSignal            m_signal;
+    // micros() of the first INT edge not yet serviced, low bit set so 0 means none
+    std::atomic<uint32_t> m_irqUs{0};
+    uint32_t              m_lastPollMs = 0;
+    bool                  m_errorPending = false;
+
+    static void IRAM_ATTR _isr(void *arg) {
+        CanMcp2515Backend *self = (CanMcp2515Backend *)arg;
+        if (!self->m_irqUs.load(std::memory_order_relaxed)) {
+            self->m_irqUs.store(micros() | 1, std::memory_order_relaxed);
+        }
+        self->m_signal.postFromIsr(1);
+    }
+
+    /** One transaction for mcp2515_rx.h: the whole buffer in one transferBytes(). */
+    static void _spi(const uint8_t *tx, uint8_t *rx, size_t n, void *ctx) {
+        (void)ctx;
+        SPI.beginTransaction(SPISettings(CAN_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+        digitalWrite(CAN_SPI_CS, LOW);
+        SPI.transferBytes(tx, rx, n);
+        digitalWrite(CAN_SPI_CS, HIGH);
+        SPI.endTransaction();
+    }
+};
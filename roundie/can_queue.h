@@ -0,0 +1,113 @@
+/**
+ * can_queue.h
+ * Bounded lock-free single-producer / single-consumer ring of received CAN
+ * frames.
+ *
+ * The producer is the CAN RX context (the RX task woken by the MCP2515 INT
+ * line); the consumer is whoever calls parseCAN().  Exactly one thread may
+ * push and exactly one thread may pop – no locks, no critical sections.
+ *
+ * Each entry carries the micros() timestamp taken when the frame was pulled
+ * off the controller, so the decoder can tell how long it sat in the queue.
+ *
+ * When the ring is full the newest frame is dropped (the older frames are
+ * already in flight) and the drop counter is bumped.  The high-water mark
+ * records the deepest fill level ever seen, which is the number to size
+ * CAN_RX_QUEUE_LEN against.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <can.h>
+#include <atomic>
+#include <stddef.h>
+
+/** One received frame plus its reception timestamp. */
+struct CanRxFrame {
+    uint32_t         tsUs;    // micros() when the frame was read from the controller
+    struct can_frame frame;
+};
+
+/**
+ * SPSC ring of CanRxFrame.
+ * @tparam N  capacity in frames; must be a power of two
+ */
+template <size_t N>
+class CanFrameQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "CanFrameQueue size must be a power of two");
+
+public:
+    // ── Producer side ──────────────────────────────────────────────────────
+
+    /**
+     * Append a frame.  Producer only.
+     * @return false if the ring was full and the frame was dropped
+     */
+    bool push(const CanRxFrame &f) {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        uint32_t tail = m_tail.load(std::memory_order_acquire);
+        uint32_t used = head - tail;
+        if (used >= N) {
+            m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+            return false;
+        }
+        m_buf[head & (N - 1)] = f;
+        m_head.store(head + 1, std::memory_order_release);
+
+        m_pushed.store(m_pushed.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+        if (used + 1 > m_highWater.load(std::memory_order_relaxed)) {
+            m_highWater.store(used + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // ── Consumer side ──────────────────────────────────────────────────────
+
+    /**
+     * Remove up to maxFrames frames in FIFO order.  Consumer only.
+     * @return number of frames copied into out
+     */
+    size_t popBatch(CanRxFrame *out, size_t maxFrames) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        size_t n = head - tail;
+        if (n > maxFrames) n = maxFrames;
+        for (size_t i = 0; i < n; i++) {
+            out[i] = m_buf[(tail + i) & (N - 1)];
+        }
+        m_tail.store(tail + (uint32_t)n, std::memory_order_release);
+        return n;
+    }
+
+    /** Remove a single frame.  Consumer only. */
+    bool pop(CanRxFrame &out) { return popBatch(&out, 1) == 1; }
+
+    // ── Statistics (safe to read from any thread) ──────────────────────────
+
+    /** Frames currently queued (approximate when read from a third thread). */
+    size_t   size()      const { return m_head.load(std::memory_order_acquire) -
+                                        m_tail.load(std::memory_order_acquire); }
+    static constexpr size_t capacity() { return N; }
+    /** Deepest fill level observed since boot. */
+    uint32_t highWater() const { return m_highWater.load(std::memory_order_relaxed); }
+    /** Frames discarded because the ring was full. */
+    uint32_t dropped()   const { return m_dropped.load(std::memory_order_relaxed); }
+    /** Frames successfully queued. */
+    uint32_t pushed()    const { return m_pushed.load(std::memory_order_relaxed); }
+
+private:
+    CanRxFrame m_buf[N];
+
+    // Producer- and consumer-owned indices live on separate cache lines so the
+    // two cores do not ping-pong a shared line on every frame.
+    alignas(64) std::atomic<uint32_t> m_head{0};   // written by producer only
+    alignas(64) std::atomic<uint32_t> m_tail{0};   // written by consumer only
+
+    // Counters are written by the producer only.
+    alignas(64) std::atomic<uint32_t> m_highWater{0};
+    std::atomic<uint32_t> m_dropped{0};
+    std::atomic<uint32_t> m_pushed{0};
+};
@@ -0,0 +1,116 @@
+/**
+ * can_signal.h
+ * Table-driven CAN signal decoding.
+ *
+ * Signals are described by constexpr CanSignal descriptors (generated into
+ * can_signals.h by tools/dbc2header.py).  Every descriptor is decoded by the
+ * same code: the 8 payload bytes are loaded once as a
+ * little-endian 64-bit word (one memcpy) plus its byte-swapped big-endian
+ * twin, and each signal is
+ *
+ *     raw   = (word[bigEndian] >> shift) & mask
+ *     value = sign_extend(raw) × scale + offset
+ *
+ * Sign extension is done arithmetically ((raw ^ signMask) - signMask, with
+ * signMask = 0 for unsigned signals), so there is no branching on signal
+ * type, width or byte order inside the loop.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "can_signal.h loads payloads with memcpy and assumes a little-endian CPU"
+#endif
+
+static inline uint64_t _canBswap64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(v);
+#else
+    v = ((v & 0x00FF00FF00FF00FFull) << 8)  | ((v >> 8)  & 0x00FF00FF00FF00FFull);
+    v = ((v & 0x0000FFFF0000FFFFull) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFull);
+    return (v << 32) | (v >> 32);
+#endif
+}
+
+/** One signal inside a CAN message. */
+struct CanSignal {
+    uint32_t id;          // owning CAN identifier
+    uint8_t  startBit;    // DBC start bit (LSB for Intel, MSB for Motorola)
+    uint8_t  length;      // width in bits, 1-32
+    uint8_t  isSigned;    // two's complement
+    uint8_t  bigEndian;   // Motorola byte order
+    float    scale;       // physical = raw × scale + offset
+    float    offset;
+    uint8_t  channel;     // SensorChannel written by this signal
+
+    // Derived by canSignal() at compile time
+    uint8_t  shift;       // right shift within the selected 64-bit payload word
+    uint32_t mask;        // (1 << length) - 1
+    uint32_t signMask;    // 1 << (length - 1) for signed signals, else 0
+};
+
+/** Decoder for one message: payload bytes → channel array. */
+typedef void (*CanDecodeFn)(uint8_t len, const uint8_t *data, float *out);
+
+/** One decoded CAN message: a contiguous run of signals in the signal table. */
+struct CanMessage {
+    uint32_t    id;
+    uint8_t     minDlc;       // bytes needed to cover every signal
+    uint8_t     firstSignal;  // index of the first signal in the signal table
+    uint8_t     signalCount;
+    uint8_t     wanted;       // carries a displayed or logged channel: gets a filter
+    CanDecodeFn decode;       // decodeCanSignals<table, firstSignal, signalCount>
+};
+
+/**
+ * Build a CanSignal descriptor, deriving the shift/mask fields.
+ *
+ * Intel signals are addressed in the little-endian payload word, where the
+ * DBC start bit is already the LSB position.  Motorola signals are addressed
+ * in the big-endian word (data[0] in the top byte); DBC bit b then lives at
+ * (7 - b/8)*8 + b%8 and the signal's LSB sits (length - 1) below its MSB.
+ */
+constexpr CanSignal canSignal(uint32_t id, uint8_t startBit, uint8_t length,
+                              bool isSigned, bool bigEndian,
+                              float scale, float offset, uint8_t channel) {
+    return CanSignal{
+        id, startBit, length, (uint8_t)isSigned, (uint8_t)bigEndian,
+        scale, offset, channel,
+        (uint8_t)(bigEndian ? (7 - startBit / 8) * 8 + startBit % 8 - (length - 1)
+                            : startBit),
+        length >= 32 ? 0xFFFFFFFFu : (1u << length) - 1u,
+        isSigned ? 1u << (length - 1) : 0u
+    };
+}
+
+/**
+ * Decode a run of signals into the channel array.
+ *
+ * Instantiated once per message with the constexpr signal table as a
+ * template argument, so the compiler sees every shift, mask and scale as a
+ * constant and unrolls the loop into straight-line extract/scale code.
+ *
+ * @tparam Signals  constexpr signal table
+ * @tparam First    index of the message's first signal
+ * @tparam Count    number of signals in the message
+ * @param len       number of valid payload bytes (caller has checked minDlc)
+ * @param data      payload bytes
+ * @param out       channel values, indexed by CanSignal::channel
+ */
+template <const CanSignal *Signals, unsigned First, unsigned Count>
+inline void decodeCanSignals(uint8_t len, const uint8_t *data, float *out) {
+    uint64_t words[2] = { 0, 0 };   // [0] little-endian, [1] big-endian
+    if (len >= 8) memcpy(&words[0], data, 8);   // common case: fixed-size load
+    else          memcpy(&words[0], data, len);
+    words[1] = _canBswap64(words[0]);
+
+    for (unsigned i = First; i < First + Count; i++) {
+        const CanSignal &s = Signals[i];
+        uint32_t raw = (uint32_t)(words[s.bigEndian] >> s.shift) & s.mask;
+        int32_t  v   = (int32_t)((raw ^ s.signMask) - s.signMask);
+        out[s.channel] = (float)v * s.scale + s.offset;
+    }
+}
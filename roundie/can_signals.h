@@ -0,0 +1,497 @@
+/**
+ * can_signals.h
+ * GENERATED by tools/dbc2header.py from tools/haltech_v2.sig – do not edit.
+ *
+ * Signal table:
+ *   0x360  TPS_PCT               log  bits 39+16 s be  × 0.1 + 0  pct
+ *   0x360  COOLANT_PRESS_KPA          bits 55+16 u be  × 0.1 + -101.3  kPa
+ *   0x361  ENGINE_DEMAND_PCT          bits 39+16 u be  × 0.1 + 0  pct
+ *   0x361  WASTEGATE_KPA              bits 55+16 u be  × 0.1 + -101.3  kPa
+ *   0x362  INJ1_DUTY_PCT              bits  7+16 u be  × 0.1 + 0  pct
+ *   0x362  INJ2_DUTY_PCT              bits 23+16 u be  × 0.1 + 0  pct
+ *   0x362  IGN_LEAD_DEG          log  bits 39+16 s be  × 0.1 + 0  deg
+ *   0x362  IGN_TRAIL_DEG              bits 55+16 s be  × 0.1 + 0  deg
+ *   0x363  WHEEL_SLIP_KMH             bits  7+16 s be  × 0.1 + 0  kmh
+ *   0x363  WHEEL_DIFF_KMH             bits 23+16 s be  × 0.1 + 0  kmh
+ *   0x363  LAUNCH_END_RPM             bits 55+16 s be  × 1 + 0  rpm
+ *   0x364  INJ1_TIME_MS               bits  7+16 u be  × 0.001 + 0  ms
+ *   0x364  INJ2_TIME_MS               bits 23+16 u be  × 0.001 + 0  ms
+ *   0x364  INJ3_TIME_MS               bits 39+16 u be  × 0.001 + 0  ms
+ *   0x364  INJ4_TIME_MS               bits 55+16 u be  × 0.001 + 0  ms
+ *   0x368  LAMBDA_2                   bits 23+16 u be  × 0.001 + 0  lambda
+ *   0x368  LAMBDA_3                   bits 39+16 u be  × 0.001 + 0  lambda
+ *   0x368  LAMBDA_4                   bits 55+16 u be  × 0.001 + 0  lambda
+ *   0x369  TRIGGER_ERRORS             bits  7+16 u be  × 1 + 0
+ *   0x369  TRIGGER_COUNT              bits 23+16 u be  × 1 + 0
+ *   0x369  TRIGGER_SYNC               bits 55+16 u be  × 1 + 0
+ *   0x36A  KNOCK_1_DB            log  bits  7+16 u be  × 0.01 + 0  dB
+ *   0x36A  KNOCK_2_DB                 bits 23+16 u be  × 0.01 + 0  dB
+ *   0x36A  KNOCK_3_DB                 bits 39+16 u be  × 0.01 + 0  dB
+ *   0x36A  KNOCK_4_DB                 bits 55+16 u be  × 0.01 + 0  dB
+ *   0x36B  BRAKE_PRESS_KPA            bits  7+16 u be  × 1 + 0  kPa
+ *   0x36B  NOS_PRESS_KPA              bits 23+16 u be  × 0.22 + -101.3  kPa
+ *   0x36B  TURBO_RPM                  bits 39+16 u be  × 10 + 0  rpm
+ *   0x36B  LATERAL_G                  bits 55+16 s be  × 0.1 + 0  m/s2
+ *   0x36C  WHEEL_FL_KMH               bits  7+16 u be  × 0.1 + 0  kmh
+ *   0x36C  WHEEL_FR_KMH               bits 23+16 u be  × 0.1 + 0  kmh
+ *   0x36C  WHEEL_RL_KMH               bits 39+16 u be  × 0.1 + 0  kmh
+ *   0x36C  WHEEL_RR_KMH               bits 55+16 u be  × 0.1 + 0  kmh
+ *   0x36D  EXH_CAM_1_DEG              bits 39+16 s be  × 0.1 + 0  deg
+ *   0x36D  EXH_CAM_2_DEG              bits 55+16 s be  × 0.1 + 0  deg
+ *   0x36E  ENGINE_LIMITING            bits  7+16 u be  × 1 + 0
+ *   0x36E  LAUNCH_RETARD_DEG          bits 23+16 s be  × 0.1 + 0  deg
+ *   0x36E  LAUNCH_ENRICH_PCT          bits 39+16 s be  × 0.1 + 0  pct
+ *   0x36E  LONG_G                     bits 55+16 s be  × 0.1 + 0  m/s2
+ *   0x36F  GP_OUT1_DUTY_PCT           bits  7+16 u be  × 0.1 + 0  pct
+ *   0x36F  BOOST_DUTY_PCT             bits 23+16 u be  × 0.1 + 0  pct
+ *   0x370  SPEED_KMH             log  bits  7+16 u be  × 0.1 + 0  kmh
+ *   0x370  INT_CAM_1_DEG              bits 39+16 s be  × 0.1 + 0  deg
+ *   0x370  INT_CAM_2_DEG              bits 55+16 s be  × 0.1 + 0  deg
+ *   0x371  FUEL_FLOW_CCM              bits  7+16 u be  × 1 + 0  cc/min
+ *   0x371  FUEL_RETURN_CCM            bits 23+16 u be  × 1 + 0  cc/min
+ *   0x371  FUEL_NET_CCM               bits 39+16 s be  × 1 + 0  cc/min
+ *   0x372  BATTERY_V             log  bits  7+16 u be  × 0.1 + 0  V
+ *   0x372  TARGET_BOOST_KPA           bits 39+16 u be  × 0.1 + 0  kPa_abs
+ *   0x372  BARO_KPA                   bits 55+16 u be  × 0.1 + 0  kPa_abs
+ *   0x373  EGT_1_C                    bits  7+16 u be  × 0.1 + -273.15  degC
+ *   0x373  EGT_2_C                    bits 23+16 u be  × 0.1 + -273.15  degC
+ *   0x373  EGT_3_C                    bits 39+16 u be  × 0.1 + -273.15  degC
+ *   0x373  EGT_4_C                    bits 55+16 u be  × 0.1 + -273.15  degC
+ *   0x374  EGT_5_C                    bits  7+16 u be  × 0.1 + -273.15  degC
+ *   0x374  EGT_6_C                    bits 23+16 u be  × 0.1 + -273.15  degC
+ *   0x374  EGT_7_C                    bits 39+16 u be  × 0.1 + -273.15  degC
+ *   0x374  EGT_8_C                    bits 55+16 u be  × 0.1 + -273.15  degC
+ *   0x375  EGT_9_C                    bits  7+16 u be  × 0.1 + -273.15  degC
+ *   0x375  EGT_10_C                   bits 23+16 u be  × 0.1 + -273.15  degC
+ *   0x375  EGT_11_C                   bits 39+16 u be  × 0.1 + -273.15  degC
+ *   0x375  EGT_12_C                   bits 55+16 u be  × 0.1 + -273.15  degC
+ *   0x376  AMBIENT_C                  bits  7+16 u be  × 0.1 + -273.15  degC
+ *   0x376  HUMIDITY_PCT               bits 23+16 u be  × 0.1 + 0  pct
+ *   0x3D0  LAMBDA             ui log  bits  0+16 u le  × 0.001 + 0  lambda
+ *   0x3D0  BOOST_KPA          ui log  bits 16+16 s le  × 0.1 + 0  kPa_abs
+ *   0x3D0  FUEL_PRESS_KPA     ui log  bits 32+16 s le  × 0.1 + 0  kPa
+ *   0x3D1  RPM                ui log  bits  0+16 u le  × 1 + 0  rpm
+ *   0x3D2  COOLANT_C          ui log  bits  0+16 s le  × 0.1 + 0  degC
+ *   0x3D2  OIL_PRESS_KPA      ui log  bits 16+16 s le  × 0.1 + 0  kPa
+ *   0x3E0  AIR_C                 log  bits 23+16 u be  × 0.1 + -273.15  degC
+ *   0x3E0  FUEL_C                     bits 39+16 u be  × 0.1 + -273.15  degC
+ *   0x3E0  OIL_C                      bits 55+16 u be  × 0.1 + -273.15  degC
+ *   0x3E1  GEARBOX_OIL_C              bits  7+16 u be  × 0.1 + -273.15  degC
+ *   0x3E1  DIFF_OIL_C                 bits 23+16 u be  × 0.1 + -273.15  degC
+ *   0x3E1  ETHANOL_PCT                bits 39+16 u be  × 0.1 + 0  pct
+ *   0x3E2  FUEL_LEVEL_L               bits  7+16 u be  × 0.1 + 0  L
+ *   0x3E3  STFT_1_PCT                 bits  7+16 s be  × 0.1 + 0  pct
+ *   0x3E3  STFT_2_PCT                 bits 23+16 s be  × 0.1 + 0  pct
+ *   0x3E3  LTFT_1_PCT                 bits 39+16 s be  × 0.1 + 0  pct
+ *   0x3E3  LTFT_2_PCT                 bits 55+16 s be  × 0.1 + 0  pct
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "can_signal.h"
+
+// ── Decoded channels ─────────────────────────────────────────────────────────
+// Displayed channels (@tune lines) first: CH_x < SENSOR_DISPLAY_COUNT
+enum SensorChannel : uint8_t {
+    CH_LAMBDA = 0,
+    CH_BOOST_KPA = 1,
+    CH_FUEL_PRESS_KPA = 2,
+    CH_RPM = 3,
+    CH_COOLANT_C = 4,
+    CH_OIL_PRESS_KPA = 5,
+    CH_TPS_PCT = 6,
+    CH_COOLANT_PRESS_KPA = 7,
+    CH_ENGINE_DEMAND_PCT = 8,
+    CH_WASTEGATE_KPA = 9,
+    CH_INJ1_DUTY_PCT = 10,
+    CH_INJ2_DUTY_PCT = 11,
+    CH_IGN_LEAD_DEG = 12,
+    CH_IGN_TRAIL_DEG = 13,
+    CH_WHEEL_SLIP_KMH = 14,
+    CH_WHEEL_DIFF_KMH = 15,
+    CH_LAUNCH_END_RPM = 16,
+    CH_INJ1_TIME_MS = 17,
+    CH_INJ2_TIME_MS = 18,
+    CH_INJ3_TIME_MS = 19,
+    CH_INJ4_TIME_MS = 20,
+    CH_LAMBDA_2 = 21,
+    CH_LAMBDA_3 = 22,
+    CH_LAMBDA_4 = 23,
+    CH_TRIGGER_ERRORS = 24,
+    CH_TRIGGER_COUNT = 25,
+    CH_TRIGGER_SYNC = 26,
+    CH_KNOCK_1_DB = 27,
+    CH_KNOCK_2_DB = 28,
+    CH_KNOCK_3_DB = 29,
+    CH_KNOCK_4_DB = 30,
+    CH_BRAKE_PRESS_KPA = 31,
+    CH_NOS_PRESS_KPA = 32,
+    CH_TURBO_RPM = 33,
+    CH_LATERAL_G = 34,
+    CH_WHEEL_FL_KMH = 35,
+    CH_WHEEL_FR_KMH = 36,
+    CH_WHEEL_RL_KMH = 37,
+    CH_WHEEL_RR_KMH = 38,
+    CH_EXH_CAM_1_DEG = 39,
+    CH_EXH_CAM_2_DEG = 40,
+    CH_ENGINE_LIMITING = 41,
+    CH_LAUNCH_RETARD_DEG = 42,
+    CH_LAUNCH_ENRICH_PCT = 43,
+    CH_LONG_G = 44,
+    CH_GP_OUT1_DUTY_PCT = 45,
+    CH_BOOST_DUTY_PCT = 46,
+    CH_SPEED_KMH = 47,
+    CH_INT_CAM_1_DEG = 48,
+    CH_INT_CAM_2_DEG = 49,
+    CH_FUEL_FLOW_CCM = 50,
+    CH_FUEL_RETURN_CCM = 51,
+    CH_FUEL_NET_CCM = 52,
+    CH_BATTERY_V = 53,
+    CH_TARGET_BOOST_KPA = 54,
+    CH_BARO_KPA = 55,
+    CH_EGT_1_C = 56,
+    CH_EGT_2_C = 57,
+    CH_EGT_3_C = 58,
+    CH_EGT_4_C = 59,
+    CH_EGT_5_C = 60,
+    CH_EGT_6_C = 61,
+    CH_EGT_7_C = 62,
+    CH_EGT_8_C = 63,
+    CH_EGT_9_C = 64,
+    CH_EGT_10_C = 65,
+    CH_EGT_11_C = 66,
+    CH_EGT_12_C = 67,
+    CH_AMBIENT_C = 68,
+    CH_HUMIDITY_PCT = 69,
+    CH_AIR_C = 70,
+    CH_FUEL_C = 71,
+    CH_OIL_C = 72,
+    CH_GEARBOX_OIL_C = 73,
+    CH_DIFF_OIL_C = 74,
+    CH_ETHANOL_PCT = 75,
+    CH_FUEL_LEVEL_L = 76,
+    CH_STFT_1_PCT = 77,
+    CH_STFT_2_PCT = 78,
+    CH_LTFT_1_PCT = 79,
+    CH_LTFT_2_PCT = 80,
+    SENSOR_CHANNEL_COUNT
+};
+#define SENSOR_DISPLAY_COUNT 6
+
+// Value of each channel before its first frame arrives
+#define SENSOR_CHANNEL_DEFAULTS { \
+    1.0f, 0.0f, 0.0f, 0.0f, 20.0f, 0.0f, \
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, \
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, \
+    0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, \
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, \
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, \
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, \
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, \
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 12.0f, \
+    0.0f, 101.3f, 20.0f, 20.0f, 20.0f, 20.0f, \
+    20.0f, 20.0f, 20.0f, 20.0f, 20.0f, 20.0f, \
+    20.0f, 20.0f, 20.0f, 0.0f, 20.0f, 20.0f, \
+    20.0f, 20.0f, 20.0f, 0.0f, 0.0f, 0.0f, \
+    0.0f, 0.0f, 0.0f, \
+}
+
+// Channel names, e.g. for log file headers
+#define SENSOR_CHANNEL_NAMES { \
+    "LAMBDA", "BOOST_KPA", "FUEL_PRESS_KPA", "RPM", "COOLANT_C", "OIL_PRESS_KPA", \
+    "TPS_PCT", "COOLANT_PRESS_KPA", "ENGINE_DEMAND_PCT", "WASTEGATE_KPA", "INJ1_DUTY_PCT", "INJ2_DUTY_PCT", \
+    "IGN_LEAD_DEG", "IGN_TRAIL_DEG", "WHEEL_SLIP_KMH", "WHEEL_DIFF_KMH", "LAUNCH_END_RPM", "INJ1_TIME_MS", \
+    "INJ2_TIME_MS", "INJ3_TIME_MS", "INJ4_TIME_MS", "LAMBDA_2", "LAMBDA_3", "LAMBDA_4", \
+    "TRIGGER_ERRORS", "TRIGGER_COUNT", "TRIGGER_SYNC", "KNOCK_1_DB", "KNOCK_2_DB", "KNOCK_3_DB", \
+    "KNOCK_4_DB", "BRAKE_PRESS_KPA", "NOS_PRESS_KPA", "TURBO_RPM", "LATERAL_G", "WHEEL_FL_KMH", \
+    "WHEEL_FR_KMH", "WHEEL_RL_KMH", "WHEEL_RR_KMH", "EXH_CAM_1_DEG", "EXH_CAM_2_DEG", "ENGINE_LIMITING", \
+    "LAUNCH_RETARD_DEG", "LAUNCH_ENRICH_PCT", "LONG_G", "GP_OUT1_DUTY_PCT", "BOOST_DUTY_PCT", "SPEED_KMH", \
+    "INT_CAM_1_DEG", "INT_CAM_2_DEG", "FUEL_FLOW_CCM", "FUEL_RETURN_CCM", "FUEL_NET_CCM", "BATTERY_V", \
+    "TARGET_BOOST_KPA", "BARO_KPA", "EGT_1_C", "EGT_2_C", "EGT_3_C", "EGT_4_C", \
+    "EGT_5_C", "EGT_6_C", "EGT_7_C", "EGT_8_C", "EGT_9_C", "EGT_10_C", \
+    "EGT_11_C", "EGT_12_C", "AMBIENT_C", "HUMIDITY_PCT", "AIR_C", "FUEL_C", \
+    "OIL_C", "GEARBOX_OIL_C", "DIFF_OIL_C", "ETHANOL_PCT", "FUEL_LEVEL_L", "STFT_1_PCT", \
+    "STFT_2_PCT", "LTFT_1_PCT", "LTFT_2_PCT", \
+}
+
+// ── Logged channels (@log lines) ─────────────────────────────────────────────
+// Data log columns, in channel order (data_logger.h)
+#define SENSOR_LOG_COUNT 12
+#define SENSOR_LOG_CHANNELS { \
+    CH_LAMBDA, CH_BOOST_KPA, CH_FUEL_PRESS_KPA, CH_RPM, CH_COOLANT_C, CH_OIL_PRESS_KPA, \
+    CH_TPS_PCT, CH_IGN_LEAD_DEG, CH_KNOCK_1_DB, CH_SPEED_KMH, CH_BATTERY_V, CH_AIR_C, \
+}
+// Log column of each channel, 0xFF if it is not logged
+#define SENSOR_LOG_COLUMN { \
+    0, 1, 2, 3, 4, 5, \
+    6, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, \
+    7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, \
+    0xFF, 0xFF, 0xFF, 8, 0xFF, 0xFF, \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 9, \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 10, \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, \
+    0xFF, 0xFF, 0xFF, 0xFF, 11, 0xFF, \
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, \
+    0xFF, 0xFF, 0xFF, \
+}
+
+// ── Per-channel tuning (@tune lines) ─────────────────────────────────────────
+// Filter of each channel (sensor_filter.h): { kind, a, b }
+#define SENSOR_FILTERS { \
+    { SENSOR_FILTER_KALMAN, 0.5f, 0.0001f }, \
+    { SENSOR_FILTER_KALMAN, 4000.0f, 1.0f }, \
+    { SENSOR_FILTER_EMA, 100.0f, 0.0f }, \
+    { SENSOR_FILTER_RATE, 20000.0f, 0.0f }, \
+    { SENSOR_FILTER_EMA, 2000.0f, 0.0f }, \
+    { SENSOR_FILTER_EMA, 200.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+    { SENSOR_FILTER_NONE, 0.0f, 0.0f }, \
+}
+// Histogram range { low, high } for session statistics (sensor_stats.h)
+#define SENSOR_STATS_RANGE { \
+    { 0.6f, 1.4f }, { 0.0f, 320.0f }, { 0.0f, 640.0f }, { 0.0f, 9600.0f }, \
+    { -40.0f, 140.0f }, { 0.0f, 960.0f }, { -3276.8f, 3276.7f }, { -101.3f, 6452.2f }, \
+    { 0.0f, 6553.5f }, { -101.3f, 6452.2f }, { 0.0f, 6553.5f }, { 0.0f, 6553.5f }, \
+    { -3276.8f, 3276.7f }, { -3276.8f, 3276.7f }, { -3276.8f, 3276.7f }, { -3276.8f, 3276.7f }, \
+    { -32768.0f, 32767.0f }, { 0.0f, 65.535f }, { 0.0f, 65.535f }, { 0.0f, 65.535f }, \
+    { 0.0f, 65.535f }, { 0.0f, 65.535f }, { 0.0f, 65.535f }, { 0.0f, 65.535f }, \
+    { 0.0f, 65535.0f }, { 0.0f, 65535.0f }, { 0.0f, 65535.0f }, { 0.0f, 655.35f }, \
+    { 0.0f, 655.35f }, { 0.0f, 655.35f }, { 0.0f, 655.35f }, { 0.0f, 65535.0f }, \
+    { -101.3f, 14316.4f }, { 0.0f, 655350.0f }, { -3276.8f, 3276.7f }, { 0.0f, 6553.5f }, \
+    { 0.0f, 6553.5f }, { 0.0f, 6553.5f }, { 0.0f, 6553.5f }, { -3276.8f, 3276.7f }, \
+    { -3276.8f, 3276.7f }, { 0.0f, 65535.0f }, { -3276.8f, 3276.7f }, { -3276.8f, 3276.7f }, \
+    { -3276.8f, 3276.7f }, { 0.0f, 6553.5f }, { 0.0f, 6553.5f }, { 0.0f, 6553.5f }, \
+    { -3276.8f, 3276.7f }, { -3276.8f, 3276.7f }, { 0.0f, 65535.0f }, { 0.0f, 65535.0f }, \
+    { -32768.0f, 32767.0f }, { 0.0f, 6553.5f }, { 0.0f, 6553.5f }, { 0.0f, 6553.5f }, \
+    { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, \
+    { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, \
+    { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, \
+    { -273.15f, 6280.35f }, { 0.0f, 6553.5f }, { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, \
+    { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, { -273.15f, 6280.35f }, { 0.0f, 6553.5f }, \
+    { 0.0f, 6553.5f }, { -3276.8f, 3276.7f }, { -3276.8f, 3276.7f }, { -3276.8f, 3276.7f }, \
+    { -3276.8f, 3276.7f }, \
+}
+// Smallest change animated instead of shown at once, per displayed channel
+// (sensor_interp.h)
+#define SENSOR_INTERP_MIN_STEP { 0.002f, 0.5f, 1.0f, 10.0f, 0.1f, 1.0f }
+// Shortest interval between screen refreshes a displayed channel triggers, ms
+// (ui_runtime.h)
+#define UI_CHANNEL_PERIOD_MS { 33, 33, 100, 50, 1000, 250 }
+
+// ── Signal descriptors (grouped by message) ──────────────────────────────────
+static constexpr CanSignal kCanSignals[] = {
+    canSignal(0x360, 39, 16, true , true , 0.1f, 0.0f, CH_TPS_PCT),
+    canSignal(0x360, 55, 16, false, true , 0.1f, -101.3f, CH_COOLANT_PRESS_KPA),
+    canSignal(0x361, 39, 16, false, true , 0.1f, 0.0f, CH_ENGINE_DEMAND_PCT),
+    canSignal(0x361, 55, 16, false, true , 0.1f, -101.3f, CH_WASTEGATE_KPA),
+    canSignal(0x362,  7, 16, false, true , 0.1f, 0.0f, CH_INJ1_DUTY_PCT),
+    canSignal(0x362, 23, 16, false, true , 0.1f, 0.0f, CH_INJ2_DUTY_PCT),
+    canSignal(0x362, 39, 16, true , true , 0.1f, 0.0f, CH_IGN_LEAD_DEG),
+    canSignal(0x362, 55, 16, true , true , 0.1f, 0.0f, CH_IGN_TRAIL_DEG),
+    canSignal(0x363,  7, 16, true , true , 0.1f, 0.0f, CH_WHEEL_SLIP_KMH),
+    canSignal(0x363, 23, 16, true , true , 0.1f, 0.0f, CH_WHEEL_DIFF_KMH),
+    canSignal(0x363, 55, 16, true , true , 1.0f, 0.0f, CH_LAUNCH_END_RPM),
+    canSignal(0x364,  7, 16, false, true , 0.001f, 0.0f, CH_INJ1_TIME_MS),
+    canSignal(0x364, 23, 16, false, true , 0.001f, 0.0f, CH_INJ2_TIME_MS),
+    canSignal(0x364, 39, 16, false, true , 0.001f, 0.0f, CH_INJ3_TIME_MS),
+    canSignal(0x364, 55, 16, false, true , 0.001f, 0.0f, CH_INJ4_TIME_MS),
+    canSignal(0x368, 23, 16, false, true , 0.001f, 0.0f, CH_LAMBDA_2),
+    canSignal(0x368, 39, 16, false, true , 0.001f, 0.0f, CH_LAMBDA_3),
+    canSignal(0x368, 55, 16, false, true , 0.001f, 0.0f, CH_LAMBDA_4),
+    canSignal(0x369,  7, 16, false, true , 1.0f, 0.0f, CH_TRIGGER_ERRORS),
+    canSignal(0x369, 23, 16, false, true , 1.0f, 0.0f, CH_TRIGGER_COUNT),
+    canSignal(0x369, 55, 16, false, true , 1.0f, 0.0f, CH_TRIGGER_SYNC),
+    canSignal(0x36A,  7, 16, false, true , 0.01f, 0.0f, CH_KNOCK_1_DB),
+    canSignal(0x36A, 23, 16, false, true , 0.01f, 0.0f, CH_KNOCK_2_DB),
+    canSignal(0x36A, 39, 16, false, true , 0.01f, 0.0f, CH_KNOCK_3_DB),
+    canSignal(0x36A, 55, 16, false, true , 0.01f, 0.0f, CH_KNOCK_4_DB),
+    canSignal(0x36B,  7, 16, false, true , 1.0f, 0.0f, CH_BRAKE_PRESS_KPA),
+    canSignal(0x36B, 23, 16, false, true , 0.22f, -101.3f, CH_NOS_PRESS_KPA),
+    canSignal(0x36B, 39, 16, false, true , 10.0f, 0.0f, CH_TURBO_RPM),
+    canSignal(0x36B, 55, 16, true , true , 0.1f, 0.0f, CH_LATERAL_G),
+    canSignal(0x36C,  7, 16, false, true , 0.1f, 0.0f, CH_WHEEL_FL_KMH),
+    canSignal(0x36C, 23, 16, false, true , 0.1f, 0.0f, CH_WHEEL_FR_KMH),
+    canSignal(0x36C, 39, 16, false, true , 0.1f, 0.0f, CH_WHEEL_RL_KMH),
+    canSignal(0x36C, 55, 16, false, true , 0.1f, 0.0f, CH_WHEEL_RR_KMH),
+    canSignal(0x36D, 39, 16, true , true , 0.1f, 0.0f, CH_EXH_CAM_1_DEG),
+    canSignal(0x36D, 55, 16, true , true , 0.1f, 0.0f, CH_EXH_CAM_2_DEG),
+    canSignal(0x36E,  7, 16, false, true , 1.0f, 0.0f, CH_ENGINE_LIMITING),
+    canSignal(0x36E, 23, 16, true , true , 0.1f, 0.0f, CH_LAUNCH_RETARD_DEG),
+    canSignal(0x36E, 39, 16, true , true , 0.1f, 0.0f, CH_LAUNCH_ENRICH_PCT),
+    canSignal(0x36E, 55, 16, true , true , 0.1f, 0.0f, CH_LONG_G),
+    canSignal(0x36F,  7, 16, false, true , 0.1f, 0.0f, CH_GP_OUT1_DUTY_PCT),
+    canSignal(0x36F, 23, 16, false, true , 0.1f, 0.0f, CH_BOOST_DUTY_PCT),
+    canSignal(0x370,  7, 16, false, true , 0.1f, 0.0f, CH_SPEED_KMH),
+    canSignal(0x370, 39, 16, true , true , 0.1f, 0.0f, CH_INT_CAM_1_DEG),
+    canSignal(0x370, 55, 16, true , true , 0.1f, 0.0f, CH_INT_CAM_2_DEG),
+    canSignal(0x371,  7, 16, false, true , 1.0f, 0.0f, CH_FUEL_FLOW_CCM),
+    canSignal(0x371, 23, 16, false, true , 1.0f, 0.0f, CH_FUEL_RETURN_CCM),
+    canSignal(0x371, 39, 16, true , true , 1.0f, 0.0f, CH_FUEL_NET_CCM),
+    canSignal(0x372,  7, 16, false, true , 0.1f, 0.0f, CH_BATTERY_V),
+    canSignal(0x372, 39, 16, false, true , 0.1f, 0.0f, CH_TARGET_BOOST_KPA),
+    canSignal(0x372, 55, 16, false, true , 0.1f, 0.0f, CH_BARO_KPA),
+    canSignal(0x373,  7, 16, false, true , 0.1f, -273.15f, CH_EGT_1_C),
+    canSignal(0x373, 23, 16, false, true , 0.1f, -273.15f, CH_EGT_2_C),
+    canSignal(0x373, 39, 16, false, true , 0.1f, -273.15f, CH_EGT_3_C),
+    canSignal(0x373, 55, 16, false, true , 0.1f, -273.15f, CH_EGT_4_C),
+    canSignal(0x374,  7, 16, false, true , 0.1f, -273.15f, CH_EGT_5_C),
+    canSignal(0x374, 23, 16, false, true , 0.1f, -273.15f, CH_EGT_6_C),
+    canSignal(0x374, 39, 16, false, true , 0.1f, -273.15f, CH_EGT_7_C),
+    canSignal(0x374, 55, 16, false, true , 0.1f, -273.15f, CH_EGT_8_C),
+    canSignal(0x375,  7, 16, false, true , 0.1f, -273.15f, CH_EGT_9_C),
+    canSignal(0x375, 23, 16, false, true , 0.1f, -273.15f, CH_EGT_10_C),
+    canSignal(0x375, 39, 16, false, true , 0.1f, -273.15f, CH_EGT_11_C),
+    canSignal(0x375, 55, 16, false, true , 0.1f, -273.15f, CH_EGT_12_C),
+    canSignal(0x376,  7, 16, false, true , 0.1f, -273.15f, CH_AMBIENT_C),
+    canSignal(0x376, 23, 16, false, true , 0.1f, 0.0f, CH_HUMIDITY_PCT),
+    canSignal(0x3D0,  0, 16, false, false, 0.001f, 0.0f, CH_LAMBDA),
+    canSignal(0x3D0, 16, 16, true , false, 0.1f, 0.0f, CH_BOOST_KPA),
+    canSignal(0x3D0, 32, 16, true , false, 0.1f, 0.0f, CH_FUEL_PRESS_KPA),
+    canSignal(0x3D1,  0, 16, false, false, 1.0f, 0.0f, CH_RPM),
+    canSignal(0x3D2,  0, 16, true , false, 0.1f, 0.0f, CH_COOLANT_C),
+    canSignal(0x3D2, 16, 16, true , false, 0.1f, 0.0f, CH_OIL_PRESS_KPA),
+    canSignal(0x3E0, 23, 16, false, true , 0.1f, -273.15f, CH_AIR_C),
+    canSignal(0x3E0, 39, 16, false, true , 0.1f, -273.15f, CH_FUEL_C),
+    canSignal(0x3E0, 55, 16, false, true , 0.1f, -273.15f, CH_OIL_C),
+    canSignal(0x3E1,  7, 16, false, true , 0.1f, -273.15f, CH_GEARBOX_OIL_C),
+    canSignal(0x3E1, 23, 16, false, true , 0.1f, -273.15f, CH_DIFF_OIL_C),
+    canSignal(0x3E1, 39, 16, false, true , 0.1f, 0.0f, CH_ETHANOL_PCT),
+    canSignal(0x3E2,  7, 16, false, true , 0.1f, 0.0f, CH_FUEL_LEVEL_L),
+    canSignal(0x3E3,  7, 16, true , true , 0.1f, 0.0f, CH_STFT_1_PCT),
+    canSignal(0x3E3, 23, 16, true , true , 0.1f, 0.0f, CH_STFT_2_PCT),
+    canSignal(0x3E3, 39, 16, true , true , 0.1f, 0.0f, CH_LTFT_1_PCT),
+    canSignal(0x3E3, 55, 16, true , true , 0.1f, 0.0f, CH_LTFT_2_PCT),
+};
+
+// { id, minDlc, firstSignal, signalCount, wanted, decode }
+static constexpr CanMessage kCanMessages[] = {
+    { 0x360, 8,  0, 2, 1, decodeCanSignals<kCanSignals, 0, 2> },
+    { 0x361, 8,  2, 2, 0, decodeCanSignals<kCanSignals, 2, 2> },
+    { 0x362, 8,  4, 4, 1, decodeCanSignals<kCanSignals, 4, 4> },
+    { 0x363, 8,  8, 3, 0, decodeCanSignals<kCanSignals, 8, 3> },
+    { 0x364, 8, 11, 4, 0, decodeCanSignals<kCanSignals, 11, 4> },
+    { 0x368, 8, 15, 3, 0, decodeCanSignals<kCanSignals, 15, 3> },
+    { 0x369, 8, 18, 3, 0, decodeCanSignals<kCanSignals, 18, 3> },
+    { 0x36A, 8, 21, 4, 1, decodeCanSignals<kCanSignals, 21, 4> },
+    { 0x36B, 8, 25, 4, 0, decodeCanSignals<kCanSignals, 25, 4> },
+    { 0x36C, 8, 29, 4, 0, decodeCanSignals<kCanSignals, 29, 4> },
+    { 0x36D, 8, 33, 2, 0, decodeCanSignals<kCanSignals, 33, 2> },
+    { 0x36E, 8, 35, 4, 0, decodeCanSignals<kCanSignals, 35, 4> },
+    { 0x36F, 4, 39, 2, 0, decodeCanSignals<kCanSignals, 39, 2> },
+    { 0x370, 8, 41, 3, 1, decodeCanSignals<kCanSignals, 41, 3> },
+    { 0x371, 6, 44, 3, 0, decodeCanSignals<kCanSignals, 44, 3> },
+    { 0x372, 8, 47, 3, 1, decodeCanSignals<kCanSignals, 47, 3> },
+    { 0x373, 8, 50, 4, 0, decodeCanSignals<kCanSignals, 50, 4> },
+    { 0x374, 8, 54, 4, 0, decodeCanSignals<kCanSignals, 54, 4> },
+    { 0x375, 8, 58, 4, 0, decodeCanSignals<kCanSignals, 58, 4> },
+    { 0x376, 4, 62, 2, 0, decodeCanSignals<kCanSignals, 62, 2> },
+    { 0x3D0, 6, 64, 3, 1, decodeCanSignals<kCanSignals, 64, 3> },
+    { 0x3D1, 2, 67, 1, 1, decodeCanSignals<kCanSignals, 67, 1> },
+    { 0x3D2, 4, 68, 2, 1, decodeCanSignals<kCanSignals, 68, 2> },
+    { 0x3E0, 8, 70, 3, 1, decodeCanSignals<kCanSignals, 70, 3> },
+    { 0x3E1, 6, 73, 3, 0, decodeCanSignals<kCanSignals, 73, 3> },
+    { 0x3E2, 2, 76, 1, 0, decodeCanSignals<kCanSignals, 76, 1> },
+    { 0x3E3, 8, 77, 4, 0, decodeCanSignals<kCanSignals, 77, 4> },
+};
+#define CAN_MESSAGE_COUNT 27
+
+// ── id → message dispatch ────────────────────────────────────────────────────
+#define CAN_DISPATCH_BASE 0x360
+#define CAN_DISPATCH_SPAN 132
+static constexpr uint8_t kCanDispatch[CAN_DISPATCH_SPAN] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0xFF, 0xFF, 0xFF, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C,
+    0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x14, 0x15, 0x16, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x17, 0x18, 0x19, 0x1A,
+};
+
+/** Index into kCanMessages for a CAN id, or -1 if it is not decoded. */
+inline int canMessageIndex(uint32_t id) {
+    uint32_t slot = id - CAN_DISPATCH_BASE;
+    if (slot >= CAN_DISPATCH_SPAN) return -1;
+    uint8_t m = kCanDispatch[slot];
+    return m == 0xFF ? -1 : m;
+}
@@ -0,0 +1,146 @@
+/**
+ * can_twai.h
+ * CAN backend for the ESP32-S3's own TWAI controller (CAN_BACKEND_TWAI, see
+ * can_backend.h), through a 3.3 V transceiver on CAN_TWAI_TX / CAN_TWAI_RX.
+ *
+ * The ESP-IDF driver's ISR copies each frame out of the controller's
+ * 64-byte receive FIFO into a FreeRTOS queue of CAN_TWAI_RX_QUEUE_LEN;
+ * reading a frame is a queue receive, with no SPI hop.  The driver is
+ * installed from the CAN task, so its ISR runs on the CAN core.  The CAN
+ * task sleeps on the driver's RX_DATA alert.
+ *
+ * Filtering uses the controller's dual-filter mode: two id/mask pairs
+ * planned for the decoder's ids (canFilterPlanBanks(..., 1, 1)).  Two
+ * filters admit more unwanted ids than the MCP2515's six, but an admitted
+ * frame is far cheaper here.  In dual-filter mode an extended frame is
+ * matched on its top 16 id bits, so a few can get through; the decoder
+ * does not know them and skips them.
+ *
+ * pollErrors() maps the driver's status onto the MCP2515 EFLG bits that
+ * can_health.h counts: RX0OVR when the driver queue was full (frames
+ * missed), RX1OVR when the hardware FIFO overran, RXEP/TXEP and TXBO from
+ * the error counters and state.  Bus-off is recovered from and the
+ * controller restarted, as the MCP2515 does on its own.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <driver/twai.h>
+#include <atomic>
+#include "config.h"
+#include "can_handler.h"
+#include "can_health.h"
+
+class CanTwaiBackend {
+public:
+    const char *name(void) const { return "twai"; }
+
+    /** Driver install with the decoder's dual filters, then start – on the CAN task. */
+    void begin(void) {
+        twai_general_config_t g = TWAI_GENERAL_CONFIG_DEFAULT((gpio_num_t)CAN_TWAI_TX,
+                                                              (gpio_num_t)CAN_TWAI_RX,
+                                                              TWAI_MODE_NORMAL);
+        g.tx_queue_len   = 0;   // receive only
+        g.rx_queue_len   = CAN_TWAI_RX_QUEUE_LEN;
+        g.alerts_enabled = TWAI_ALERT_RX_DATA | TWAI_ALERT_BUS_OFF | TWAI_ALERT_BUS_RECOVERED;
+        twai_timing_config_t t = CAN_TWAI_TIMING;
+
+        twai_filter_config_t f = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+        CanFilterPlan plan;
+        if (const char *err = canDecoderFilterPlanBanks(plan, 1, 1)) {
+            Serial.printf("[CAN] WARNING: no filter plan (%s) – accepting every frame\n", err);
+        } else {
+            canFilterTwaiDual(plan, f.acceptance_code, f.acceptance_mask);
+            f.single_filter = false;
+            Serial.printf("[CAN] Filters admit %u ids, %u unwanted\n",
+                          (unsigned)plan.accepted, (unsigned)plan.unwanted);
+        }
+
+        if (twai_driver_install(&g, &t, &f) != ESP_OK || twai_start() != ESP_OK) {
+            Serial.println("[CAN] WARNING: TWAI driver failed to start – check CAN_TWAI_TX/RX");
+            return;
+        }
+        m_running = true;
+        Serial.println("[CAN] TWAI ready");
+    }
+
+    /**
+     * Until the driver raises an alert (a frame queued, bus-off) or timeoutMs
+     * passes.  Without a running driver twai_read_alerts() fails at once, so
+     * the task sleeps instead of spinning and starving core 0.
+     */
+    void wait(uint32_t timeoutMs) {
+        TickType_t ticks = pdMS_TO_TICKS(timeoutMs);
+        if (ticks == 0 && timeoutMs > 0) ticks = 1;
+        if (!m_running) {
+            vTaskDelay(ticks ? ticks : 1);
+            return;
+        }
+        uint32_t alerts = 0;
+        if (twai_read_alerts(&alerts, ticks) != ESP_OK) return;
+        if (alerts & TWAI_ALERT_BUS_RECOVERED) twai_start();
+    }
+
+    /** The driver's ISR has no hook to timestamp, so no INT latency is recorded. */
+    uint32_t takeIrqUs(void) { return 0; }
+
+    /** Up to two frames off the driver's queue, without blocking. */
+    uint8_t read(struct can_frame out[2]) {
+        if (!m_running) return 0;
+        uint8_t n = 0;
+        twai_message_t msg;
+        while (n < 2 && twai_receive(&msg, 0) == ESP_OK) {
+            struct can_frame &f = out[n++];
+            f.can_id = msg.identifier;
+            if (msg.extd) f.can_id |= CAN_EFF_FLAG;
+            if (msg.rtr)  f.can_id |= CAN_RTR_FLAG;
+            f.can_dlc = msg.data_length_code > 8 ? 8 : msg.data_length_code;
+            memcpy(f.data, msg.data, 8);
+        }
+        m_frames.fetch_add(n, std::memory_order_relaxed);
+        return n;
+    }
+
+    /** Every CAN_HEALTH_POLL_MS: the driver's status into can_health.h. */
+    void pollErrors(void) {
+        uint32_t now = millis();
+        if (now - m_lastPollMs < CAN_HEALTH_POLL_MS) return;
+        m_lastPollMs = now;
+        if (!m_running) return;
+        twai_status_info_t st;
+        if (twai_get_status_info(&st) != ESP_OK) return;
+
+        uint8_t eflg = 0;
+        if (st.rx_missed_count  != m_lastMissed)  eflg |= CAN_EFLG_RX0OVR;
+        if (st.rx_overrun_count != m_lastOverrun) eflg |= CAN_EFLG_RX1OVR;
+        m_lastMissed  = st.rx_missed_count;
+        m_lastOverrun = st.rx_overrun_count;
+        if (st.rx_error_counter >= 128) eflg |= CAN_EFLG_RXEP;
+        if (st.tx_error_counter >= 128) eflg |= CAN_EFLG_TXEP;
+        if (st.state == TWAI_STATE_BUS_OFF) {
+            eflg |= CAN_EFLG_TXBO;
+            twai_initiate_recovery();   // twai_start() once BUS_RECOVERED is raised
+        }
+        canHealthController(eflg, (uint8_t)(st.rx_error_counter > 255 ? 255 : st.rx_error_counter),
+                            (uint8_t)(st.tx_error_counter > 255 ? 255 : st.tx_error_counter));
+        if (st.msgs_to_rx > m_queuePeak.load(std::memory_order_relaxed)) {
+            m_queuePeak.store(st.msgs_to_rx, std::memory_order_relaxed);
+        }
+    }
+
+    /** Frames read and the driver queue's peak fill (as polled) since the last call. */
+    char *format(char *buf, size_t size) {
+        snprintf(buf, size, "%lu frames, driver queue peak %lu/%u, no SPI",
+                 (unsigned long)m_frames.exchange(0), (unsigned long)m_queuePeak.exchange(0),
+                 (unsigned)CAN_TWAI_RX_QUEUE_LEN);
+        return buf;
+    }
+
+private:
+    bool     m_running = false;   // driver installed and started
+    uint32_t m_lastPollMs = 0;
+    uint32_t m_lastMissed = 0, m_lastOverrun = 0;
+    // Counted by the CAN task, reset by format() on the UI task
+    std::atomic<uint32_t> m_frames{0}, m_queuePeak{0};
+};
@@ -34,14 +34,36 @@
 // ── Display ──────────────────────────────────────────────────────────────────
 #define DISPLAY_WIDTH   466
 #define DISPLAY_HEIGHT  466
+#define ROUND_VIEWPORT  1     // skip the invisible corners of the round panel (round_viewport.h)
+
+// ── Display rendering (render_strategy.h) ────────────────────────────────────
+#define RENDER_STRATEGY     1     // 0 partial/SRAM, 1 partial/PSRAM, 2 direct/PSRAM
+#define RENDER_BUF_LINES    46    // rows per partial draw buffer (466 / 10)
+#define RENDER_CALIBRATE    0     // 1 = time every strategy at boot, keep the fastest
+#define RENDER_CAL_FRAMES   8     // full redraws timed per screen and strategy
+
+// ── CAN backend (can_backend.h) ──────────────────────────────────────────────
+// The MCP2515 on SPI, or the ESP32-S3's own TWAI controller with a 3.3 V
+// transceiver (SN65HVD230 or similar) on CAN_TWAI_TX / CAN_TWAI_RX.
+#define CAN_BACKEND_MCP2515 0
+#define CAN_BACKEND_TWAI    1
+#ifndef CAN_BACKEND
+#define CAN_BACKEND         CAN_BACKEND_MCP2515   // or build with -DCAN_BACKEND=1
+#endif
 
 // ── MCP2515 SPI pins ─────────────────────────────────────────────────────────
 #define CAN_SPI_MOSI    11
 #define CAN_SPI_MISO    12
 #define CAN_SPI_SCK     13
 #define CAN_SPI_CS      10
+#define CAN_SPI_CLOCK   10000000   // Hz; the MCP2515's maximum
 #define CAN_INT_PIN      9   // Set to -1 to disable interrupt-driven RX
 
+// ── TWAI transceiver pins and driver (CAN_BACKEND_TWAI) ──────────────────────
+#define CAN_TWAI_TX     11   // the MCP2515's MOSI / MISO header pins
+#define CAN_TWAI_RX     12
+#define CAN_TWAI_RX_QUEUE_LEN  32   // frames the driver's ISR buffers for the CAN task
+
 // ── Touch / RTC I2C ──────────────────────────────────────────────────────────
 #define I2C_SCL_PIN     14
 #define I2C_SDA_PIN     15
@@ -49,6 +71,46 @@
 // ── CAN configuration ────────────────────────────────────────────────────────
 // Haltech CAN V2 runs at 1 Mbps; change CAN_SPEED if your setup differs.
 #define CAN_SPEED       CAN_1000KBPS
+#define CAN_TWAI_TIMING TWAI_TIMING_CONFIG_1MBITS()   // the same rate for the TWAI backend
+
+// ── CAN RX queue (ISR/RX task → decoder) ─────────────────────────────────────
+// 256 frames ≈ 32 ms of a fully loaded 1 Mbps bus (~8k frames/s).
+#define CAN_RX_QUEUE_LEN    256   // must be a power of two
+#define CAN_DRAIN_BATCH     16    // frames popped per batch by drainCANQueue()
+#define CAN_RX_TASK_CORE    0     // CAN RX + decode; the UI task has core 1
+#define CAN_RX_TASK_PRIO    5
+
+// ── CAN bus health and decode budget (can_health.h) ──────────────────────────
+#define CAN_HEALTH_MAX_IDS  16    // IDs counted separately, the rest as "other"
+#define CAN_HEALTH_POLL_MS  100   // MCP2515 error flag (EFLG) poll interval
+#define CAN_LATENCY_BIN_US  25    // RX latency histogram resolution
+#define CAN_LATENCY_BINS    80    // last bin collects everything beyond 2 ms
+#if CAN_BACKEND == CAN_BACKEND_TWAI
+#define CAN_HW_RX_BUFFERS   CAN_TWAI_RX_QUEUE_LEN   // frames the controller holds while the task decodes
+#else
+#define CAN_HW_RX_BUFFERS   2
+#endif
+#define CAN_DRAIN_DUTY      0.5f  // share of their fill time a pass may spend decoding
+
+// ── Sensor filtering and interpolation (sensor_filter.h, sensor_interp.h) ───
+// The per-channel filters, smallest animated steps, statistics ranges and
+// UI refresh caps (SENSOR_FILTERS, SENSOR_INTERP_MIN_STEP,
+// SENSOR_STATS_RANGE, UI_CHANNEL_PERIOD_MS) are generated into
+// can_signals.h from the @tune lines of tools/haltech_v2.sig, so they
+// always have one entry per channel.
+
+// ── Data logger (data_logger.h) ──────────────────────────────────────────────
+#define DATA_LOG            1                  // 0 = compile the logger out
+#define LOG_BLOCK_ROWS      256                // rows per encoded block
+#define LOG_BLOCK_MAX_MS    1000               // seal a block at least this often
+#define LOG_RING_BYTES      (256 * 1024)       // encoded blocks awaiting the writer (PSRAM)
+#define LOG_WRITE_BATCH     (32 * 1024)        // bytes per fwrite()
+#define LOG_FLUSH_MS        2000               // write a partial batch after this long
+#define LOG_MAX_FILE_BYTES  (384u * 1024)      // then recording goes on in a new file
+#define LOG_TASK_CORE       0                  // shares the CAN core, below its priority
+#define LOG_TASK_PRIO       1
+#define LOG_TASK_STACK      4096
+#define LOG_KEEP_FILES      2                  // logs kept on LittleFS (1 MB with Huge APP)
 
 // ── Haltech CAN V2 message IDs ───────────────────────────────────────────────
 #define CAN_ID_LAMBDA_BOOST_FUELPRES    0x3D0
@@ -58,16 +120,49 @@
 // ── LVGL tick interval ───────────────────────────────────────────────────────
 #define LV_TICK_PERIOD_MS   5   // ms between lv_tick_inc() calls
 
+// ── UI task (ui_runtime.h) ───────────────────────────────────────────────────
+#define UI_TASK_CORE        1     // LVGL rendering and screen updates
+#define UI_TASK_PRIO        2     // below the CAN task
+#define UI_TASK_STACK       8192
+#define UI_UPDATE_PERIOD_MS 100   // refresh of time-driven screens (clock)
+#define UI_MAX_SLEEP_MS     50    // longest UI task wait between LVGL passes
+#define UI_ANIM_FRAME_MS    33    // screen refresh while a value is still moving
+
+// ── UI redraw statistics ─────────────────────────────────────────────────────
+#define UI_STATS_PERIOD_MS  5000  // invalidated-pixel rate report interval
+
+// ── Hot-path tracing (trace.h) ───────────────────────────────────────────────
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED       0     // 1 = record trace spans (or build with -DTRACE_ENABLED=1)
+#endif
+#define TRACE_RING_LEN      2048  // spans kept, oldest overwritten (power of two)
+#define TRACE_OVERLAY       0     // 1 = show the perf overlay from boot (trace_overlay.h)
+
+// ── Clock ────────────────────────────────────────────────────────────────────
+#define CLOCK_SWEEP_PERIOD_MS  33  // smooth second-hand step (0 = tick once per second)
+
 // ── Gesture / long-press timing ──────────────────────────────────────────────
 #define LONG_PRESS_MS       3000  // 3-second hold to enter/exit setup screen
 
 // ── NVS storage key ──────────────────────────────────────────────────────────
 #define NVS_NAMESPACE       "roundie"
 #define NVS_KEY_IS_METRIC   "isMetric"
+#define NVS_KEY_RENDER_MODE  "renderMode"
+#define NVS_KEY_RENDER_LINES "renderLines"
+#define NVS_KEY_LOG_SEQ      "logSeq"
+
+// ── Screen manager (screen_manager.h) ────────────────────────────────────────
+#define SCREEN_HEAP_BUDGET   (96 * 1024)  // bytes of resident screens before eviction
+#define SCREEN_PREWARM       1     // build swipe neighbours of the active screen when idle
+#define SCREEN_EVICT_HOLD_MS 5000  // screens shown this recently are never deleted
+
+// ── Gauge layout (gauge_layout.h) ────────────────────────────────────────────
+#define GAUGE_LAYOUT_FILE    "/layout.rgl"  // on LittleFS; overrides the built-in layout
 
 // ── Screen indices ───────────────────────────────────────────────────────────
 #define SCREEN_CLOCK        0
 #define SCREEN_MULTIARC     1
 #define SCREEN_BOOSTGAUGE   2
-#define SCREEN_SETUP        3
-#define SCREEN_COUNT        3   // number of main (swipeable) screens
+#define SCREEN_LAYOUT       3
+#define SCREEN_SETUP        4
+#define SCREEN_COUNT        4   // number of main (swipeable) screens
@@ -0,0 +1,465 @@
+/**
+ * data_logger.h
+ * Full-rate binary log of the logged channels (@log lines in
+ * tools/haltech_v2.sig, SENSOR_LOG_CHANNELS).
+ *
+ * Every decoded frame that carries a logged channel appends one row – its
+ * timestamp plus the raw value of every logged channel – to a staging
+ * block.  Rows are kept as integers in signal
+ * units (raw = (value - offset) / scale), so they delta-encode exactly.
+ * When LOG_BLOCK_ROWS rows are staged, or the oldest row is LOG_BLOCK_MAX_MS
+ * old, the block is encoded column by column:
+ *
+ *   timestamps  uvarint delta to the previous row
+ *   column n    zigzag varint delta to the previous row (first row absolute)
+ *
+ * A column that did not change costs one byte per row, so a row of twelve
+ * logged channels typically takes 13–16 bytes instead of 52.  Encoded blocks go into
+ * a PSRAM byte ring.  The decoder never touches the file system.
+ *
+ * A low-priority writer (dataLogPump(), from its own task or thread) copies
+ * ring contents into a LOG_WRITE_BATCH buffer and writes it with one
+ * fwrite().  On the device the file lives on LittleFS (mounted at
+ * /littlefs); on the host it is a plain file.  If the writer falls behind,
+ * whole blocks are dropped and counted, never partial ones.
+ *
+ * Every block stands alone, so when the next one would take a file past
+ * LOG_MAX_FILE_BYTES the writer closes it at that block boundary and goes
+ * on in a new file, named by the caller's DataLogNextPath (on the device
+ * the next NVS sequence number, dropping the oldest log, so the newest
+ * LOG_KEEP_FILES form a rolling window) or, without one, by numbering the
+ * first path (drive.rlog, drive.1.rlog, ...).  Recording stops only when a
+ * file cannot be opened or written.
+ *
+ * File layout (little-endian):
+ *   "RLG1", u8 columns, 3 × pad, then per column f32 scale, f32 offset,
+ *   char name[LOG_NAME_LEN]
+ *   blocks: u32 LOG_BLOCK_MAGIC, u16 rows, u16 pad, u32 payload bytes,
+ *           u32 first timestamp (µs), payload (columns as above)
+ *
+ * tools/rlog_decode.py turns a log into CSV.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "can_signals.h"
+#include "task_signal.h"
+#include "trace.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+
+#define LOG_FILE_MAGIC    "RLG1"
+#define LOG_BLOCK_MAGIC   0x4B4C4252u   // "RBLK"
+#define LOG_NAME_LEN      20
+#define LOG_BLOCK_HEADER  16
+// Worst case: 5-byte varint per timestamp and per value
+#define LOG_BLOCK_MAX_BYTES  (LOG_BLOCK_HEADER + LOG_BLOCK_ROWS * 5 * (1 + SENSOR_LOG_COUNT))
+
+static_assert((LOG_RING_BYTES & (LOG_RING_BYTES - 1)) == 0, "LOG_RING_BYTES must be a power of two");
+static_assert(LOG_RING_BYTES >= 2 * LOG_BLOCK_MAX_BYTES, "LOG_RING_BYTES must hold two worst-case blocks");
+
+static const uint8_t kLogChannels[SENSOR_LOG_COUNT] = SENSOR_LOG_CHANNELS;  // column → channel
+static const uint8_t kLogColumn[SENSOR_CHANNEL_COUNT] = SENSOR_LOG_COLUMN;  // channel → column
+
+/**
+ * Accumulated since the last dataLogReport().  Updated by the decoder and
+ * the writer, read and reset by whoever reports, hence atomic.
+ */
+struct DataLogStats {
+    std::atomic<uint32_t> rows{0};
+    std::atomic<uint32_t> blocks{0};
+    std::atomic<uint32_t> droppedBlocks{0};   // ring full
+    std::atomic<uint32_t> encodedBytes{0};
+    std::atomic<uint32_t> encodeUsMax{0};     // longest block encode on the decoder thread
+    std::atomic<uint32_t> writtenBytes{0};
+    std::atomic<uint32_t> writes{0};
+    std::atomic<uint32_t> writeUs{0};         // total time inside fwrite/fflush
+    std::atomic<uint32_t> writeUsMax{0};
+};
+
+static inline void _logAdd(std::atomic<uint32_t> &a, uint32_t v) {
+    a.fetch_add(v, std::memory_order_relaxed);
+}
+
+static inline void _logMax(std::atomic<uint32_t> &a, uint32_t v) {
+    if (v > a.load(std::memory_order_relaxed)) a.store(v, std::memory_order_relaxed);
+}
+
+/**
+ * Writes the path of the log file to open after a full one into path.
+ * Writer context.  @return false to stop recording instead
+ */
+typedef bool (*DataLogNextPath)(char *path, size_t size);
+
+struct DataLog {
+    std::atomic<bool> recording{false};
+    TaskSignal signal;                         // wakes the writer
+
+    // Decoder side
+    int32_t  cur[SENSOR_LOG_COUNT];            // current raw value of each column
+    uint32_t *ts;                              // staged rows, column-major
+    int32_t  *cols;                            // [column][LOG_BLOCK_ROWS]
+    uint16_t  rows;
+    uint8_t  *scratch;                         // one encoded block
+
+    // Decoder → writer
+    uint8_t              *ring;
+    std::atomic<uint32_t> head{0};             // written by the decoder only
+    std::atomic<uint32_t> tail{0};             // written by the writer only
+
+    // Writer side
+    FILE     *file;
+    uint8_t  *batch;
+    uint64_t  fileBytes;
+    uint32_t  nextBlock;                       // ring position of the first block start >= tail
+    DataLogNextPath nextPath;                  // nullptr: number the first path
+    char      path[64];                        // first file, for the default numbering
+    uint16_t  fileIndex;                       // files opened after the first
+
+    DataLogStats stats;
+};
+
+static DataLog s_dataLog;
+
+static inline void *_logAlloc(size_t bytes) {
+#if defined(ESP_PLATFORM)
+    return heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+#else
+    return malloc(bytes);
+#endif
+}
+
+// ── Encoding ──────────────────────────────────────────────────────────────────
+
+static inline uint8_t *_logPutVarint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static inline uint32_t _logZigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+/** Encode the staged rows into one block and queue it for the writer. */
+static inline void _logSealBlock(DataLog &log) {
+    if (log.rows == 0) return;
+    uint32_t t0 = micros();
+
+    uint8_t *p = log.scratch + LOG_BLOCK_HEADER;
+    for (uint16_t r = 1; r < log.rows; r++) p = _logPutVarint(p, log.ts[r] - log.ts[r - 1]);
+    for (int c = 0; c < SENSOR_LOG_COUNT; c++) {
+        const int32_t *col = log.cols + c * LOG_BLOCK_ROWS;
+        int32_t prev = 0;
+        for (uint16_t r = 0; r < log.rows; r++) {
+            p = _logPutVarint(p, _logZigzag(col[r] - prev));
+            prev = col[r];
+        }
+    }
+    uint32_t payload = (uint32_t)(p - log.scratch) - LOG_BLOCK_HEADER;
+    uint32_t total   = payload + LOG_BLOCK_HEADER;
+    const uint32_t magic = LOG_BLOCK_MAGIC;
+    const uint16_t rows = log.rows, pad = 0;
+    memcpy(log.scratch + 0,  &magic,   4);
+    memcpy(log.scratch + 4,  &rows,    2);
+    memcpy(log.scratch + 6,  &pad,     2);
+    memcpy(log.scratch + 8,  &payload, 4);
+    memcpy(log.scratch + 12, &log.ts[0], 4);
+
+    uint32_t head = log.head.load(std::memory_order_relaxed);
+    uint32_t tail = log.tail.load(std::memory_order_acquire);
+    if (LOG_RING_BYTES - (head - tail) < total) {
+        _logAdd(log.stats.droppedBlocks, 1);
+    } else {
+        uint32_t at    = head & (LOG_RING_BYTES - 1);
+        uint32_t first = LOG_RING_BYTES - at < total ? LOG_RING_BYTES - at : total;
+        memcpy(log.ring + at, log.scratch, first);
+        memcpy(log.ring, log.scratch + first, total - first);
+        log.head.store(head + total, std::memory_order_release);
+        _logAdd(log.stats.blocks, 1);
+        _logAdd(log.stats.encodedBytes, total);
+        if (head + total - tail >= LOG_WRITE_BATCH) log.signal.post(1);
+    }
+    log.rows = 0;
+
+    _logMax(log.stats.encodeUsMax, micros() - t0);
+}
+
+// ── Decoder side ──────────────────────────────────────────────────────────────
+
+/**
+ * Append one row for a decoded frame that carries a logged channel.  ch
+ * holds the message's freshly decoded (unfiltered) values.  Decoder thread
+ * only; a no-op unless recording.
+ */
+static inline void dataLogFrame(const CanMessage &msg, const float *ch, uint32_t tsUs) {
+    DataLog &log = s_dataLog;
+    if (!log.recording.load(std::memory_order_acquire)) return;  // pairs with dataLogBegin()
+
+    bool logged = false;
+    for (unsigned i = msg.firstSignal; i < (unsigned)msg.firstSignal + msg.signalCount; i++) {
+        const CanSignal &s = kCanSignals[i];
+        uint8_t col = kLogColumn[s.channel];
+        if (col == 0xFF) continue;
+        log.cur[col] = (int32_t)lroundf((ch[s.channel] - s.offset) / s.scale);
+        logged = true;
+    }
+    if (!logged) return;
+    if (log.rows > 0 && tsUs - log.ts[0] >= LOG_BLOCK_MAX_MS * 1000u) _logSealBlock(log);
+
+    uint16_t r = log.rows++;
+    log.ts[r] = tsUs;
+    for (int c = 0; c < SENSOR_LOG_COUNT; c++) log.cols[c * LOG_BLOCK_ROWS + r] = log.cur[c];
+    _logAdd(log.stats.rows, 1);
+    if (log.rows == LOG_BLOCK_ROWS) _logSealBlock(log);
+}
+
+// ── Writer side ───────────────────────────────────────────────────────────────
+
+/** Encoded size of the block starting at ring position at (header included). */
+static inline uint32_t _logBlockBytes(const DataLog &log, uint32_t at) {
+    uint8_t payload[4];
+    for (uint32_t i = 0; i < 4; i++) payload[i] = log.ring[(at + 8 + i) & (LOG_RING_BYTES - 1)];
+    uint32_t bytes;
+    memcpy(&bytes, payload, 4);
+    return LOG_BLOCK_HEADER + bytes;
+}
+
+/**
+ * Bytes from tail, at most limit, that end on a block boundary: the rest
+ * of a block already begun (it belongs to this file whatever its size),
+ * then whole blocks.  0 when the next block does not fit.
+ */
+static inline uint32_t _logFit(const DataLog &log, uint32_t tail, uint32_t head, uint32_t limit) {
+    uint32_t end = log.nextBlock;
+    while (end != head) {
+        uint32_t bytes = _logBlockBytes(log, end);
+        if (end + bytes - tail > limit) break;
+        end += bytes;
+    }
+    return end - tail;
+}
+
+/** The signal that carries a channel. */
+static inline const CanSignal &_logSignal(uint8_t ch) {
+    size_t i = 0;
+    while (kCanSignals[i].channel != ch) i++;
+    return kCanSignals[i];
+}
+
+/** Write the file header: magic, column count, each column's scale, offset and name. */
+static inline void _logWriteHeader(DataLog &log) {
+    static const char *const kNames[SENSOR_CHANNEL_COUNT] = SENSOR_CHANNEL_NAMES;
+    uint8_t hdr[4] = { SENSOR_LOG_COUNT, 0, 0, 0 };
+    fwrite(LOG_FILE_MAGIC, 1, 4, log.file);
+    fwrite(hdr, 1, sizeof(hdr), log.file);
+    for (int c = 0; c < SENSOR_LOG_COUNT; c++) {
+        const CanSignal &s = _logSignal(kLogChannels[c]);
+        char name[LOG_NAME_LEN] = {};
+        strncpy(name, kNames[kLogChannels[c]], LOG_NAME_LEN - 1);
+        fwrite(&s.scale, 4, 1, log.file);
+        fwrite(&s.offset, 4, 1, log.file);
+        fwrite(name, 1, LOG_NAME_LEN, log.file);
+    }
+    log.fileBytes = (uint64_t)ftell(log.file);
+}
+
+/**
+ * Close the full file and open the next one with its header.
+ * @return false if there is no next file
+ */
+static inline bool _logRotate(DataLog &log) {
+    fclose(log.file);
+    log.file = nullptr;
+    char path[sizeof(log.path) + 8];
+    if (log.nextPath) {
+        if (!log.nextPath(path, sizeof(path))) return false;
+    } else {
+        // drive.rlog → drive.1.rlog, drive.2.rlog, ...
+        const char *dot   = strrchr(log.path, '.');
+        const char *slash = strrchr(log.path, '/');
+        int stem = dot && (!slash || dot > slash) ? (int)(dot - log.path) : (int)strlen(log.path);
+        snprintf(path, sizeof(path), "%.*s.%u%s", stem, log.path, (unsigned)(log.fileIndex + 1),
+                 log.path + stem);
+    }
+    log.file = fopen(path, "wb");
+    if (!log.file) return false;
+    log.fileIndex++;
+    _logWriteHeader(log);
+    return true;
+}
+
+/**
+ * Move queued blocks to the file in LOG_WRITE_BATCH-sized writes.  With
+ * flush, the remainder is written too.  Writer context only.
+ * @return bytes written
+ */
+static inline uint32_t dataLogPump(bool flush) {
+    DataLog &log = s_dataLog;
+    if (!log.file) return 0;
+    uint32_t written = 0;
+    for (;;) {
+        uint32_t tail = log.tail.load(std::memory_order_relaxed);
+        uint32_t head = log.head.load(std::memory_order_acquire);
+        uint32_t avail = head - tail;
+        if (avail == 0 || (!flush && avail < LOG_WRITE_BATCH)) break;
+        if (avail > LOG_WRITE_BATCH) avail = LOG_WRITE_BATCH;
+        if (log.fileBytes + avail > LOG_MAX_FILE_BYTES) {
+            // Only whole blocks into what is left; the rest starts the next file
+            uint32_t room = log.fileBytes < LOG_MAX_FILE_BYTES ? (uint32_t)(LOG_MAX_FILE_BYTES - log.fileBytes) : 0;
+            avail = _logFit(log, tail, head, room < avail ? room : avail);
+            if (avail == 0) {
+                if (!_logRotate(log)) {
+                    log.recording.store(false);   // no next file: stop, keep what we have
+                    log.tail.store(head, std::memory_order_release);
+                    break;
+                }
+                continue;
+            }
+        }
+
+        uint32_t at    = tail & (LOG_RING_BYTES - 1);
+        uint32_t first = LOG_RING_BYTES - at < avail ? LOG_RING_BYTES - at : avail;
+        memcpy(log.batch, log.ring + at, first);
+        memcpy(log.batch + first, log.ring, avail - first);
+        // Block sizes are read before the decoder may reuse the space
+        while ((int32_t)(tail + avail - log.nextBlock) > 0) log.nextBlock += _logBlockBytes(log, log.nextBlock);
+        log.tail.store(tail + avail, std::memory_order_release);
+
+        TRACE_SCOPE("log write");
+        uint32_t t0 = micros();
+        size_t n = fwrite(log.batch, 1, avail, log.file);
+        fflush(log.file);
+        uint32_t us = micros() - t0;
+
+        log.fileBytes += n;
+        _logAdd(log.stats.writtenBytes, (uint32_t)n);
+        _logAdd(log.stats.writes, 1);
+        _logAdd(log.stats.writeUs, us);
+        _logMax(log.stats.writeUsMax, us);
+        written += (uint32_t)n;
+        if (n != avail) {
+            log.recording.store(false);       // out of space or I/O error
+            break;
+        }
+    }
+    return written;
+}
+
+/**
+ * Writer loop body: sleep until a batch is ready or LOG_FLUSH_MS passed,
+ * then write.  Bounds what a power loss can take to LOG_FLUSH_MS plus the
+ * staged block.
+ */
+static inline void dataLogWriterStep(void) {
+    uint32_t bits = s_dataLog.signal.wait(LOG_FLUSH_MS);
+    dataLogPump(bits == 0);
+}
+
+// ── Statistics ────────────────────────────────────────────────────────────────
+
+/** Throughput and latency since the previous call. */
+struct DataLogReport {
+    uint32_t rowsPerSec;
+    uint32_t bytesPerSec;        // written to the file system, sustained
+    uint32_t writeKBps;          // while inside fwrite (device write speed)
+    float    bytesPerRow;        // after encoding
+    uint32_t droppedBlocks;
+    uint32_t writeUsMax;         // longest single batch write (writer thread)
+    uint32_t encodeUsMax;        // longest block encode (decoder thread)
+};
+
+/** Summarise and reset the statistics window of periodMs. */
+static inline DataLogReport dataLogReport(uint32_t periodMs) {
+    DataLogStats &st = s_dataLog.stats;
+    uint32_t rows    = st.rows.exchange(0);
+    uint32_t encoded = st.encodedBytes.exchange(0);
+    uint32_t written = st.writtenBytes.exchange(0);
+    uint32_t writeUs = st.writeUs.exchange(0);
+    st.blocks.store(0);
+    st.writes.store(0);
+
+    DataLogReport r = {};
+    if (periodMs) {
+        r.rowsPerSec  = (uint32_t)((uint64_t)rows * 1000u / periodMs);
+        r.bytesPerSec = (uint32_t)((uint64_t)written * 1000u / periodMs);
+    }
+    r.writeKBps     = writeUs ? (uint32_t)((uint64_t)written * 1000u / writeUs) : 0;
+    r.bytesPerRow   = rows ? (float)encoded / rows : 0.0f;
+    r.droppedBlocks = st.droppedBlocks.exchange(0);
+    r.writeUsMax    = st.writeUsMax.exchange(0);
+    r.encodeUsMax   = st.encodeUsMax.exchange(0);
+    return r;
+}
+
+// ── Control ───────────────────────────────────────────────────────────────────
+
+/**
+ * Allocate the buffers, create path and write the file header, then start
+ * recording.  Full files continue in the files next names (nullptr:
+ * numbered after path).  Call before the decoder starts, or while it runs
+ * with recording off: the release store of recording publishes the
+ * buffers to dataLogFrame().  On the device call it from the writer task
+ * after signal.bindCurrentTask() – posts to an unbound TaskSignal are lost,
+ * and the writer would only see the ring on its LOG_FLUSH_MS timeout.
+ * The host signal keeps its bits, so any thread may call it there.
+ * @return false if memory or the file could not be had
+ */
+static inline bool dataLogBegin(const char *path, DataLogNextPath next = nullptr) {
+    DataLog &log = s_dataLog;
+    if (!log.ring) {
+        log.ring    = (uint8_t *)_logAlloc(LOG_RING_BYTES);
+        log.batch   = (uint8_t *)_logAlloc(LOG_WRITE_BATCH);
+        log.scratch = (uint8_t *)_logAlloc(LOG_BLOCK_MAX_BYTES);
+        log.ts      = (uint32_t *)_logAlloc(LOG_BLOCK_ROWS * sizeof(uint32_t));
+        log.cols    = (int32_t *)_logAlloc(LOG_BLOCK_ROWS * SENSOR_LOG_COUNT * sizeof(int32_t));
+        if (!log.ring || !log.batch || !log.scratch || !log.ts || !log.cols) return false;
+    }
+    log.file = fopen(path, "wb");
+    if (!log.file) return false;
+
+    _logWriteHeader(log);
+    strncpy(log.path, path, sizeof(log.path) - 1);
+    log.path[sizeof(log.path) - 1] = '\0';
+    log.nextPath  = next;
+    log.fileIndex = 0;
+
+    static const float kDefaults[SENSOR_CHANNEL_COUNT] = SENSOR_CHANNEL_DEFAULTS;
+    for (int c = 0; c < SENSOR_LOG_COUNT; c++) {
+        const CanSignal &s = _logSignal(kLogChannels[c]);
+        log.cur[c] = (int32_t)lroundf((kDefaults[kLogChannels[c]] - s.offset) / s.scale);
+    }
+    log.rows = 0;
+    log.head.store(0);
+    log.tail.store(0);
+    log.nextBlock = 0;
+    dataLogReport(0);                          // clear the statistics
+    log.recording.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Stop recording, write the staged rows and everything queued, and close
+ * the file.  Call once the decoder has stopped (its staging block is
+ * sealed here); writer context otherwise.
+ */
+static inline void dataLogEnd(void) {
+    DataLog &log = s_dataLog;
+    log.recording.store(false);
+    _logSealBlock(log);
+    dataLogPump(true);
+    if (log.file) fclose(log.file);
+    log.file = nullptr;
+}
@@ -0,0 +1,115 @@
+/**
+ * dial_face.h
+ * Static dial faces rasterized once into a cached canvas.
+ *
+ * Tick marks, numerals and scale arcs never move, yet as individual
+ * (rotated) LVGL objects they are re-rendered – through a transform layer –
+ * every time a hand or needle passing over them invalidates the area.
+ * dialFaceCreate() instead paints the whole face once, at screen creation,
+ * into an RGB565 canvas whose pixels live in PSRAM.  Afterwards a redraw
+ * under a moving hand is a plain image copy out of that buffer, and the
+ * face costs one object instead of dozens.
+ *
+ * The paint callback receives a layer in canvas coordinates (0..size-1) and
+ * uses the lv_draw_* primitives directly.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <stdlib.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+
+/** Paint a dial face of size×size pixels into layer. */
+typedef void (*DialPaintFn)(lv_layer_t *layer, int32_t size);
+
+static void *_dialFaceAlloc(size_t bytes) {
+#if defined(ESP_PLATFORM)
+    return heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+#else
+    return malloc(bytes);
+#endif
+}
+
+static void _dialFaceFree(void *p) {
+#if defined(ESP_PLATFORM)
+    heap_caps_free(p);
+#else
+    free(p);
+#endif
+}
+
+static void _dialFaceDeleteCb(lv_event_t *e) {
+    _dialFaceFree(lv_event_get_user_data(e));
+}
+
+/**
+ * Create a size×size canvas centred on parent, fill it with bg and let paint
+ * draw the face into it.  The pixel buffer is freed with the canvas.
+ *
+ * @return the canvas, or nullptr if the buffer could not be allocated
+ */
+static lv_obj_t *dialFaceCreate(lv_obj_t *parent, int32_t size, lv_color_t bg,
+                                DialPaintFn paint) {
+    uint32_t stride = lv_draw_buf_width_to_stride(size, LV_COLOR_FORMAT_RGB565);
+    void *buf = _dialFaceAlloc((size_t)stride * size);
+    if (!buf) {
+        LV_LOG_WARN("dial face: no memory for %dx%d buffer", (int)size, (int)size);
+        return nullptr;
+    }
+
+    lv_obj_t *canvas = lv_canvas_create(parent);
+    lv_canvas_set_buffer(canvas, buf, size, size, LV_COLOR_FORMAT_RGB565);
+    lv_obj_add_event_cb(canvas, _dialFaceDeleteCb, LV_EVENT_DELETE, buf);
+    lv_obj_clear_flag(canvas, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_align(canvas, LV_ALIGN_CENTER, 0, 0);
+    lv_canvas_fill_bg(canvas, bg, LV_OPA_COVER);
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(canvas, &layer);
+    paint(&layer, size);
+    lv_canvas_finish_layer(canvas, &layer);
+    return canvas;
+}
+
+// ── Paint helpers ─────────────────────────────────────────────────────────────
+
+/** Radial line from rInner to rOuter at angleDeg (0° = 3 o'clock, clockwise). */
+static void dialPaintRadial(lv_layer_t *layer, int32_t cx, int32_t cy,
+                            int32_t rInner, int32_t rOuter, int32_t angleDeg,
+                            int32_t width, lv_color_t color) {
+    int32_t s = lv_trigo_sin((int16_t)angleDeg);
+    int32_t c = lv_trigo_cos((int16_t)angleDeg);
+    lv_draw_line_dsc_t d;
+    lv_draw_line_dsc_init(&d);
+    d.color       = color;
+    d.width       = width;
+    d.round_start = 1;
+    d.round_end   = 1;
+    d.p1.x = cx + ((c * rInner) >> LV_TRIGO_SHIFT);
+    d.p1.y = cy + ((s * rInner) >> LV_TRIGO_SHIFT);
+    d.p2.x = cx + ((c * rOuter) >> LV_TRIGO_SHIFT);
+    d.p2.y = cy + ((s * rOuter) >> LV_TRIGO_SHIFT);
+    lv_draw_line(layer, &d);
+}
+
+/**
+ * Text centred on (x, y).  Drawing is deferred until the canvas layer is
+ * finished, so text must be a string literal or otherwise outlive
+ * dialFaceCreate().
+ */
+static void dialPaintText(lv_layer_t *layer, int32_t x, int32_t y, const char *text,
+                          const lv_font_t *font, lv_color_t color) {
+    lv_draw_label_dsc_t d;
+    lv_draw_label_dsc_init(&d);
+    d.color = color;
+    d.font  = font;
+    d.align = LV_TEXT_ALIGN_CENTER;
+    d.text  = text;
+    int32_t h = lv_font_get_line_height(font);
+    lv_area_t a = { x - 40, y - h / 2, x + 40, y - h / 2 + h - 1 };
+    lv_draw_label(layer, &d, &a);
+}
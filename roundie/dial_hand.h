@@ -0,0 +1,121 @@
+/**
+ * dial_hand.h
+ * Clock hands and gauge needles drawn as anti-aliased lines.
+ *
+ * A DialHandSet is one transparent host object covering the dial.  Its
+ * LV_EVENT_DRAW_MAIN handler draws every hand with lv_draw_line, straight
+ * into the frame – no per-hand object, no style transform, no intermediate
+ * transform layer.
+ *
+ * Moving a hand invalidates only its old and new footprints, and each
+ * footprint is not the segment's bounding box but a short chain of boxes
+ * along it (one per DIAL_HAND_CHUNK_PX of length), so a diagonal hand dirties
+ * a thin strip instead of a square.  A move that lands on the same rounded
+ * end points invalidates nothing.
+ *
+ * Angles are in degrees, 0° = 3 o'clock, clockwise (the LVGL convention),
+ * and may be fractional so hands can sweep smoothly.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <math.h>
+
+#define DIAL_HANDS_MAX      4
+#define DIAL_HAND_CHUNK_PX  40   // footprint box length along a hand
+
+struct DialHand {
+    int32_t    length;     // pivot → tip
+    int32_t    tail;       // pivot → back end (0 = starts at the pivot)
+    int32_t    width;
+    lv_color_t color;
+    lv_point_t p1, p2;     // current end points, screen coordinates
+};
+
+struct DialHandSet {
+    lv_obj_t *obj;
+    int32_t   cx, cy;      // pivot, screen coordinates
+    uint8_t   count;
+    DialHand  hands[DIAL_HANDS_MAX];
+};
+
+static void _dialHandsDrawCb(lv_event_t *e) {
+    DialHandSet *set = (DialHandSet *)lv_event_get_user_data(e);
+    lv_layer_t *layer = lv_event_get_layer(e);
+    lv_draw_line_dsc_t d;
+    lv_draw_line_dsc_init(&d);
+    d.round_start = 1;
+    d.round_end   = 1;
+    for (uint8_t i = 0; i < set->count; i++) {
+        const DialHand &h = set->hands[i];
+        d.color = h.color;
+        d.width = h.width;
+        d.p1.x = h.p1.x;  d.p1.y = h.p1.y;
+        d.p2.x = h.p2.x;  d.p2.y = h.p2.y;
+        lv_draw_line(layer, &d);
+    }
+}
+
+/** Invalidate the strip of boxes covering hand h's current segment. */
+static void _dialHandInvalidate(DialHandSet &set, const DialHand &h) {
+    int32_t dx = h.p2.x - h.p1.x, dy = h.p2.y - h.p1.y;
+    int32_t span = LV_MAX(LV_ABS(dx), LV_ABS(dy));
+    int32_t chunks = span / DIAL_HAND_CHUNK_PX + 1;
+    int32_t pad = h.width / 2 + 2;   // half width + anti-aliasing fringe
+    for (int32_t i = 0; i < chunks; i++) {
+        int32_t xa = h.p1.x + dx * i / chunks,       ya = h.p1.y + dy * i / chunks;
+        int32_t xb = h.p1.x + dx * (i + 1) / chunks, yb = h.p1.y + dy * (i + 1) / chunks;
+        lv_area_t a = { LV_MIN(xa, xb) - pad, LV_MIN(ya, yb) - pad,
+                        LV_MAX(xa, xb) + pad, LV_MAX(ya, yb) + pad };
+        lv_obj_invalidate_area(set.obj, &a);
+    }
+}
+
+/**
+ * Create the host object for a set of hands pivoting on (cx, cy), covering
+ * a circle of the given radius.  Hands are drawn in the order added.
+ */
+static lv_obj_t *dialHandsCreate(DialHandSet &set, lv_obj_t *parent,
+                                 int32_t cx, int32_t cy, int32_t radius) {
+    set.cx    = cx;
+    set.cy    = cy;
+    set.count = 0;
+    set.obj   = lv_obj_create(parent);
+    lv_obj_remove_style_all(set.obj);
+    lv_obj_clear_flag(set.obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_pos(set.obj, cx - radius, cy - radius);
+    lv_obj_set_size(set.obj, 2 * radius + 1, 2 * radius + 1);
+    lv_obj_add_event_cb(set.obj, _dialHandsDrawCb, LV_EVENT_DRAW_MAIN, &set);
+    return set.obj;
+}
+
+/** Add a hand pointing at 0°.  @return its index, or -1 if the set is full */
+static int dialHandAdd(DialHandSet &set, int32_t length, int32_t tail, int32_t width,
+                       lv_color_t color) {
+    if (set.count >= DIAL_HANDS_MAX) return -1;
+    DialHand &h = set.hands[set.count];
+    h.length = length;
+    h.tail   = tail;
+    h.width  = width;
+    h.color  = color;
+    h.p1 = { set.cx - tail,   set.cy };
+    h.p2 = { set.cx + length, set.cy };
+    _dialHandInvalidate(set, h);
+    return set.count++;
+}
+
+/** Point hand idx at angleDeg; invalidates nothing if its pixels are unchanged. */
+static void dialHandSetAngle(DialHandSet &set, int idx, float angleDeg) {
+    DialHand &h = set.hands[idx];
+    float rad = angleDeg * (float)M_PI / 180.0f;
+    float c = cosf(rad), s = sinf(rad);
+    lv_point_t p1 = { set.cx - (int32_t)lroundf(c * h.tail),   set.cy - (int32_t)lroundf(s * h.tail) };
+    lv_point_t p2 = { set.cx + (int32_t)lroundf(c * h.length), set.cy + (int32_t)lroundf(s * h.length) };
+    if (p1.x == h.p1.x && p1.y == h.p1.y && p2.x == h.p2.x && p2.y == h.p2.y) return;
+
+    _dialHandInvalidate(set, h);   // old footprint
+    h.p1 = p1;
+    h.p2 = p2;
+    _dialHandInvalidate(set, h);   // new footprint
+}
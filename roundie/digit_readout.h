@@ -0,0 +1,256 @@
+/**
+ * digit_readout.h
+ * Large fixed-point numeric readouts drawn from a pre-rasterized digit atlas.
+ *
+ * A label showing a number re-formats it through the printf machinery,
+ * re-measures the text and redraws the whole label box on every change,
+ * and its size is limited to the fonts compiled in.  A DigitReadout
+ * instead shows a fixed-point integer in a fixed row of digit cells:
+ *
+ *   - digitAtlasCreate() paints the glyphs 0–9 and '-' once, at screen
+ *     creation, as bold anti-aliased seven-segment digits of any size into
+ *     an RGB565 buffer in PSRAM (one image per glyph, stacked), with the
+ *     background colour baked in as dial_face.h does;
+ *   - digitReadoutSet() splits the value into glyph indices with integer
+ *     division – no snprintf, no string, no heap – and invalidates only
+ *     the cells whose glyph changed;
+ *   - the draw handler copies each visible cell's glyph image into the
+ *     frame.  The decimal point is a fixed dot between the cells.
+ *
+ * So a boost reading going from 123.4 to 123.5 redraws one digit cell.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ui_update.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+
+#define DIGIT_GLYPHS        11     // 0–9, then '-'
+#define DIGIT_GLYPH_MINUS   10
+#define DIGIT_BLANK         0xFF   // empty cell
+#define DIGIT_READOUT_MAX   6      // cells per readout
+
+/** Glyph images of one size and colour, sharing one pixel buffer. */
+struct DigitAtlas {
+    int32_t        cellW, cellH;
+    int32_t        stroke;
+    lv_color_t     fg;
+    uint8_t       *buf;
+    lv_image_dsc_t glyph[DIGIT_GLYPHS];
+};
+
+/** A row of digit cells showing a fixed-point value. */
+struct DigitReadout {
+    lv_obj_t         *obj;
+    const DigitAtlas *atlas;
+    uint8_t           cells;      // total digit cells
+    uint8_t           decimals;   // cells after the point (0 = no point)
+    int32_t           gap;        // pixels between cells
+    int32_t           pointW;     // width reserved for the point
+    int32_t           value;      // shown value (INT32_MIN = none yet)
+    uint8_t           glyph[DIGIT_READOUT_MAX];   // shown glyph per cell
+};
+
+// Seven segments a–g as bits 0–6 of each glyph
+static const uint8_t kDigitSegments[DIGIT_GLYPHS] = {
+    0x3F, 0x06, 0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F,   // 0–9
+    0x40                                                            // '-'
+};
+
+static void *_digitAlloc(size_t bytes) {
+#if defined(ESP_PLATFORM)
+    return heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+#else
+    return malloc(bytes);
+#endif
+}
+
+// ── Atlas ─────────────────────────────────────────────────────────────────────
+
+/** Paint the segments of glyph g into a cell whose top-left is (0, y). */
+static void _digitPaintGlyph(lv_layer_t *layer, const DigitAtlas &a, int g, int32_t y) {
+    const int32_t m  = a.stroke / 2 + 1;                 // keep round caps inside the cell
+    const int32_t x0 = m, x1 = a.cellW - 1 - m;
+    const int32_t y0 = y + m, ym = y + a.cellH / 2, y1 = y + a.cellH - 1 - m;
+    const int32_t seg[7][4] = {
+        { x0, y0, x1, y0 },   // a  top
+        { x1, y0, x1, ym },   // b  top right
+        { x1, ym, x1, y1 },   // c  bottom right
+        { x0, y1, x1, y1 },   // d  bottom
+        { x0, ym, x0, y1 },   // e  bottom left
+        { x0, y0, x0, ym },   // f  top left
+        { x0, ym, x1, ym },   // g  middle
+    };
+    lv_draw_line_dsc_t d;
+    lv_draw_line_dsc_init(&d);
+    d.color       = a.fg;
+    d.width       = a.stroke;
+    d.round_start = 1;
+    d.round_end   = 1;
+    for (int s = 0; s < 7; s++) {
+        if (!(kDigitSegments[g] & (1u << s))) continue;
+        d.p1.x = seg[s][0];  d.p1.y = seg[s][1];
+        d.p2.x = seg[s][2];  d.p2.y = seg[s][3];
+        lv_draw_line(layer, &d);
+    }
+}
+
+/**
+ * Rasterize the glyphs in cellW×cellH cells with segments stroke pixels
+ * wide, fg on bg.  Uses a temporary canvas on parent; the pixel buffer is
+ * kept for the life of the program.
+ * @return false if the buffer could not be allocated
+ */
+static bool digitAtlasCreate(DigitAtlas &a, lv_obj_t *parent, int32_t cellW, int32_t cellH,
+                             int32_t stroke, lv_color_t fg, lv_color_t bg) {
+    const int32_t  h      = cellH * DIGIT_GLYPHS;
+    const uint32_t stride = lv_draw_buf_width_to_stride(cellW, LV_COLOR_FORMAT_RGB565);
+    a.cellW  = cellW;
+    a.cellH  = cellH;
+    a.stroke = stroke;
+    a.fg     = fg;
+    a.buf    = (uint8_t *)_digitAlloc((size_t)stride * h);
+    if (!a.buf) {
+        LV_LOG_WARN("digit atlas: no memory for %dx%d buffer", (int)cellW, (int)h);
+        return false;
+    }
+
+    lv_obj_t *canvas = lv_canvas_create(parent);
+    lv_canvas_set_buffer(canvas, a.buf, cellW, h, LV_COLOR_FORMAT_RGB565);
+    lv_canvas_fill_bg(canvas, bg, LV_OPA_COVER);
+    lv_layer_t layer;
+    lv_canvas_init_layer(canvas, &layer);
+    for (int g = 0; g < DIGIT_GLYPHS; g++) _digitPaintGlyph(&layer, a, g, g * cellH);
+    lv_canvas_finish_layer(canvas, &layer);
+    lv_obj_delete(canvas);                               // the buffer is ours, not the canvas's
+
+    for (int g = 0; g < DIGIT_GLYPHS; g++) {
+        lv_image_dsc_t &img = a.glyph[g];
+        memset(&img, 0, sizeof(img));
+        img.header.magic  = LV_IMAGE_HEADER_MAGIC;
+        img.header.cf     = LV_COLOR_FORMAT_RGB565;
+        img.header.w      = cellW;
+        img.header.h      = cellH;
+        img.header.stride = stride;
+        img.data_size     = stride * cellH;
+        img.data          = a.buf + (size_t)stride * cellH * g;
+    }
+    return true;
+}
+
+// ── Readout ───────────────────────────────────────────────────────────────────
+
+/**
+ * Left edge of cell i relative to the readout.  The point, when there is
+ * one, is centred in the gap plus pointW pixels before the first decimal
+ * cell.
+ */
+static int32_t _digitCellX(const DigitReadout &r, int i) {
+    int32_t x = i * (r.atlas->cellW + r.gap);
+    if (r.decimals && i >= r.cells - r.decimals) x += r.pointW;
+    return x;
+}
+
+static void _digitReadoutDrawCb(lv_event_t *e) {
+    const DigitReadout *r = (const DigitReadout *)lv_event_get_user_data(e);
+    lv_layer_t *layer = lv_event_get_layer(e);
+    lv_area_t c;
+    lv_obj_get_coords(r->obj, &c);
+
+    lv_draw_image_dsc_t img;
+    lv_draw_image_dsc_init(&img);
+    for (int i = 0; i < r->cells; i++) {
+        if (r->glyph[i] == DIGIT_BLANK) continue;
+        int32_t x = c.x1 + _digitCellX(*r, i);
+        lv_area_t a = { x, c.y1, x + r->atlas->cellW - 1, c.y1 + r->atlas->cellH - 1 };
+        img.src = &r->atlas->glyph[r->glyph[i]];
+        lv_draw_image(layer, &img, &a);
+    }
+    if (r->decimals && r->value != INT32_MIN) {
+        int32_t d  = r->atlas->stroke + 2;
+        int32_t x  = c.x1 + _digitCellX(*r, r->cells - r->decimals) - (r->pointW + r->gap) / 2 - d / 2;
+        int32_t y  = c.y1 + r->atlas->cellH - 1 - d;
+        lv_area_t a = { x, y, x + d - 1, y + d - 1 };
+        lv_draw_rect_dsc_t dot;
+        lv_draw_rect_dsc_init(&dot);
+        dot.bg_color = r->atlas->fg;
+        dot.bg_opa   = LV_OPA_COVER;
+        dot.radius   = LV_RADIUS_CIRCLE;
+        lv_draw_rect(layer, &dot, &a);
+    }
+}
+
+/**
+ * Create a readout of cells digit cells, the last decimals of them after a
+ * decimal point, drawn from atlas (which must outlive it).  Position it
+ * with the usual lv_obj calls; it is blank until the first digitReadoutSet().
+ * @return the readout object, or nullptr if the atlas has no glyphs
+ */
+static lv_obj_t *digitReadoutCreate(DigitReadout &r, lv_obj_t *parent, const DigitAtlas &atlas,
+                                    uint8_t cells, uint8_t decimals) {
+    r.obj      = nullptr;
+    if (!atlas.buf) return nullptr;
+    r.atlas    = &atlas;
+    r.cells    = cells < DIGIT_READOUT_MAX ? cells : DIGIT_READOUT_MAX;
+    r.decimals = decimals < r.cells ? decimals : r.cells - 1;
+    r.gap      = atlas.stroke / 2 + 2;
+    r.pointW   = r.decimals ? atlas.stroke + 2 * r.gap : 0;
+    r.value    = INT32_MIN;
+    memset(r.glyph, DIGIT_BLANK, sizeof(r.glyph));
+
+    r.obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(r.obj);
+    lv_obj_clear_flag(r.obj, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_size(r.obj, _digitCellX(r, r.cells - 1) + atlas.cellW, atlas.cellH);
+    lv_obj_add_event_cb(r.obj, _digitReadoutDrawCb, LV_EVENT_DRAW_MAIN, &r);
+    return r.obj;
+}
+
+/** Invalidate cell i (or the point with i = -1) in screen coordinates. */
+static void _digitInvalidateCell(const DigitReadout &r, int i) {
+    lv_area_t c;
+    lv_obj_get_coords(r.obj, &c);
+    int32_t x = c.x1 + (i < 0 ? _digitCellX(r, r.cells - r.decimals) - r.pointW - r.gap
+                              : _digitCellX(r, i));
+    int32_t w = i < 0 ? r.pointW + r.gap : r.atlas->cellW;
+    lv_area_t a = { x, c.y1, x + w - 1, c.y1 + r.atlas->cellH - 1 };
+    lv_obj_invalidate_area(r.obj, &a);
+}
+
+/**
+ * Show value, a fixed-point number with the readout's decimals (e.g. 1234
+ * with one decimal shows "123.4").  Integer digits are right-aligned with
+ * leading blanks and at least one digit before the point; a value that
+ * does not fit shows '-' in every cell.  Only changed cells are redrawn.
+ */
+static void digitReadoutSet(DigitReadout &r, int32_t value) {
+    if (!r.obj || (s_uiDirtyCheck && value == r.value)) return;
+    bool first = r.value == INT32_MIN;
+
+    uint8_t  g[DIGIT_READOUT_MAX];
+    uint32_t mag = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    int      i   = r.cells - 1;
+    int      minDigits = r.decimals + 1;
+    for (; i >= 0 && (mag || r.cells - 1 - i < minDigits); i--) {
+        g[i] = (uint8_t)(mag % 10);
+        mag /= 10;
+    }
+    bool fits = mag == 0 && (value >= 0 || i >= 0);
+    if (value < 0 && i >= 0) g[i--] = DIGIT_GLYPH_MINUS;
+    for (; i >= 0; i--) g[i] = DIGIT_BLANK;
+    if (!fits) memset(g, DIGIT_GLYPH_MINUS, r.cells);
+
+    for (int c = 0; c < r.cells; c++) {
+        if (g[c] == r.glyph[c] && s_uiDirtyCheck) continue;
+        r.glyph[c] = g[c];
+        _digitInvalidateCell(r, c);
+    }
+    r.value = value;
+    if (first && r.decimals) _digitInvalidateCell(r, -1);
+}
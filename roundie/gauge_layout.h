@@ -0,0 +1,514 @@
+/**
+ * gauge_layout.h
+ * Gauge screens described by a compact binary layout instead of code.
+ *
+ * Every hand-written screen repeats the same create / style / align calls
+ * with different numbers.  A layout is those numbers as data: a list of
+ * fixed-size widget records, compiled on the host by tools/gauge2rgl.py
+ * from a readable text file (tools/engine.gauge) into an .rgl blob:
+ *
+ *   GaugeLayoutHeader   16 bytes: magic "RGL1", version, record count,
+ *                       string table size, channel-set hash, background
+ *   GaugeWidgetRec[n]   56 bytes each, in draw order
+ *   string table        NUL-terminated TEXT strings, referenced by offset
+ *
+ * All fields are little-endian, as on the ESP32-S3 and every host the
+ * simulator runs on.  gaugeLayoutLoad() validates the blob once – sizes,
+ * kinds, channel and unit ids, ranges, string offsets – and copies it into
+ * a GaugeLayout.  gaugeViewCreate() then instantiates it in one pass over
+ * the records, with no text parsing on the device:
+ *
+ *   ARC      lv_arc bound to a channel (UiArc)
+ *   NEEDLE   dial_hand.h hand bound to a channel (UiNeedle); needles with
+ *            the same pivot share one host object
+ *   SCALE    ticks and numerals painted into a cached dial face
+ *   READOUT  digit_readout.h seven-segment readout bound to a channel
+ *   TEXT     static label from the string table
+ *   UNIT     label showing a channel's display unit
+ *
+ * Channels are bound by index into SensorChannel.  The blob carries a hash
+ * of the channel names it was compiled against, so a layout built for a
+ * different signal table is rejected instead of showing the wrong data.
+ * Ranges are stored per UnitSystem in display units; the compiler checks
+ * that each unit matches the channel's dimension (the job the Quantity
+ * types do for hand-written screens), and gaugeViewApplyUnits() folds unit
+ * and widget resolution into one mul/add per widget, as GaugeMap does.
+ *
+ * Requires LVGL 9.x.  UI task only.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "can_handler.h"
+#include "unit_convert.h"
+#include "dial_face.h"
+#include "digit_readout.h"
+#include "ui_update.h"
+
+#define GAUGE_LAYOUT_MAGIC     0x314C4752u   // "RGL1" read little-endian
+#define GAUGE_LAYOUT_VERSION   1
+#define GAUGE_MAX_WIDGETS      24
+#define GAUGE_MAX_TEXT         512           // string table bytes
+#define GAUGE_MAX_HAND_SETS    2             // distinct needle pivots
+#define GAUGE_MAX_ATLASES      2             // distinct readout digit styles
+#define GAUGE_MAX_TICKS        121           // per SCALE
+#define GAUGE_MAX_NUMERALS     25            // major ticks per SCALE
+#define GAUGE_VALUE_RES        100           // ARC / NEEDLE steps per display unit
+#define GAUGE_NO_CHANNEL       0xFF
+
+/** Widget record kinds. */
+enum GaugeKind : uint8_t {
+    GAUGE_ARC = 1,
+    GAUGE_NEEDLE,
+    GAUGE_SCALE,
+    GAUGE_READOUT,
+    GAUGE_TEXT,
+    GAUGE_UNIT,
+    GAUGE_KIND_END
+};
+
+/** Display units a record may use; same order as UNITS in gauge2rgl.py. */
+enum GaugeUnit : uint8_t {
+    GAUGE_UNIT_RAW = 0,    // channel value as decoded
+    GAUGE_UNIT_KPA,
+    GAUGE_UNIT_BAR,
+    GAUGE_UNIT_PSI,
+    GAUGE_UNIT_C,
+    GAUGE_UNIT_F,
+    GAUGE_UNIT_LAMBDA,
+    GAUGE_UNIT_AFR,
+    GAUGE_UNIT_RPM,
+    GAUGE_UNIT_KRPM,
+    GAUGE_UNIT_COUNT
+};
+
+/** A display unit with its dimension erased: display = base × scale + offset. */
+struct GaugeUnitScale {
+    const char *label;
+    float       scale, offset;
+};
+
+template <typename Tag>
+constexpr GaugeUnitScale _gaugeUnit(const Unit<Tag> &u) {
+    return GaugeUnitScale{ u.label, u.scale, u.offset };
+}
+
+static constexpr GaugeUnitScale kGaugeUnits[GAUGE_UNIT_COUNT] = {
+    { "", 1.0f, 0.0f },
+    _gaugeUnit(kUnitKPa),    _gaugeUnit(kUnitBar),        _gaugeUnit(kUnitPsi),
+    _gaugeUnit(kUnitCelsius), _gaugeUnit(kUnitFahrenheit),
+    _gaugeUnit(kUnitLambda), _gaugeUnit(kUnitAFR),
+    _gaugeUnit(kUnitRpm),    _gaugeUnit(kUnitKRpm),
+};
+
+// ── Binary format ─────────────────────────────────────────────────────────────
+
+struct GaugeLayoutHeader {
+    uint32_t magic;         // GAUGE_LAYOUT_MAGIC
+    uint8_t  version;       // GAUGE_LAYOUT_VERSION
+    uint8_t  count;         // widget records
+    uint16_t textBytes;     // string table size
+    uint32_t channelHash;   // gaugeChannelHash() of the compiling signal table
+    uint32_t bg;            // screen background, 0xRRGGBB
+};
+
+/** One widget.  Field meanings depend on kind, as noted. */
+struct GaugeWidgetRec {
+    uint8_t  kind;                       // GaugeKind
+    uint8_t  channel;                    // SensorChannel, GAUGE_NO_CHANNEL for TEXT
+    uint8_t  unit[UNIT_SYSTEM_COUNT];    // GaugeUnit per UnitSystem
+    int16_t  x, y;                       // centre offset from the screen centre, px
+    int16_t  size;                       // ARC/SCALE diameter, NEEDLE length, READOUT cell width
+    int16_t  aux;                        // ARC width, NEEDLE tail, READOUT cell height,
+                                         // SCALE minor ticks per major
+    int16_t  start, sweep;               // degrees, 0° = 3 o'clock, clockwise
+    uint8_t  stroke;                     // NEEDLE / SCALE tick / READOUT segment width
+    uint8_t  digits;                     // READOUT cells
+    uint8_t  decimals;                   // READOUT and SCALE numeral decimals
+    uint8_t  font;                       // TEXT / UNIT / SCALE numerals: 8, 16, 0 = default
+    uint32_t color;                      // 0xRRGGBB
+    uint32_t color2;                     // ARC track, SCALE rim
+    uint16_t text;                       // TEXT string table offset
+    uint16_t reserved;
+    float    lo[UNIT_SYSTEM_COUNT];      // range in display units
+    float    hi[UNIT_SYSTEM_COUNT];
+    float    step[UNIT_SYSTEM_COUNT];    // SCALE minor tick spacing in display units
+};
+
+static_assert(sizeof(GaugeLayoutHeader) == 16, "layout header must match gauge2rgl.py");
+static_assert(sizeof(GaugeWidgetRec) == 56, "widget record must match gauge2rgl.py");
+
+/** A validated layout, copied out of its blob. */
+struct GaugeLayout {
+    GaugeLayoutHeader hdr;
+    GaugeWidgetRec    w[GAUGE_MAX_WIDGETS];
+    char              text[GAUGE_MAX_TEXT];
+    SensorMask        channels;          // bound channels
+};
+
+/** FNV-1a over the channel names, each with its terminating NUL. */
+static uint32_t gaugeChannelHash(void) {
+    static const char *const kNames[SENSOR_CHANNEL_COUNT] = SENSOR_CHANNEL_NAMES;
+    uint32_t h = 2166136261u;
+    for (int ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++) {
+        const char *s = kNames[ch];
+        do { h = (h ^ (uint8_t)*s) * 16777619u; } while (*s++);
+    }
+    return h;
+}
+
+static const char *_gaugeCheckRec(const GaugeLayout &L, const GaugeWidgetRec &r) {
+    if (r.kind < GAUGE_ARC || r.kind >= GAUGE_KIND_END) return "unknown widget kind";
+    // Every kind: gaugeViewApplyUnits() looks up kGaugeUnits for all records
+    for (int us = 0; us < UNIT_SYSTEM_COUNT; us++) {
+        if (r.unit[us] >= GAUGE_UNIT_COUNT) return "unit out of range";
+    }
+    if (r.kind == GAUGE_TEXT) {
+        if (r.channel != GAUGE_NO_CHANNEL) return "text bound to a channel";
+        if (r.text >= L.hdr.textBytes) return "text offset outside the string table";
+        return nullptr;
+    }
+    if (r.channel >= SENSOR_CHANNEL_COUNT) return "channel out of range";
+    if (r.channel >= SENSOR_DISPLAY_COUNT) return "channel not displayed (no @tune line)";
+    for (int us = 0; us < UNIT_SYSTEM_COUNT; us++) {
+        if (r.kind == GAUGE_UNIT || r.kind == GAUGE_READOUT) continue;
+        if (!(r.hi[us] > r.lo[us])) return "empty range";
+        if (r.kind == GAUGE_SCALE) {
+            if (!(r.step[us] > 0.0f)) return "scale without tick step";
+            float ticks = (r.hi[us] - r.lo[us]) / r.step[us] + 1.0f;
+            if (ticks < 1.5f) return "scale tick step wider than its range";
+            if (ticks > GAUGE_MAX_TICKS) return "too many scale ticks";
+            if (r.aux < 1 || ticks / r.aux > GAUGE_MAX_NUMERALS) return "too many scale numerals";
+        }
+    }
+    if (r.kind == GAUGE_READOUT) {
+        if (r.digits < 1 || r.digits > DIGIT_READOUT_MAX) return "readout digits out of range";
+        if (r.decimals >= r.digits) return "readout decimals must leave one integer digit";
+        if (r.size < 4 || r.aux < 4 || r.stroke < 1) return "readout cell too small";
+    }
+    if (r.kind == GAUGE_ARC || r.kind == GAUGE_SCALE) {
+        if (r.size < 8 || r.size > 2 * DISPLAY_WIDTH) return "diameter out of range";
+    }
+    if ((r.kind == GAUGE_ARC || r.kind == GAUGE_NEEDLE || r.kind == GAUGE_SCALE) &&
+        (r.sweep <= 0 || r.sweep > 360)) {
+        return "sweep out of range";
+    }
+    return nullptr;
+}
+
+/**
+ * Validate blob and copy it into L.
+ * @return nullptr on success, otherwise what is wrong with the blob
+ */
+static const char *gaugeLayoutLoad(GaugeLayout &L, const uint8_t *blob, size_t len) {
+    if (!blob || len < sizeof(GaugeLayoutHeader)) return "truncated header";
+    memcpy(&L.hdr, blob, sizeof(L.hdr));
+    if (L.hdr.magic != GAUGE_LAYOUT_MAGIC)     return "not a layout (bad magic)";
+    if (L.hdr.version != GAUGE_LAYOUT_VERSION) return "unsupported layout version";
+    if (L.hdr.count > GAUGE_MAX_WIDGETS)       return "too many widgets";
+    if (L.hdr.textBytes > GAUGE_MAX_TEXT)      return "string table too large";
+    size_t recBytes = (size_t)L.hdr.count * sizeof(GaugeWidgetRec);
+    if (len != sizeof(L.hdr) + recBytes + L.hdr.textBytes) return "size does not match header";
+    if (L.hdr.channelHash != gaugeChannelHash()) return "compiled for a different signal table";
+
+    // Records may sit at any alignment in a file buffer, so copy, don't cast
+    memcpy(L.w, blob + sizeof(L.hdr), recBytes);
+    memcpy(L.text, blob + sizeof(L.hdr) + recBytes, L.hdr.textBytes);
+    if (L.hdr.textBytes && L.text[L.hdr.textBytes - 1] != '\0') return "unterminated string table";
+
+    L.channels = 0;
+    for (int i = 0; i < L.hdr.count; i++) {
+        const char *err = _gaugeCheckRec(L, L.w[i]);
+        if (err) return err;
+        if (L.w[i].channel != GAUGE_NO_CHANNEL) L.channels |= SENSOR_CH_BIT(L.w[i].channel);
+    }
+    return nullptr;
+}
+
+// ── Instantiation ─────────────────────────────────────────────────────────────
+
+/** Runtime state of one record. */
+struct GaugeWidget {
+    lv_obj_t *obj;
+    float     mul, add;                  // widget value = channel value × mul + add
+    int32_t   lo, hi;                    // widget range in the applied unit system
+    union {
+        UiArc        arc;
+        UiNeedle     needle;
+        DigitReadout readout;
+        UiLabel      label;
+    };
+};
+
+/** A layout instantiated on a screen. */
+struct GaugeView {
+    const GaugeLayout *layout;
+    lv_obj_t          *screen;
+    GaugeWidget        w[GAUGE_MAX_WIDGETS];
+    DialHandSet        hands[GAUGE_MAX_HAND_SETS];
+    uint8_t            handSets;
+    int                unitSys;          // applied UnitSystem, -1 = none yet
+};
+
+// Digit atlases outlive the views built from them, like the multi-arc one
+static DigitAtlas s_gaugeAtlas[GAUGE_MAX_ATLASES];
+
+// The SCALE being painted: dial face paint callbacks take no user data
+static const GaugeWidgetRec *s_gaugePaintRec = nullptr;
+static int                   s_gaugePaintSys = UNITS_METRIC;
+static char                  s_gaugeNumerals[GAUGE_MAX_NUMERALS][8];
+
+static inline lv_color_t _gaugeColor(uint32_t rgb) {
+    return lv_color_hex(rgb);
+}
+
+static const lv_font_t *_gaugeFont(uint8_t px) {
+    switch (px) {
+        case 8:  return &lv_font_unscii_8;
+        case 16: return &lv_font_unscii_16;
+        default: return LV_FONT_DEFAULT;
+    }
+}
+
+static const DigitAtlas *_gaugeAtlas(const GaugeWidgetRec &r, lv_obj_t *parent, lv_color_t bg) {
+    lv_color_t fg = _gaugeColor(r.color);
+    for (DigitAtlas &a : s_gaugeAtlas) {
+        if (a.buf && a.cellW == r.size && a.cellH == r.aux && a.stroke == r.stroke &&
+            lv_color_eq(a.fg, fg)) {
+            return &a;
+        }
+    }
+    for (DigitAtlas &a : s_gaugeAtlas) {
+        if (a.buf) continue;
+        return digitAtlasCreate(a, parent, r.size, r.aux, r.stroke, fg, bg) ? &a : nullptr;
+    }
+    LV_LOG_WARN("gauge layout: more than %d readout styles", GAUGE_MAX_ATLASES);
+    return nullptr;
+}
+
+static void _gaugePaintScale(lv_layer_t *layer, int32_t size) {
+    const GaugeWidgetRec &r = *s_gaugePaintRec;
+    const int us = s_gaugePaintSys;
+    const int32_t c = size / 2;
+    const int32_t rad = size / 2 - 2;
+
+    lv_draw_arc_dsc_t arc;
+    lv_draw_arc_dsc_init(&arc);
+    arc.color       = _gaugeColor(r.color2);
+    arc.width       = 2;
+    arc.center.x    = c;
+    arc.center.y    = c;
+    arc.radius      = (uint16_t)(rad + 1);
+    arc.start_angle = r.start;
+    arc.end_angle   = (r.start + r.sweep) % 360;
+    lv_draw_arc(layer, &arc);
+
+    const lv_font_t *font = _gaugeFont(r.font);
+    const int32_t ticks = (int32_t)lroundf((r.hi[us] - r.lo[us]) / r.step[us]) + 1;
+    for (int32_t i = 0; i < ticks; i++) {
+        bool isMajor = (i % r.aux == 0);
+        int32_t deg = (r.start + i * r.sweep / (ticks - 1)) % 360;
+        dialPaintRadial(layer, c, c, rad - (isMajor ? 20 : 10), rad, deg, r.stroke,
+                        isMajor ? _gaugeColor(r.color) : lv_color_make(0x80, 0x80, 0x80));
+        if (!isMajor) continue;
+        char *num = s_gaugeNumerals[i / r.aux];
+        snprintf(num, sizeof(s_gaugeNumerals[0]), "%.*f", r.decimals, r.lo[us] + i * r.step[us]);
+        int32_t lr = rad - 20 - 18;
+        int32_t x = c + ((lv_trigo_cos((int16_t)deg) * lr) >> LV_TRIGO_SHIFT);
+        int32_t y = c + ((lv_trigo_sin((int16_t)deg) * lr) >> LV_TRIGO_SHIFT);
+        dialPaintText(layer, x, y, num, font, _gaugeColor(r.color));
+    }
+}
+
+static lv_obj_t *_gaugeLabel(lv_obj_t *parent, const GaugeWidgetRec &r, const char *text) {
+    lv_obj_t *l = lv_label_create(parent);
+    lv_label_set_text_static(l, text);
+    lv_obj_set_style_text_color(l, _gaugeColor(r.color), 0);
+    lv_obj_set_style_text_font(l, _gaugeFont(r.font), 0);
+    lv_obj_align(l, LV_ALIGN_CENTER, r.x, r.y);
+    return l;
+}
+
+static lv_obj_t *_gaugeArc(lv_obj_t *parent, const GaugeWidgetRec &r) {
+    lv_obj_t *a = lv_arc_create(parent);
+    lv_obj_set_size(a, r.size, r.size);
+    lv_obj_align(a, LV_ALIGN_CENTER, r.x, r.y);
+    lv_arc_set_bg_angles(a, r.start, (r.start + r.sweep) % 360);
+    lv_arc_set_mode(a, LV_ARC_MODE_NORMAL);
+    lv_obj_set_style_arc_color(a, _gaugeColor(r.color), LV_PART_INDICATOR);
+    lv_obj_set_style_arc_width(a, r.aux, LV_PART_INDICATOR);
+    lv_obj_set_style_arc_color(a, _gaugeColor(r.color2), LV_PART_MAIN);
+    lv_obj_set_style_arc_width(a, r.aux, LV_PART_MAIN);
+    lv_obj_remove_style(a, nullptr, LV_PART_KNOB);
+    lv_obj_clear_flag(a, LV_OBJ_FLAG_CLICKABLE);
+    return a;
+}
+
+/** The hand set pivoting on (cx, cy), created on first use. */
+static DialHandSet *_gaugeHands(GaugeView &v, int32_t cx, int32_t cy) {
+    for (uint8_t i = 0; i < v.handSets; i++) {
+        if (v.hands[i].cx == cx && v.hands[i].cy == cy) return &v.hands[i];
+    }
+    if (v.handSets >= GAUGE_MAX_HAND_SETS) return nullptr;
+    DialHandSet &set = v.hands[v.handSets++];
+    // Cover every needle of the layout that could share this pivot
+    int32_t radius = 8;
+    for (int i = 0; i < v.layout->hdr.count; i++) {
+        const GaugeWidgetRec &r = v.layout->w[i];
+        if (r.kind == GAUGE_NEEDLE) radius = LV_MAX(radius, LV_MAX(r.size, r.aux) + r.stroke);
+    }
+    dialHandsCreate(set, v.screen, cx, cy, radius);
+    return &set;
+}
+
+/**
+ * Switch every bound widget to unit system us: recompute mul/add and
+ * ranges, rescale needles, repaint scales and show unit labels.
+ */
+static void gaugeViewApplyUnits(GaugeView &v, UnitSystem us) {
+    const GaugeLayout &L = *v.layout;
+    v.unitSys = us;
+    for (int i = 0; i < L.hdr.count; i++) {
+        const GaugeWidgetRec &r = L.w[i];
+        if (r.kind == GAUGE_TEXT) continue;   // unbound, nothing to convert
+        GaugeWidget &g = v.w[i];
+        const GaugeUnitScale &u = kGaugeUnits[r.unit[us]];
+        float res = GAUGE_VALUE_RES;
+        if (r.kind == GAUGE_READOUT) {
+            res = 1.0f;
+            for (int d = 0; d < r.decimals; d++) res *= 10.0f;
+        }
+        g.mul = u.scale * res;
+        g.add = u.offset * res;
+        g.lo  = _unitRound(r.lo[us] * res);
+        g.hi  = _unitRound(r.hi[us] * res);
+        switch (r.kind) {
+            case GAUGE_NEEDLE:
+                if (g.needle.set) {
+                    uiNeedleInit(g.needle, *g.needle.set, g.needle.hand, g.lo, g.hi, r.start, r.sweep);
+                }
+                break;
+            case GAUGE_SCALE: {
+                s_gaugePaintRec = &r;
+                s_gaugePaintSys = us;
+                lv_obj_t *face = dialFaceCreate(v.screen, r.size, _gaugeColor(L.hdr.bg),
+                                                _gaugePaintScale);
+                if (face) lv_obj_align(face, LV_ALIGN_CENTER, r.x, r.y);
+                if (g.obj) {   // take the old face's place in the draw order
+                    if (face) lv_obj_move_to_index(face, lv_obj_get_index(g.obj));
+                    lv_obj_delete(g.obj);
+                }
+                g.obj = face;
+                break;
+            }
+            case GAUGE_UNIT:
+                uiLabelSetStatic(g.label, u.label);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * Build the widgets of layout L (which must outlive the view) on a new
+ * screen, in record order.
+ * @return the screen object
+ */
+static lv_obj_t *gaugeViewCreate(GaugeView &v, const GaugeLayout &L, UnitSystem us) {
+    v.layout   = &L;
+    v.handSets = 0;
+    v.unitSys  = -1;
+    memset(v.w, 0, sizeof(v.w));
+
+    lv_color_t bg = _gaugeColor(L.hdr.bg);
+    v.screen = lv_obj_create(nullptr);
+    lv_obj_set_style_bg_color(v.screen, bg, 0);
+    lv_obj_set_style_bg_opa(v.screen, LV_OPA_COVER, 0);
+    lv_obj_clear_flag(v.screen, LV_OBJ_FLAG_SCROLLABLE);
+
+    for (int i = 0; i < L.hdr.count; i++) {
+        const GaugeWidgetRec &r = L.w[i];
+        GaugeWidget &g = v.w[i];
+        switch (r.kind) {
+            case GAUGE_ARC:
+                g.obj = _gaugeArc(v.screen, r);
+                uiArcInit(g.arc, g.obj, r.sweep);
+                break;
+            case GAUGE_NEEDLE: {
+                DialHandSet *set = _gaugeHands(v, DISPLAY_WIDTH / 2 + r.x, DISPLAY_HEIGHT / 2 + r.y);
+                int hand = set ? dialHandAdd(*set, r.size, r.aux, r.stroke, _gaugeColor(r.color)) : -1;
+                if (hand < 0) {
+                    LV_LOG_WARN("gauge layout: no room for needle %d", i);
+                    break;
+                }
+                g.obj = set->obj;
+                g.needle.set  = set;
+                g.needle.hand = hand;
+                break;
+            }
+            case GAUGE_SCALE:
+                // Placeholder holding the draw position; gaugeViewApplyUnits()
+                // replaces it with the painted face
+                g.obj = lv_obj_create(v.screen);
+                lv_obj_remove_style_all(g.obj);
+                break;
+            case GAUGE_READOUT: {
+                const DigitAtlas *atlas = _gaugeAtlas(r, v.screen, bg);
+                if (!atlas) break;
+                g.obj = digitReadoutCreate(g.readout, v.screen, *atlas, r.digits, r.decimals);
+                if (g.obj) {
+                    lv_obj_align(g.obj, LV_ALIGN_CENTER, r.x, r.y);
+                    lv_obj_update_layout(g.obj);   // cells are invalidated by screen coordinates
+                }
+                break;
+            }
+            case GAUGE_TEXT:
+                g.obj = _gaugeLabel(v.screen, r, &L.text[r.text]);
+                break;
+            case GAUGE_UNIT:
+                g.obj = _gaugeLabel(v.screen, r, "");
+                uiLabelInit(g.label, g.obj);
+                break;
+        }
+    }
+    gaugeViewApplyUnits(v, us);
+    for (int i = 0; i < L.hdr.count; i++) {
+        if (L.w[i].kind == GAUGE_NEEDLE && v.w[i].obj) uiNeedleSet(v.w[i].needle, v.w[i].lo);
+    }
+    return v.screen;
+}
+
+/** Forget the widgets after the screen was deleted; the atlases are kept. */
+static void gaugeViewRelease(GaugeView &v) {
+    v.screen   = nullptr;
+    v.handSets = 0;
+    memset(v.w, 0, sizeof(v.w));
+}
+
+/**
+ * Show the channel values in val (one per SensorChannel) in unit system us.
+ * Widgets whose rendered appearance would not change are left untouched.
+ */
+static void gaugeViewUpdate(GaugeView &v, const float *val, UnitSystem us) {
+    if (!v.screen) return;
+    if (us != v.unitSys) gaugeViewApplyUnits(v, us);
+    const GaugeLayout &L = *v.layout;
+    for (int i = 0; i < L.hdr.count; i++) {
+        const GaugeWidgetRec &r = L.w[i];
+        GaugeWidget &g = v.w[i];
+        if (!g.obj || r.channel == GAUGE_NO_CHANNEL) continue;
+        float x = val[r.channel] * g.mul + g.add;
+        switch (r.kind) {
+            case GAUGE_ARC:     uiArcSet(g.arc, g.lo, g.hi, (int32_t)x);         break;
+            case GAUGE_NEEDLE:  uiNeedleSet(g.needle, (int32_t)lroundf(x));      break;
+            case GAUGE_READOUT: digitReadoutSet(g.readout, (int32_t)lroundf(x)); break;
+            default:            break;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * gauge_layout_default.h
+ * GENERATED by tools/gauge2rgl.py from tools/engine.gauge – do not edit.
+ *
+ * The layout screen's built-in layout (gauge_layout.h), used when no
+ * layout file overrides it.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+static const uint8_t kGaugeLayoutDefault[484] = {
+    0x52, 0x47, 0x4C, 0x31, 0x01, 0x08, 0x14, 0x00, 0xC0, 0x1B, 0x69, 0x3E,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x04, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00,
+    0xC2, 0x01, 0x0A, 0x00, 0x96, 0x00, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0xBF, 0x00, 0x00, 0x30, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x20, 0x42, 0x00, 0x00, 0xC8, 0x42, 0x00, 0x00, 0x02, 0x43,
+    0x00, 0x00, 0x87, 0x43, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x05, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x44, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0xAA, 0xAA, 0xAA, 0x00,
+    0x30, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x03, 0x09, 0x09,
+    0x00, 0x00, 0x00, 0x00, 0x90, 0x01, 0x02, 0x00, 0x87, 0x00, 0x0E, 0x01,
+    0x02, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0x44, 0x44, 0x44, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x41, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00, 0x00, 0x3F,
+    0x00, 0x00, 0x00, 0x3F, 0x05, 0xFF, 0x00, 0x00, 0x00, 0x00, 0xC4, 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08,
+    0xAA, 0xAA, 0xAA, 0x00, 0x30, 0x30, 0x30, 0x00, 0x06, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x02, 0x03, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x96, 0x00, 0x14, 0x00,
+    0x87, 0x00, 0x0E, 0x01, 0x04, 0x00, 0x00, 0x00, 0x00, 0x80, 0xFF, 0x00,
+    0x30, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFA, 0x45, 0x00, 0x00, 0xFA, 0x45,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0xFF, 0x00, 0x00,
+    0x00, 0x00, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x08, 0xAA, 0xAA, 0xAA, 0x00, 0x30, 0x30, 0x30, 0x00,
+    0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x05, 0x01, 0x03, 0x00, 0x00, 0x5A, 0x00,
+    0x1C, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x03, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF, 0x00, 0x30, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x06, 0x05, 0x01, 0x03, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0xAA, 0xAA, 0xAA, 0x00,
+    0x30, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x57, 0x41, 0x54, 0x45,
+    0x52, 0x00, 0x78, 0x31, 0x30, 0x30, 0x30, 0x20, 0x72, 0x70, 0x6D, 0x00,
+    0x4F, 0x49, 0x4C, 0x00,
+};
@@ -8,8 +8,8 @@
  *   Hold 3 s    → enter setup screen (from any main screen) or exit it
  *   Swipe down  → exit setup screen (returns to last main screen)
  *
- * The gesture callbacks are attached to each screen object in
- * installGestureHandlers().  A software timer tracks long-press duration.
+ * The gesture callbacks are attached to each screen object as it is built
+ * (gestureAttachScreen()).  A software timer tracks long-press duration.
  */
 
 #pragma once
@@ -20,7 +20,7 @@
 // ── Navigation state (extern, defined in roundie.ino) ────────────────────────
 extern int      g_currentScreen;   // 0-2 for main screens, 3 = setup
 extern int      g_prevScreen;      // screen we came from before entering setup
-extern lv_obj_t *g_screens[];      // array of screen objects [0..3]
+extern lv_obj_t *g_screens[];      // array of screen objects [0..SCREEN_SETUP]
 
 // Forward declaration for the screen-switch function defined in roundie.ino
 extern void switchToScreen(int idx);
@@ -98,21 +98,24 @@ static void _screenEventCb(lv_event_t *e) {
 }
 
 /**
- * Create the long-press timer and attach gesture/press callbacks to every
- * screen object in g_screens[].  Call once after all screens are created.
+ * Attach the gesture/press callbacks to one screen object.  The screen
+ * manager (screen_manager.h) calls this for every screen it builds.
+ */
+static void gestureAttachScreen(lv_obj_t *scr) {
+    lv_obj_clear_flag(scr, LV_OBJ_FLAG_GESTURE_BUBBLE);
+    lv_obj_add_event_cb(scr, _screenEventCb, LV_EVENT_PRESSING,    nullptr);
+    lv_obj_add_event_cb(scr, _screenEventCb, LV_EVENT_RELEASED,    nullptr);
+    lv_obj_add_event_cb(scr, _screenEventCb, LV_EVENT_PRESS_LOST,  nullptr);
+    lv_obj_add_event_cb(scr, _screenEventCb, LV_EVENT_GESTURE,     nullptr);
+}
+
+/**
+ * Create the long-press timer.  The screens get their callbacks only from
+ * gestureAttachScreen() as the screen manager builds them – attaching them
+ * here as well would run _screenEventCb twice per swipe and skip a screen.
  */
 static void installGestureHandlers(void) {
     // Create the long-press polling timer (paused initially)
     s_longPressTimer = lv_timer_create(_longPressTimerCb, 50, nullptr);
     lv_timer_pause(s_longPressTimer);
-
-    // Attach event callbacks to all screens
-    for (int i = 0; i <= SCREEN_SETUP; i++) {
-        if (!g_screens[i]) continue;
-        lv_obj_clear_flag(g_screens[i], LV_OBJ_FLAG_GESTURE_BUBBLE);
-        lv_obj_add_event_cb(g_screens[i], _screenEventCb, LV_EVENT_PRESSING,    nullptr);
-        lv_obj_add_event_cb(g_screens[i], _screenEventCb, LV_EVENT_RELEASED,    nullptr);
-        lv_obj_add_event_cb(g_screens[i], _screenEventCb, LV_EVENT_PRESS_LOST,  nullptr);
-        lv_obj_add_event_cb(g_screens[i], _screenEventCb, LV_EVENT_GESTURE,     nullptr);
-    }
 }
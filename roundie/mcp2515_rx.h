@@ -0,0 +1,136 @@
+/**
+ * mcp2515_rx.h
+ * Burst receive path for the MCP2515.
+ *
+ * The driver library's readMessage() costs five SPI transactions per frame:
+ * READ STATUS, the five header registers, RXBnCTRL, the data registers, and
+ * a BIT MODIFY to clear RXnIF – plus one more READ STATUS to find the
+ * buffers empty.  This path uses the controller's two receive shortcuts:
+ *
+ *   RX STATUS (0xB0)         which buffers hold a frame, in one byte
+ *   READ RX BUFFER (0x90)    header and data of one buffer in one burst,
+ *                            starting at RXBnSIDH; raising CS afterwards
+ *                            clears that buffer's RXnIF, so no BIT MODIFY
+ *
+ * so a frame costs one 14-byte transaction, and one 2-byte RX STATUS serves
+ * both buffers.  Each transaction is handed to a Mcp2515SpiFn as a single
+ * buffer: on the device that is one SPIClass::transferBytes() – one pass
+ * through the SPI peripheral's FIFO with CS held low – and in the simulator
+ * the register model in sim/mcp2515_model.h.
+ *
+ * Configuration (bit timing, filters, modes) stays with the driver library;
+ * only reception goes through here.  Every transaction and byte is counted
+ * for the [SPI] line (mcp2515RxReport()).
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <can.h>
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+
+// SPI instructions
+#define MCP2515_READ_RX_BUFFER  0x90   // | 0x04 for RXB1
+#define MCP2515_RX_STATUS       0xB0
+
+// RX STATUS bits
+#define MCP2515_RXS_RXB0        0x40
+#define MCP2515_RXS_RXB1        0x80
+
+#define MCP2515_RX_BURST        14     // instruction, SIDH..DLC, 8 data bytes
+
+/** One SPI transaction with CS held low: n bytes out of tx, n bytes into rx. */
+typedef void (*Mcp2515SpiFn)(const uint8_t *tx, uint8_t *rx, size_t n, void *ctx);
+
+/** Counted since the last mcp2515RxReport(); written by the CAN task only. */
+struct Mcp2515RxStats {
+    std::atomic<uint32_t> frames{0};
+    std::atomic<uint32_t> transactions{0};
+    std::atomic<uint32_t> bytes{0};
+};
+
+/** The receive path's link to one controller. */
+struct Mcp2515Rx {
+    Mcp2515SpiFn   spi;
+    void          *ctx;
+    Mcp2515RxStats stats;
+};
+
+static inline void _mcp2515Transfer(Mcp2515Rx &rx, const uint8_t *tx, uint8_t *in, size_t n) {
+    rx.spi(tx, in, n, rx.ctx);
+    rx.stats.transactions.fetch_add(1, std::memory_order_relaxed);
+    rx.stats.bytes.fetch_add((uint32_t)n, std::memory_order_relaxed);
+}
+
+/** RX STATUS: MCP2515_RXS_RXB0 / _RXB1 set for each buffer holding a frame. */
+static inline uint8_t mcp2515RxStatus(Mcp2515Rx &rx) {
+    const uint8_t tx[2] = { MCP2515_RX_STATUS, 0 };
+    uint8_t in[2];
+    _mcp2515Transfer(rx, tx, in, sizeof(tx));
+    return in[1];
+}
+
+/**
+ * Read receive buffer 0 or 1 in one burst, which also frees it.  The id is
+ * in SocketCAN form: CAN_EFF_FLAG and CAN_RTR_FLAG as in the frame.
+ */
+static inline void mcp2515ReadRxBuffer(Mcp2515Rx &rx, uint8_t buffer, struct can_frame &f) {
+    uint8_t tx[MCP2515_RX_BURST] = { (uint8_t)(MCP2515_READ_RX_BUFFER | (buffer ? 0x04 : 0)) };
+    uint8_t in[MCP2515_RX_BURST];
+    _mcp2515Transfer(rx, tx, in, sizeof(tx));
+
+    const uint8_t *r = in + 1;    // SIDH SIDL EID8 EID0 DLC D0..D7
+    uint32_t id = ((uint32_t)r[0] << 3) | (r[1] >> 5);
+    if (r[1] & 0x08) {            // IDE: extended
+        id = (id << 18) | ((uint32_t)(r[1] & 0x03) << 16) | ((uint32_t)r[2] << 8) | r[3];
+        id |= CAN_EFF_FLAG;
+        if (r[4] & 0x40) id |= CAN_RTR_FLAG;
+    } else if (r[1] & 0x10) {     // SRR: standard remote
+        id |= CAN_RTR_FLAG;
+    }
+    uint8_t dlc = r[4] & 0x0F;
+    f.can_id  = id;
+    f.can_dlc = dlc > 8 ? 8 : dlc;
+    memcpy(f.data, r + 5, 8);
+    rx.stats.frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Every frame the controller holds, RXB0 first: one RX STATUS, then one
+ * burst per full buffer.
+ * @return frames read into out (0, 1 or 2)
+ */
+static inline uint8_t mcp2515ReadFrames(Mcp2515Rx &rx, struct can_frame out[2]) {
+    uint8_t status = mcp2515RxStatus(rx);
+    uint8_t n = 0;
+    if (status & MCP2515_RXS_RXB0) mcp2515ReadRxBuffer(rx, 0, out[n++]);
+    if (status & MCP2515_RXS_RXB1) mcp2515ReadRxBuffer(rx, 1, out[n++]);
+    return n;
+}
+
+// ── Reporting ─────────────────────────────────────────────────────────────────
+
+struct Mcp2515RxReport {
+    uint32_t frames, transactions, bytes;
+};
+
+/** Counts since the last call, which are reset. */
+static inline Mcp2515RxReport mcp2515RxReport(Mcp2515Rx &rx) {
+    Mcp2515RxReport r;
+    r.frames       = rx.stats.frames.exchange(0);
+    r.transactions = rx.stats.transactions.exchange(0);
+    r.bytes        = rx.stats.bytes.exchange(0);
+    return r;
+}
+
+/** Transactions, bytes and SPI clock time (at CAN_SPI_CLOCK) per frame into buf. */
+static inline char *mcp2515RxFormat(const Mcp2515RxReport &r, char *buf, size_t size) {
+    float frames = r.frames ? (float)r.frames : 1.0f;
+    snprintf(buf, size, "%lu frames, %.2f transactions, %.1f bytes, %.1f us SPI per frame",
+             (unsigned long)r.frames, r.transactions / frames, r.bytes / frames,
+             r.bytes * 8.0f * 1e6f / CAN_SPI_CLOCK / frames);
+    return buf;
+}
@@ -0,0 +1,229 @@
+/**
+ * render_strategy.h
+ * Display draw-buffer strategy, switchable at run time and self-calibrating.
+ *
+ *   RENDER_PARTIAL_SRAM   two N-line buffers in internal (DMA-capable) RAM:
+ *                         fastest to render into, but internal RAM is scarce
+ *   RENDER_PARTIAL_PSRAM  two N-line buffers in PSRAM: the original setup
+ *   RENDER_DIRECT_PSRAM   two full frames in PSRAM, LV_DISPLAY_RENDER_MODE_DIRECT:
+ *                         every dirty area is rendered in one pass, at the
+ *                         cost of keeping both frames in sync
+ *
+ * renderApply() (re)allocates the buffers for a configuration and hands them
+ * to LVGL.  When memory is short it degrades step by step – direct → partial
+ * PSRAM → fewer lines → internal RAM → static 10-line buffers – and returns
+ * what it actually applied.
+ *
+ * renderCalibrate() times full redraws (render + flush) of each screen under
+ * every candidate in kRenderCandidates and keeps the fastest.  The firmware
+ * runs it at boot with RENDER_CALIBRATE and stores the winner in NVS; the
+ * simulator bench runs the same code with --calibrate.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <stdlib.h>
+#include "config.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+enum RenderStrategy : uint8_t {
+    RENDER_PARTIAL_SRAM  = 0,
+    RENDER_PARTIAL_PSRAM = 1,
+    RENDER_DIRECT_PSRAM  = 2,
+    RENDER_STRATEGY_COUNT
+};
+
+struct RenderConfig {
+    uint8_t  strategy;   // RenderStrategy
+    uint16_t lines;      // rows per buffer (DISPLAY_HEIGHT for direct mode)
+};
+
+#define RENDER_MIN_LINES       8
+#define RENDER_FALLBACK_LINES  10
+#define RENDER_BYTES_PER_PX    ((LV_COLOR_DEPTH + 7) / 8)
+#define RENDER_CAL_MAX_SCREENS 5
+
+static RenderConfig s_renderCfg    = { RENDER_STRATEGY, RENDER_BUF_LINES };
+static void        *s_renderBuf[2] = {};
+static bool         s_renderStatic = false;   // s_renderBuf are the static fallback
+
+static const char *renderStrategyName(uint8_t strategy) {
+    switch (strategy) {
+        case RENDER_PARTIAL_SRAM:  return "partial-sram";
+        case RENDER_PARTIAL_PSRAM: return "partial-psram";
+        case RENDER_DIRECT_PSRAM:  return "direct-psram";
+        default:                   return "?";
+    }
+}
+
+/** True when the flush callback receives whole frames (direct mode). */
+static bool renderIsFullFrame(void) {
+    return s_renderCfg.strategy == RENDER_DIRECT_PSRAM;
+}
+
+static uint64_t _renderNowUs(void) {
+#if defined(ESP_PLATFORM)
+    return (uint64_t)esp_timer_get_time();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static void *_renderAlloc(size_t bytes, bool psram) {
+#if defined(ESP_PLATFORM)
+    return heap_caps_malloc(bytes, psram ? MALLOC_CAP_SPIRAM
+                                         : MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+#else
+    (void)psram;
+    return malloc(bytes);
+#endif
+}
+
+static void _renderFree(void *p) {
+#if defined(ESP_PLATFORM)
+    heap_caps_free(p);
+#else
+    free(p);
+#endif
+}
+
+/**
+ * Allocate buffers for cfg and switch disp to them, releasing the previous
+ * ones.  Call from the LVGL thread, between lv_timer_handler() calls.
+ *
+ * @return the configuration actually applied (see the fallback order above)
+ */
+static RenderConfig renderApply(lv_display_t *disp, RenderConfig cfg) {
+    if (cfg.strategy >= RENDER_STRATEGY_COUNT) cfg.strategy = RENDER_PARTIAL_PSRAM;
+    if (cfg.strategy == RENDER_DIRECT_PSRAM) cfg.lines = DISPLAY_HEIGHT;
+    cfg.lines = (uint16_t)LV_MIN(LV_MAX(cfg.lines, RENDER_MIN_LINES), DISPLAY_HEIGHT);
+
+    void  *buf[2] = {};
+    size_t bytes  = 0;
+    for (;;) {
+        bytes = (size_t)DISPLAY_WIDTH * cfg.lines * RENDER_BYTES_PER_PX;
+        bool psram = cfg.strategy != RENDER_PARTIAL_SRAM;
+        buf[0] = _renderAlloc(bytes, psram);
+        buf[1] = buf[0] ? _renderAlloc(bytes, psram) : nullptr;
+        if (buf[1]) break;
+        if (buf[0]) _renderFree(buf[0]);
+        buf[0] = nullptr;
+
+        if (cfg.strategy == RENDER_DIRECT_PSRAM) {
+            cfg = { RENDER_PARTIAL_PSRAM, RENDER_BUF_LINES };
+        } else if (cfg.lines / 2 >= RENDER_MIN_LINES) {
+            cfg.lines /= 2;
+        } else if (cfg.strategy == RENDER_PARTIAL_PSRAM) {
+            cfg = { RENDER_PARTIAL_SRAM, RENDER_BUF_LINES };
+        } else {
+            break;
+        }
+    }
+
+    bool isStatic = false;
+    if (!buf[1]) {
+        static uint8_t fallback1[DISPLAY_WIDTH * RENDER_FALLBACK_LINES * RENDER_BYTES_PER_PX];
+        static uint8_t fallback2[DISPLAY_WIDTH * RENDER_FALLBACK_LINES * RENDER_BYTES_PER_PX];
+        LV_LOG_WARN("render: no memory for draw buffers, using static %d-line buffers",
+                    RENDER_FALLBACK_LINES);
+        buf[0]   = fallback1;
+        buf[1]   = fallback2;
+        bytes    = sizeof(fallback1);
+        cfg      = { RENDER_PARTIAL_SRAM, RENDER_FALLBACK_LINES };
+        isStatic = true;
+    }
+
+    lv_display_set_buffers(disp, buf[0], buf[1], (uint32_t)bytes,
+                           cfg.strategy == RENDER_DIRECT_PSRAM ? LV_DISPLAY_RENDER_MODE_DIRECT
+                                                               : LV_DISPLAY_RENDER_MODE_PARTIAL);
+    if (!s_renderStatic) {
+        if (s_renderBuf[0]) _renderFree(s_renderBuf[0]);
+        if (s_renderBuf[1]) _renderFree(s_renderBuf[1]);
+    }
+    s_renderBuf[0] = buf[0];
+    s_renderBuf[1] = buf[1];
+    s_renderStatic = isStatic;
+    s_renderCfg    = cfg;
+
+    // The new buffers hold nothing yet
+    lv_obj_invalidate(lv_display_get_screen_active(disp));
+    return cfg;
+}
+
+// ── Calibration ───────────────────────────────────────────────────────────────
+
+static const RenderConfig kRenderCandidates[] = {
+    { RENDER_PARTIAL_SRAM,  23 },
+    { RENDER_PARTIAL_SRAM,  46 },
+    { RENDER_PARTIAL_PSRAM, 46 },
+    { RENDER_PARTIAL_PSRAM, 117 },
+    { RENDER_PARTIAL_PSRAM, 233 },
+    { RENDER_DIRECT_PSRAM,  DISPLAY_HEIGHT },
+};
+#define RENDER_CANDIDATE_COUNT (sizeof(kRenderCandidates) / sizeof(kRenderCandidates[0]))
+
+/** Timing of one candidate. */
+struct RenderCalResult {
+    RenderConfig asked;                             // candidate
+    RenderConfig used;                              // after any memory fallback
+    uint32_t     screenUs[RENDER_CAL_MAX_SCREENS];  // mean µs per full redraw
+    uint32_t     meanUs;                            // mean over all screens
+};
+
+/**
+ * Time frames full redraws (lv_refr_now(), so render and flush) of each of
+ * the count screens under every candidate, then apply the fastest and reload
+ * the screen that was active.  Screens left nullptr are skipped.
+ *
+ * @param results  RENDER_CANDIDATE_COUNT entries to fill, or nullptr
+ * @return the configuration now applied
+ */
+static RenderConfig renderCalibrate(lv_display_t *disp, lv_obj_t *const *screens, int count,
+                                    int frames, RenderCalResult *results) {
+    lv_obj_t *active = lv_display_get_screen_active(disp);
+    if (count > RENDER_CAL_MAX_SCREENS) count = RENDER_CAL_MAX_SCREENS;
+
+    RenderConfig best   = s_renderCfg;
+    uint32_t     bestUs = UINT32_MAX;
+    for (size_t i = 0; i < RENDER_CANDIDATE_COUNT; i++) {
+        RenderCalResult r = {};
+        r.asked = kRenderCandidates[i];
+        r.used  = renderApply(disp, r.asked);
+
+        uint64_t total = 0;
+        int timedScreens = 0;
+        for (int s = 0; s < count; s++) {
+            if (!screens[s]) continue;
+            lv_screen_load(screens[s]);
+            lv_refr_now(disp);                       // settle layout and styles
+            uint64_t screenTotal = 0;
+            for (int f = 0; f < frames; f++) {
+                lv_obj_invalidate(screens[s]);
+                uint64_t t0 = _renderNowUs();
+                lv_refr_now(disp);
+                screenTotal += _renderNowUs() - t0;
+            }
+            r.screenUs[s] = frames ? (uint32_t)(screenTotal / frames) : 0;
+            total += r.screenUs[s];
+            timedScreens++;
+        }
+        r.meanUs = timedScreens ? (uint32_t)(total / timedScreens) : UINT32_MAX;
+        if (results) results[i] = r;
+        if (r.meanUs < bestUs) {
+            bestUs = r.meanUs;
+            best   = r.used;
+        }
+    }
+
+    renderApply(disp, best);
+    if (active) lv_screen_load(active);
+    return best;
+}
@@ -0,0 +1,230 @@
+/**
+ * round_viewport.h
+ * Rendering and flushing restricted to the visible disc of the round panel.
+ *
+ * The 466×466 AMOLED shows a circle; the four corners of every rectangle
+ * LVGL renders and sends over QSPI are never seen – about 21% of a
+ * full-screen redraw.  Two hooks cut that waste:
+ *
+ *   Render – an LV_EVENT_INVALIDATE_AREA handler (installed before any other)
+ *            shrinks each invalidated area to the bounding box of its
+ *            intersection with the disc.  Tall areas that still waste a lot,
+ *            such as the full-screen invalidation of a screen load or fade,
+ *            are split into RV_BAND_ROWS-high bands, each clipped on its own.
+ *
+ *   Flush  – roundViewportFlush() sends each flushed area as runs of
+ *            RV_FLUSH_RUN_ROWS rows, every run trimmed to the chords of its
+ *            rows and made contiguous for the panel's window write.
+ *
+ * Both are driven from a per-row chord table built once at install time.
+ * s_roundViewport = false bypasses them (for A/B comparison); the savings
+ * are accumulated for roundViewportReport().
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <math.h>
+#include <string.h>
+#include "config.h"
+
+#define RV_EDGE_MARGIN_PX    1      // keep one extra pixel beyond the disc edge
+#define RV_BAND_ROWS         32     // band height when splitting tall areas
+#define RV_SPLIT_MIN_WASTE   2048   // only split areas wasting more pixels than this
+#define RV_FLUSH_RUN_ROWS    8      // rows per trimmed flush window
+#define RV_WINDOW_ALIGN      2      // CO5300 window start/size granularity (px)
+#define RV_WINDOW_CMD_BYTES  20     // QSPI overhead of one CASET/RASET/RAMWR window
+#define RV_BYTES_PER_PX      ((LV_COLOR_DEPTH + 7) / 8)
+
+static bool s_roundViewport = ROUND_VIEWPORT != 0;
+
+// Visible columns of each row (left > right for a row with none)
+static int16_t s_rvLeft[DISPLAY_HEIGHT];
+static int16_t s_rvRight[DISPLAY_HEIGHT];
+static bool    s_rvSplitting = false;
+
+/** Accumulated since the last roundViewportReport(). */
+struct RoundViewportStats {
+    uint64_t invalidPxIn;    // pixels requested for redraw
+    uint64_t invalidPxOut;   // pixels left after clipping to the disc
+    uint64_t flushPxIn;      // pixels LVGL handed to the flush callback
+    uint64_t flushPxOut;     // pixels actually sent to the panel
+    uint32_t flushes;        // flush calls (one window each without trimming)
+    uint32_t windows;        // windows actually sent
+    uint32_t frames;         // refreshes that flushed anything
+};
+static RoundViewportStats s_rvStats;
+
+/**
+ * Bounding box of area a ∩ disc.  visiblePx, if given, receives the number
+ * of disc pixels inside it.
+ * @return false if a lies entirely outside the disc
+ */
+static bool _rvClip(const lv_area_t &a, lv_area_t &out, int32_t *visiblePx) {
+    int32_t y1 = LV_MAX(a.y1, 0), y2 = LV_MIN(a.y2, DISPLAY_HEIGHT - 1);
+    int32_t visible = 0;
+    bool any = false;
+    for (int32_t y = y1; y <= y2; y++) {
+        int32_t l = LV_MAX(a.x1, s_rvLeft[y]), r = LV_MIN(a.x2, s_rvRight[y]);
+        if (l > r) continue;
+        visible += r - l + 1;
+        if (!any) {
+            out = { l, y, r, y };
+            any = true;
+        } else {
+            out.x1 = LV_MIN(out.x1, l);
+            out.x2 = LV_MAX(out.x2, r);
+            out.y2 = y;
+        }
+    }
+    if (visiblePx) *visiblePx = visible;
+    return any;
+}
+
+static void _rvInvalidateCb(lv_event_t *e) {
+    lv_display_t *disp = (lv_display_t *)lv_event_get_current_target(e);
+    lv_area_t *a = (lv_area_t *)lv_event_get_param(e);
+    if (!s_rvSplitting) s_rvStats.invalidPxIn += lv_area_get_size(a);
+    if (!s_roundViewport) {
+        s_rvStats.invalidPxOut += lv_area_get_size(a);
+        return;
+    }
+
+    lv_area_t clip;
+    int32_t visible;
+    if (!_rvClip(*a, clip, &visible)) {
+        // Entirely in a corner.  The event cannot cancel the invalidation,
+        // so shrink it to a single pixel.
+        clip = { a->x1, a->y1, a->x1, a->y1 };
+    } else if (!s_rvSplitting && lv_area_get_height(&clip) > RV_BAND_ROWS &&
+               (int32_t)lv_area_get_size(&clip) - visible > RV_SPLIT_MIN_WASTE) {
+        // Keep the first band here and invalidate the rest separately.  Band
+        // edges sit on multiples of RV_BAND_ROWS so repeated full-screen
+        // invalidations produce identical bands, which LVGL de-duplicates.
+        int32_t firstEnd = (clip.y1 / RV_BAND_ROWS + 1) * RV_BAND_ROWS - 1;
+        s_rvSplitting = true;
+        for (int32_t y = firstEnd + 1; y <= clip.y2; y += RV_BAND_ROWS) {
+            lv_area_t band = { clip.x1, y, clip.x2, LV_MIN(y + RV_BAND_ROWS - 1, clip.y2) };
+            _lv_inv_area(disp, &band);   // re-enters this handler, which clips it
+        }
+        s_rvSplitting = false;
+        lv_area_t first = { clip.x1, clip.y1, clip.x2, firstEnd };
+        _rvClip(first, clip, nullptr);
+    }
+    *a = clip;
+    s_rvStats.invalidPxOut += lv_area_get_size(a);
+}
+
+/** Build the chord table and clip every later invalidation on disp to the disc. */
+static void roundViewportInstall(lv_display_t *disp) {
+    const float c = DISPLAY_WIDTH / 2.0f;
+    const float r = DISPLAY_WIDTH / 2.0f + RV_EDGE_MARGIN_PX;
+    for (int32_t y = 0; y < DISPLAY_HEIGHT; y++) {
+        float dy = y + 0.5f - DISPLAY_HEIGHT / 2.0f;
+        if (fabsf(dy) >= r) {
+            s_rvLeft[y]  = DISPLAY_WIDTH;
+            s_rvRight[y] = -1;
+            continue;
+        }
+        float half = sqrtf(r * r - dy * dy);
+        s_rvLeft[y]  = (int16_t)LV_MAX(0, (int32_t)floorf(c - half));
+        s_rvRight[y] = (int16_t)LV_MIN(DISPLAY_WIDTH - 1, (int32_t)ceilf(c + half) - 1);
+    }
+    memset(&s_rvStats, 0, sizeof(s_rvStats));
+    lv_display_add_event_cb(disp, _rvInvalidateCb, LV_EVENT_INVALIDATE_AREA, nullptr);
+}
+
+/** Grow v to the panel's window granularity without leaving bounds. */
+static void _rvAlign(lv_area_t &v, const lv_area_t &bounds) {
+    v.x1 = LV_MAX(bounds.x1, v.x1 - v.x1 % RV_WINDOW_ALIGN);
+    v.y1 = LV_MAX(bounds.y1, v.y1 - v.y1 % RV_WINDOW_ALIGN);
+    v.x2 = LV_MIN(bounds.x2, v.x2 + (RV_WINDOW_ALIGN - 1 - v.x2 % RV_WINDOW_ALIGN));
+    v.y2 = LV_MIN(bounds.y2, v.y2 + (RV_WINDOW_ALIGN - 1 - v.y2 % RV_WINDOW_ALIGN));
+}
+
+/** Sends one window of contiguous pixels to the panel. */
+typedef void (*RoundFlushWriteFn)(const lv_area_t *area, const uint8_t *px);
+
+// Full-frame (direct mode) buffers must keep their contents, so runs are
+// copied out through this bounce buffer instead of being compacted in place
+static uint8_t s_rvBounce[RV_FLUSH_RUN_ROWS * DISPLAY_WIDTH * RV_BYTES_PER_PX];
+
+/**
+ * Flush area/px through write, trimmed to the disc.  Call from the display's
+ * flush callback (then call lv_display_flush_ready() as usual).
+ *
+ * fullFrame = false: px holds just the area (partial render mode).  A run is
+ *   compacted into the buffer space of its own rows before it is written, so
+ *   an asynchronous write of one run is never overwritten by the next.
+ * fullFrame = true: px is the whole DISPLAY_WIDTH-wide frame (direct render
+ *   mode).  Runs are copied into s_rvBounce, so write must be done with its
+ *   pixels when it returns.
+ *
+ * With write == nullptr nothing is sent or modified; only the statistics
+ * are updated (for displays whose flush callback is not ours, e.g. the
+ * simulator's SDL window).
+ */
+static void roundViewportFlush(lv_display_t *disp, const lv_area_t *area, uint8_t *px,
+                               bool fullFrame, RoundFlushWriteFn write) {
+    const int32_t w = lv_area_get_width(area);
+    s_rvStats.flushPxIn += lv_area_get_size(area);
+    s_rvStats.flushes++;
+    if (lv_display_flush_is_last(disp)) s_rvStats.frames++;
+
+    if (!s_roundViewport && !fullFrame) {
+        if (write) write(area, px);
+        s_rvStats.flushPxOut += lv_area_get_size(area);
+        s_rvStats.windows++;
+        return;
+    }
+
+    for (int32_t y = area->y1; y <= area->y2; y += RV_FLUSH_RUN_ROWS) {
+        lv_area_t run = { area->x1, y, area->x2, LV_MIN(y + RV_FLUSH_RUN_ROWS - 1, area->y2) };
+        lv_area_t vis = run;
+        if (s_roundViewport) {
+            if (!_rvClip(run, vis, nullptr)) continue;
+            _rvAlign(vis, run);
+        }
+        s_rvStats.flushPxOut += lv_area_get_size(&vis);
+        s_rvStats.windows++;
+        if (!write) continue;
+
+        const int32_t vw = lv_area_get_width(&vis);
+        const size_t rowBytes = (size_t)vw * RV_BYTES_PER_PX;
+        uint8_t *dst;
+        if (fullFrame) {
+            dst = s_rvBounce;
+            for (int32_t r = 0; r < lv_area_get_height(&vis); r++) {
+                const uint8_t *src = px + ((size_t)(vis.y1 + r) * DISPLAY_WIDTH + vis.x1) * RV_BYTES_PER_PX;
+                memcpy(dst + r * rowBytes, src, rowBytes);
+            }
+        } else {
+            dst = px + (size_t)(vis.y1 - area->y1) * w * RV_BYTES_PER_PX;
+            if (vw != w) {
+                // Each row moves to a lower or equal address, so rows are
+                // never overwritten before they are copied
+                for (int32_t r = 0; r < lv_area_get_height(&vis); r++) {
+                    const uint8_t *src = dst + ((size_t)r * w + (vis.x1 - area->x1)) * RV_BYTES_PER_PX;
+                    memmove(dst + r * rowBytes, src, rowBytes);
+                }
+            }
+        }
+        write(&vis, dst);
+    }
+}
+
+/**
+ * Savings per frame since the previous call; resets the window.
+ *   renderPx  – pixels no longer rendered (invalidation requests, so
+ *               overlapping areas count twice)
+ *   qspiBytes – pixel bytes not sent minus the extra window commands
+ */
+static void roundViewportReport(uint32_t &renderPx, int32_t &qspiBytes) {
+    uint32_t frames = s_rvStats.frames ? s_rvStats.frames : 1;
+    int64_t pxSaved  = (int64_t)(s_rvStats.invalidPxIn - s_rvStats.invalidPxOut);
+    int64_t bytes = (int64_t)(s_rvStats.flushPxIn - s_rvStats.flushPxOut) * RV_BYTES_PER_PX
+                  - ((int64_t)s_rvStats.windows - s_rvStats.flushes) * RV_WINDOW_CMD_BYTES;
+    renderPx  = (uint32_t)(pxSaved / frames);
+    qspiBytes = (int32_t)(bytes / frames);
+    memset(&s_rvStats, 0, sizeof(s_rvStats));
+}
@@ -6,17 +6,21 @@
  *   Display:  1.75" round AMOLED 466×466, CO5300 (QSPI)
  *   Touch:    CST9217  (I2C – GPIO14/SCL, GPIO15/SDA)
  *   RTC:      PCF85063 (I2C – shared bus with touch)
- *   CAN:      MCP2515  (SPI – see config.h for pin assignments)
+ *   CAN:      MCP2515  (SPI – see config.h for pin assignments), or the
+ *             ESP32-S3's TWAI controller with a transceiver (CAN_BACKEND)
  *
  * Screens:
  *   0 – Analog clock  (PCF85063 RTC)
  *   1 – Multi-arc gauges (boost, lambda/AFR, fuel pressure)
  *   2 – Analog boost gauge (needle, 0–3 bar)
- *   3 – Setup screen (unit selection: Metric / 'Merican)
+ *   3 – Engine gauges from a layout file (tachometer, coolant, oil pressure)
+ *   4 – Setup screen (unit selection: Metric / 'Merican)
  *
  * Libraries required (install via Arduino Library Manager):
  *   - LVGL            ≥ 9.0  (lv_conf.h: LV_COLOR_DEPTH 16, LV_FONT_UNSCII_8, LV_FONT_UNSCII_16)
- *   - mcp2515         by autowp (https://github.com/autowp/arduino-mcp2515)
+ *   - mcp2515         by autowp (https://github.com/autowp/arduino-mcp2515) –
+ *                     both backends: its can.h defines struct can_frame;
+ *                     CAN_BACKEND_MCP2515 also uses its driver
  *   - RTClib          by Adafruit
  *   - Waveshare BSP / TFT_eSPI configured for CO5300 QSPI display
  *       OR use the Waveshare-provided Arduino library for ESP32-S3-AMOLED-1.75
@@ -38,8 +42,13 @@
  *   MCP2515 GND   → GND
  *   Add 120Ω termination resistor between CANH and CANL externally.
  *
+ * TWAI wiring instead (CAN_BACKEND_TWAI – no MCP2515, a 3.3 V transceiver
+ * such as the SN65HVD230):
+ *   Transceiver TXD (D)  → GPIO 11    (CAN_TWAI_TX)
+ *   Transceiver RXD (R)  → GPIO 12    (CAN_TWAI_RX)
+ *
  * Setting the RTC time on first boot:
- *   Uncomment the lv_rtc.adjust() line in setup() below, upload once,
+ *   Uncomment the g_rtc.adjust() line in _i2cTask() below, upload once,
  *   then re-comment it and re-upload to avoid resetting time on every boot.
  * ─────────────────────────────────────────────────────────────────────────────
  */
@@ -49,18 +58,16 @@
 #include <SPI.h>
 #include <Wire.h>
 #include <Preferences.h>
+#include <LittleFS.h>
 
 // ── LVGL ─────────────────────────────────────────────────────────────────────
 #include <lvgl.h>
 // lv_conf.h must enable:
 //   LV_COLOR_DEPTH  16
 //   LV_FONT_UNSCII_8, LV_FONT_UNSCII_16
-//   LV_USE_ARC, LV_USE_SCALE
+//   LV_USE_ARC, LV_USE_CANVAS
 //   LV_USE_BTN, LV_USE_LABEL
 
-// ── MCP2515 CAN controller ────────────────────────────────────────────────────
-#include <mcp2515.h>
-
 // ── PCF85063 RTC ──────────────────────────────────────────────────────────────
 #include <RTClib.h>
 
@@ -80,23 +87,30 @@
 #include "config.h"
 #include "unit_convert.h"
 #include "can_handler.h"
+#include "can_backend.h"
+#include "ui_update.h"
+#include "round_viewport.h"
+#include "render_strategy.h"
+#include "task_signal.h"
+#include "ui_runtime.h"
 #include "screen_clock.h"
 #include "screen_multiarc.h"
 #include "screen_boostgauge.h"
+#include "screen_layout.h"
+#include "screen_channels.h"
 #include "screen_setup.h"
+#include "screen_manager.h"
 #include "gestures.h"
+#include "boot_profile.h"
+#include "trace_overlay.h"
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // Global variables
 // ═══════════════════════════════════════════════════════════════════════════════
 
 // ── Sensor data (defined here, declared extern in can_handler.h) ──────────────
-float    g_lambda       = 1.0f;   // dimensionless
-float    g_boostKpa     = 0.0f;   // kPa absolute
-float    g_fuelPressKpa = 0.0f;   // kPa
-uint16_t g_rpm          = 0;
-float    g_coolantC     = 20.0f;  // °C
-float    g_oilPressKpa  = 0.0f;   // kPa
+SensorRecord          g_sensorWork = SENSOR_RECORD_INIT;
+SeqLock<SensorRecord> g_sensors(g_sensorWork);
 
 // ── Unit system (true = Metric, false = Imperial/'Merican) ────────────────────
 bool g_isMetric = true;
@@ -104,27 +118,40 @@ bool g_isMetric = true;
 // ── Navigation state ──────────────────────────────────────────────────────────
 int       g_currentScreen = SCREEN_CLOCK;
 int       g_prevScreen    = SCREEN_CLOCK;
-lv_obj_t *g_screens[4]   = {};   // indexed by SCREEN_xxx constants
+lv_obj_t *g_screens[SCREEN_SETUP + 1] = {};   // indexed by SCREEN_xxx constants; nullptr until built
+
+// ── Screens, built on first use (screen_manager.h) ────────────────────────────
+static const ScreenDef kScreens[] = {
+    { "clock",    createClockScreen,       releaseClockScreen       },
+    { "multiarc", createMultiArcScreen,    releaseMultiArcScreen    },
+    { "boost",    createAnalogBoostScreen, releaseAnalogBoostScreen },
+    { "layout",   createLayoutScreen,      releaseLayoutScreen      },
+    { "setup",    createSetupScreen,       releaseSetupScreen       },
+};
+static ScreenManager s_screenMgr;
 
 // ── Peripheral objects ────────────────────────────────────────────────────────
-static MCP2515 g_mcp2515(CAN_SPI_CS);
+static CanBackend   g_can;                    // MCP2515 or TWAI (can_backend.h)
 static RTC_PCF85063 g_rtc;
 Preferences g_prefs;
 
-// ── LVGL display buffer ───────────────────────────────────────────────────────
-// Double-buffer DMA for smooth rendering on ESP32-S3 with PSRAM
-// Each buffer holds 1/10 of the screen pixels – placed in PSRAM if available
-static lv_color_t *s_buf1 = nullptr;
-static lv_color_t *s_buf2 = nullptr;
-#define DISP_BUF_LINES  46   // 466 / 10 ≈ 46 lines per buffer
+// Set by _i2cTask() once the bus, and then the RTC, may be used
+static std::atomic<bool> s_i2cReady{false};
+static std::atomic<bool> s_rtcReady{false};
 
-static bool s_rtcReady = false;
+// ── Tasks ─────────────────────────────────────────────────────────────────────
+// CAN task (core 0): empties the CAN controller into s_canQueue, decodes the queue
+// and publishes sensor records, then posts the changed channels to the UI task.
+// UI task (core 1): the only caller of LVGL (ui_runtime.h).
+// Log task (core 0, lowest priority): writes the data log (DATA_LOG).
+// I2C task (core 0, at boot only): starts the bus and probes the RTC.
+// loop() is unused.
+static CanFrameQueue<CAN_RX_QUEUE_LEN> s_canQueue;
+static TaskHandle_t s_canTask = nullptr;
+static TaskHandle_t s_uiTask  = nullptr;
+static TaskHandle_t s_logTask = nullptr;    // data logger writer (DATA_LOG)
 
-
-#if CAN_INT_PIN >= 0
-static volatile bool s_canMsgReady = false;
-static void IRAM_ATTR _canIsr(void) { s_canMsgReady = true; }
-#endif
+static CanDrainBudget s_canBudget;
 
 // ═══════════════════════════════════════════════════════════════════════════════
 // LVGL tick source
@@ -140,16 +167,26 @@ static void _lvTickTimerCb(void) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 /**
- * LVGL flush callback.
- * Transfers rendered pixels to the physical display.
+ * Send one window of pixels to the panel.
  * *** Replace the body with your actual Waveshare CO5300 driver call. ***
  */
-static void _displayFlush(lv_display_t *disp, const lv_area_t *area,
-                           uint8_t *colorMap) {
+static void _panelWrite(const lv_area_t *area, const uint8_t *px) {
     // Example for Waveshare BSP:
     //   waveshare_display_flush(area->x1, area->y1, area->x2, area->y2,
-    //                           (uint16_t *)colorMap);
-    //
+    //                           (uint16_t *)px);
+    (void)area;
+    (void)px;
+}
+
+/**
+ * LVGL flush callback.
+ * Transfers rendered pixels to the physical display, trimmed to the visible
+ * disc (round_viewport.h), as one or more windows through _panelWrite().
+ */
+static void _displayFlush(lv_display_t *disp, const lv_area_t *area,
+                           uint8_t *colorMap) {
+    TRACE_SCOPE("_displayFlush");
+    roundViewportFlush(disp, area, colorMap, renderIsFullFrame(), _panelWrite);
     // Always call lv_display_flush_ready() when the transfer is complete:
     lv_display_flush_ready(disp);
 }
@@ -165,6 +202,10 @@ static void _displayFlush(lv_display_t *disp, const lv_area_t *area,
  */
 static void _touchRead(lv_indev_t *indev, lv_indev_data_t *data) {
     (void)indev;
+    if (!s_i2cReady) {            // the bus is still being brought up (_i2cTask)
+        data->state = LV_INDEV_STATE_REL;
+        return;
+    }
     // Example for Waveshare BSP:
     //   uint16_t tx, ty;
     //   bool touched = waveshare_touch_read(&tx, &ty);
@@ -183,14 +224,16 @@ static void _touchRead(lv_indev_t *indev, lv_indev_data_t *data) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 /**
- * Load a screen by index.  Handles setup-screen housekeeping.
+ * Load a screen by index, building it first if it is not resident
+ * (screen_manager.h).  Handles setup-screen housekeeping.
  */
 void switchToScreen(int idx) {
     if (idx < 0 || idx > SCREEN_SETUP) return;
-    if (!g_screens[idx]) return;
+    lv_obj_t *scr = screenManagerGet(s_screenMgr, idx);
+    if (!scr) return;
 
     g_currentScreen = idx;
-    lv_scr_load_anim(g_screens[idx], LV_SCR_LOAD_ANIM_FADE_IN, 200, 0, false);
+    lv_scr_load_anim(scr, LV_SCR_LOAD_ANIM_FADE_IN, 200, 0, false);
 
     // Refresh setup highlight whenever we enter that screen
     if (idx == SCREEN_SETUP) {
@@ -203,79 +246,364 @@ void switchToScreen(int idx) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 /**
- * Poll the MCP2515 for pending messages and dispatch to parseCAN().
- * Called every loop iteration (or on interrupt flag).
+ * Configure the CAN controller (bitrate, acceptance filters, start) through
+ * the selected backend.  Runs at the top of _canTask(), on the CAN core,
+ * while setup() brings up the display on the other one.
+ */
+static void _canBringUp(void) {
+    int h = bootBegin(g_can.name());
+    g_can.begin();
+    bootEnd(h);
+}
+
+/**
+ * CAN task – moves frames from the CAN controller (can_backend.h: the
+ * MCP2515's two RX buffers, one SPI burst each, or the TWAI driver's queue)
+ * into s_canQueue, timestamping them, then drains the queue through the
+ * decoder.  Pinned to CAN_RX_TASK_CORE at high priority so a long LVGL
+ * render on the other core cannot stall reception or decoding.  The queue
+ * still decouples the two halves: a burst is read off the chip first, then
+ * decoded in batches with one sensor publish per batch.
+ *
+ * The task sleeps in the backend's wait() until frames may be pending, at
+ * most 5 ms: the MCP2515's INT pin (or a one-tick poll without it), or the
+ * TWAI driver's RX alert.
+ *
+ * Each pass decodes at most canDrainBudget() frames, so a backlog cannot
+ * keep the task away from the controller's RX buffers; what is left is
+ * decoded on the next pass, right after the chip is emptied again.
+ */
+static void _canTask(void *arg) {
+    (void)arg;
+    traceThreadName("can");
+    _canBringUp();
+    bootParallelEnd();
+    CanRxFrame rx;
+    uint32_t lastDropped = 0;
+    bool     backlog     = false;
+    for (;;) {
+        g_can.wait(backlog ? 0 : 5);
+        {
+            TRACE_SCOPE("can read");
+            uint32_t irqUs = g_can.takeIrqUs();
+            struct can_frame frames[2];
+            while (uint8_t n = g_can.read(frames)) {
+                rx.tsUs = micros();
+                for (uint8_t i = 0; i < n; i++) {
+                    rx.frame = frames[i];
+                    s_canQueue.push(rx);   // full queue → counted in dropped()
+                }
+                if (irqUs) {
+                    canHealthIrqLatency(rx.tsUs - irqUs);
+                    irqUs = 0;
+                }
+            }
+        }
+
+        uint32_t t0     = micros();
+        uint32_t budget = canDrainBudget(s_canBudget, s_canQueue.pushed(), t0,
+                                         s_canQueue.capacity());
+        size_t   n      = drainCANQueue(s_canQueue, budget);
+        canDrainCost(s_canBudget, n, micros() - t0);
+        backlog = s_canQueue.size() > 0;
+        uiRuntimePost(s_uiRuntime, takeSensorChanges());
+        g_can.pollErrors();
+
+        uint32_t dropped = s_canQueue.dropped();
+        if (dropped != lastDropped) {
+            lastDropped = dropped;
+            Serial.printf("[CAN] RX queue overflow: dropped=%lu hwm=%lu/%u\n",
+                          (unsigned long)dropped,
+                          (unsigned long)s_canQueue.highWater(),
+                          (unsigned)s_canQueue.capacity());
+        }
+    }
+}
+
+/**
+ * Load the layout screen's layout from GAUGE_LAYOUT_FILE on LittleFS, or
+ * keep the built-in one if there is no such file or it is invalid.
+ */
+static void _loadGaugeLayout(void) {
+    const char *err      = nullptr;
+    bool        fromFile = false;
+    if (LittleFS.begin(true) && LittleFS.exists(GAUGE_LAYOUT_FILE)) {
+        File f = LittleFS.open(GAUGE_LAYOUT_FILE, "r");
+        size_t len = f ? f.size() : 0;
+        uint8_t *buf = len ? (uint8_t *)malloc(len) : nullptr;
+        err = (buf && f.read(buf, len) == len) ? layoutScreenLoad(buf, len) : "read failed";
+        fromFile = !err;
+        free(buf);
+        f.close();
+    }
+    if (err) Serial.printf("[SCR] %s rejected: %s\n", GAUGE_LAYOUT_FILE, err);
+    if (!fromFile) layoutScreenLoad(nullptr, 0);
+    Serial.printf("[SCR] layout %s, %u widgets\n", fromFile ? GAUGE_LAYOUT_FILE : "built-in",
+                  (unsigned)s_layout.hdr.count);
+}
+
+#if DATA_LOG
+/**
+ * /littlefs/logNNNN.rlog for the next NVS sequence number, removing the log
+ * LOG_KEEP_FILES before it so only the newest LOG_KEEP_FILES are kept.
+ * At boot and, as a DataLogNextPath, whenever the writer fills a file.
+ */
+static bool _nextLogPath(char *path, size_t size) {
+    uint16_t seq = g_prefs.getUShort(NVS_KEY_LOG_SEQ, 0);
+    g_prefs.putUShort(NVS_KEY_LOG_SEQ, (uint16_t)((seq + 1) % 10000));
+    snprintf(path, size, "/log%04u.rlog", (unsigned)((seq + 10000 - LOG_KEEP_FILES) % 10000));
+    LittleFS.remove(path);                       // LittleFS paths are relative to its mount point
+    snprintf(path, size, "/littlefs/log%04u.rlog", (unsigned)seq);
+    return true;
+}
+
+static char s_logPath[32];                   // first log of this boot
+
+/**
+ * Log writer task – moves the decoder's encoded blocks from PSRAM to
+ * LittleFS in LOG_WRITE_BATCH writes (data_logger.h).  Lowest priority on
+ * the CAN core: a slow flash erase delays only this task, never decoding
+ * or rendering.  It opens the log itself once bound, so no seal post of
+ * the decoder is lost to a TaskSignal without a task.
+ */
+static void _logTask(void *arg) {
+    (void)arg;
+    s_dataLog.signal.bindCurrentTask();
+    traceThreadName("log");
+    if (!dataLogBegin(s_logPath, _nextLogPath)) {
+        Serial.printf("[LOG] cannot start %s – logging disabled\n", s_logPath);
+        s_logTask = nullptr;
+        vTaskDelete(nullptr);
+    }
+    Serial.printf("[LOG] recording to %s (%lu/%lu kB used)\n", s_logPath,
+                  (unsigned long)(LittleFS.usedBytes() / 1024),
+                  (unsigned long)(LittleFS.totalBytes() / 1024));
+    for (;;) dataLogWriterStep();
+}
+
+/**
+ * Open the first log of this boot in the writer task.  Full files roll
+ * over to the next (_nextLogPath()), so the flash holds the latest
+ * LOG_KEEP_FILES × LOG_MAX_FILE_BYTES of the drive.
+ */
+static void _startDataLog(void) {
+    if (!LittleFS.begin(true)) {
+        Serial.println("[LOG] LittleFS mount failed – logging disabled");
+        return;
+    }
+    _nextLogPath(s_logPath, sizeof(s_logPath));
+    xTaskCreatePinnedToCore(_logTask, "log", LOG_TASK_STACK, nullptr,
+                            LOG_TASK_PRIO, &s_logTask, LOG_TASK_CORE);
+}
+#endif
+
+// ═══════════════════════════════════════════════════════════════════════════════
+// UI task
+// ═══════════════════════════════════════════════════════════════════════════════
+
+/**
+ * Per-screen widget refresh, scheduled by uiRuntimeStep().
+ * @return true while a gauge is still animating
  */
-static void _readCAN(void) {
-    struct can_frame frame;
-
-    // Read up to 8 frames per call to avoid blocking the LVGL handler
-    for (int i = 0; i < 8; i++) {
-        if (g_mcp2515.readMessage(&frame) == MCP2515::ERROR_OK) {
-            parseCAN(frame.can_id, frame.can_dlc, frame.data);
-        } else {
+static bool _updateScreen(int screen) {
+    switch (screen) {
+        case SCREEN_CLOCK: {
+            // Read time from RTC (only if initialised successfully)
+            if (s_rtcReady) {
+                DateTime t = g_rtc.now();
+                updateClockScreen(t.hour(), t.minute(), t.second());
+            }
+            break;
+        }
+        case SCREEN_MULTIARC:
+            return updateMultiArcScreen();
+        case SCREEN_BOOSTGAUGE:
+            return updateAnalogBoostScreen();
+        case SCREEN_LAYOUT:
+            return updateLayoutScreen();
+        case SCREEN_SETUP:
+            // No continuous update needed; changes are event-driven
             break;
+    }
+    return false;
+}
+
+/** Redraw and scheduling statistics, every UI_STATS_PERIOD_MS. */
+static void _logUiStats(void) {
+    static uint32_t lastStatsMs = 0;
+    uint32_t now = millis();
+    if (now - lastStatsMs < UI_STATS_PERIOD_MS) return;
+    lastStatsMs = now;
+
+    Serial.printf("[UI] invalidated %lu px/s\n",
+                  (unsigned long)uiStatsInvalidatedPxPerSec());
+    uint32_t rvPx;
+    int32_t  rvBytes;
+    roundViewportReport(rvPx, rvBytes);
+    Serial.printf("[UI] round viewport saved %lu px and %ld QSPI bytes per frame\n",
+                  (unsigned long)rvPx, (long)rvBytes);
+    uint32_t wakeups, updates;
+    uiRuntimeStats(s_uiRuntime, UI_STATS_PERIOD_MS, wakeups, updates);
+    Serial.printf("[UI] task woke %lu/s, %lu screen updates/s\n",
+                  (unsigned long)wakeups, (unsigned long)updates);
+    UiLatencyReport lat = uiRuntimeLatency(s_uiRuntime);
+    Serial.printf("[UI] decode→update latency: n=%lu p50<%lu p90<%lu p99<%lu max=%lu us\n",
+                  (unsigned long)lat.count, (unsigned long)lat.p50Us, (unsigned long)lat.p90Us,
+                  (unsigned long)lat.p99Us, (unsigned long)lat.maxUs);
+    char summary[512];
+    Serial.printf("[SCR] %s\n", screenManagerFormat(s_screenMgr, summary, sizeof(summary)));
+    Serial.printf("[CANH] %s\n", canHealthFormat(canHealthReport(UI_STATS_PERIOD_MS,
+                                                                  s_canQueue.dropped()),
+                                                  summary, sizeof(summary)));
+    Serial.printf("[CANB] %s: %s\n", g_can.name(), g_can.format(summary, sizeof(summary)));
+    Serial.printf("[STATS] %s\n", sensorStatsFormat(readSensorStats(), SENSOR_DISPLAY_MASK,
+                                                    summary, sizeof(summary)));
+#if DATA_LOG
+    if (s_logTask) {
+        DataLogReport log = dataLogReport(UI_STATS_PERIOD_MS);
+        Serial.printf("[LOG] %lu rows/s, %.1f B/row, %lu B/s written at %lu kB/s, "
+                      "dropped %lu blocks; max encode %lu us (CAN task), max write %lu us\n",
+                      (unsigned long)log.rowsPerSec, log.bytesPerRow,
+                      (unsigned long)log.bytesPerSec, (unsigned long)log.writeKBps,
+                      (unsigned long)log.droppedBlocks, (unsigned long)log.encodeUsMax,
+                      (unsigned long)log.writeUsMax);
+    }
+#endif
+}
+
+/** The boot timeline (boot_profile.h), once every bring-up phase has ended. */
+static void _logBootTimeline(void) {
+    static bool logged = false;
+    if (logged || !bootProfileComplete()) return;
+    logged = true;
+    char line[112];
+    Serial.printf("[BOOT] %d phases, done after %.1f ms:\n", bootProfileCount(),
+                  bootProfileEndUs() / 1000.0f);
+    for (int i = 0; i < bootProfileCount(); i++) {
+        Serial.printf("[BOOT] %s\n", bootProfileLine(i, line, sizeof(line)));
+    }
+}
+
+#if TRACE_ENABLED
+static void _serialWrite(const char *s, size_t n, void *ctx) {
+    (void)ctx;
+    Serial.write((const uint8_t *)s, n);
+}
+
+/**
+ * Trace commands over serial: 't' prints the trace ring as Chrome trace
+ * JSON between [TRACE] lines (save it as a .json file and open it in
+ * ui.perfetto.dev), 'o' shows or hides the perf overlay.
+ */
+static void _traceCommands(void) {
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c == 't') {
+            Serial.println("[TRACE] begin");
+            uint32_t n = traceWriteChrome(_serialWrite, nullptr);
+            Serial.printf("[TRACE] end, %lu spans\n", (unsigned long)n);
+        } else if (c == 'o') {
+            traceOverlayShow(!traceOverlayShown());
         }
     }
+}
+#endif
 
-#if CAN_INT_PIN >= 0
-    s_canMsgReady = false;
+/**
+ * UI task – runs LVGL and the per-screen updates on UI_TASK_CORE, blocking
+ * between passes until the next LVGL timer is due or the CAN task signals
+ * a change to a displayed channel.
+ */
+static void _uiTask(void *arg) {
+    (void)arg;
+    s_uiRuntime.signal.bindCurrentTask();
+    traceThreadName("ui");
+    uint32_t bits = 0;
+    for (;;) {
+        int screen = g_currentScreen;
+        uint32_t waitMs = uiRuntimeStep(s_uiRuntime, bits, screen, screenChannels(screen),
+                                        screen == SCREEN_CLOCK, _updateScreen,
+                                        UI_MAX_SLEEP_MS);
+        // Nothing due for a frame: build or delete a screen in the gap
+        if (waitMs >= UI_ANIM_FRAME_MS && screenManagerIdle(s_screenMgr)) waitMs = 0;
+        _logUiStats();
+        _logBootTimeline();
+        traceOverlayUpdate();
+#if TRACE_ENABLED
+        _traceCommands();
 #endif
+        bits = s_uiRuntime.signal.wait(waitMs);
+    }
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
-// Setup
+// Boot
 // ═══════════════════════════════════════════════════════════════════════════════
 
-void setup(void) {
-    Serial.begin(115200);
-    Serial.println("[roundie] Booting…");
-
-    // ── I2C (touch + RTC share the same bus) ──────────────────────────────
+/**
+ * I2C bring-up task – starts the bus shared by touch and the RTC and probes
+ * the PCF85063, on the CAN core while setup() starts the display, then
+ * exits.  A missing RTC can take the whole probe timeout; the first frame
+ * no longer waits for it.
+ */
+static void _i2cTask(void *arg) {
+    (void)arg;
+    int h = bootBegin("i2c + rtc");
     Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+    s_i2cReady = true;
 
-    // ── RTC ───────────────────────────────────────────────────────────────
     if (!g_rtc.begin(&Wire)) {
         Serial.println("[RTC] PCF85063 not found – continuing without RTC");
     } else {
-        s_rtcReady = true;
         if (!g_rtc.initialized() || g_rtc.lostPower()) {
             Serial.println("[RTC] Power loss detected – set time manually");
             // *** Uncomment and adjust the line below on first upload to set time:
             // g_rtc.adjust(DateTime(2025, 1, 1, 12, 0, 0));
         }
         Serial.println("[RTC] OK");
+        s_rtcReady = true;   // from here the UI task reads the time
     }
+    bootEnd(h);
+    bootParallelEnd();
+    vTaskDelete(nullptr);
+}
 
-    // ── MCP2515 SPI ───────────────────────────────────────────────────────
-    SPI.begin(CAN_SPI_SCK, CAN_SPI_MISO, CAN_SPI_MOSI, CAN_SPI_CS);
-    g_mcp2515.reset();
-    if (g_mcp2515.setBitrate(CAN_SPEED, MCP_8MHZ) == MCP2515::ERROR_OK) {
-        Serial.println("[CAN] Bitrate set");
-    } else {
-        Serial.println("[CAN] WARNING: setBitrate failed – check MCP2515 crystal");
-    }
+/**
+ * The first frame: a black screen with the name.  Nothing to paint, so it
+ * reaches the panel right after LVGL is up; the clock fades in over it
+ * once its dial face is built.
+ */
+static lv_obj_t *_createSplash(void) {
+    lv_obj_t *scr = lv_obj_create(nullptr);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    lv_obj_t *lbl = lv_label_create(scr);
+    lv_label_set_text(lbl, "roundie");
+    lv_obj_set_style_text_font(lbl, &lv_font_unscii_16, 0);
+    lv_obj_set_style_text_color(lbl, lv_color_make(0x60, 0x60, 0x60), 0);
+    lv_obj_center(lbl);
+    return scr;
+}
 
-    // Accept only the three Haltech CAN V2 IDs we care about
-    // MCP2515 mask/filter setup: use mask 0 (RXB0) for first two IDs,
-    // mask 1 (RXB1) for the third.
-    g_mcp2515.setFilterMask(MCP2515::MASK0, false, 0x7FF);
-    g_mcp2515.setFilter(MCP2515::RXF0, false, CAN_ID_LAMBDA_BOOST_FUELPRES);
-    g_mcp2515.setFilter(MCP2515::RXF1, false, CAN_ID_RPM);
-    g_mcp2515.setFilterMask(MCP2515::MASK1, false, 0x7FF);
-    g_mcp2515.setFilter(MCP2515::RXF2, false, CAN_ID_COOLANT_OILPRES);
-    g_mcp2515.setFilter(MCP2515::RXF3, false, CAN_ID_COOLANT_OILPRES);
-    g_mcp2515.setFilter(MCP2515::RXF4, false, CAN_ID_COOLANT_OILPRES);
-    g_mcp2515.setFilter(MCP2515::RXF5, false, CAN_ID_COOLANT_OILPRES);
-
-    g_mcp2515.setNormalMode();
-    Serial.println("[CAN] MCP2515 ready");
-
-#if CAN_INT_PIN >= 0
-    pinMode(CAN_INT_PIN, INPUT);
-    attachInterrupt(digitalPinToInterrupt(CAN_INT_PIN), _canIsr, FALLING);
-    Serial.println("[CAN] Interrupt-driven RX enabled");
-#endif
+// ═══════════════════════════════════════════════════════════════════════════════
+// Setup
+// ═══════════════════════════════════════════════════════════════════════════════
+
+void setup(void) {
+    int hSetup = bootBegin("setup");
+    traceThreadName("setup");
+    Serial.begin(115200);
+    Serial.println("[roundie] Booting…");
+
+    // ── Parallel bring-up on the CAN core ─────────────────────────────────
+    // The I2C probe (RTC) and the CAN controller setup share nothing with
+    // the display or with each other; they run on core 0 while this core
+    // gets the first frame on the panel.
+    bootParallelBegin();
+    xTaskCreatePinnedToCore(_i2cTask, "i2c", 3072, nullptr,
+                            CAN_RX_TASK_PRIO - 1, nullptr, CAN_RX_TASK_CORE);
+    bootParallelBegin();   // ended by _canTask() once the CAN controller is ready
+    xTaskCreatePinnedToCore(_canTask, "can", 4096, nullptr,
+                            CAN_RX_TASK_PRIO, &s_canTask, CAN_RX_TASK_CORE);
 
     // ── Display + touch initialisation ───────────────────────────────────
     // *** Replace with your Waveshare BSP init call, e.g.:
@@ -283,27 +611,32 @@ void setup(void) {
     // waveshare_touch_init();
     Serial.println("[DISP] Display init (placeholder)");
 
+    // ── NVS: load saved preferences ──────────────────────────────────────
+    int h = bootBegin("nvs");
+    g_prefs.begin(NVS_NAMESPACE, false);
+    g_isMetric = g_prefs.getBool(NVS_KEY_IS_METRIC, true);  // default: Metric
+    Serial.printf("[NVS] isMetric = %s\n", g_isMetric ? "true" : "false");
+    bootEnd(h);
+
     // ── LVGL initialisation ───────────────────────────────────────────────
+    h = bootBegin("lvgl");
     lv_init();
 
-    // Allocate draw buffers in PSRAM
-    s_buf1 = (lv_color_t *)heap_caps_malloc(
-        DISPLAY_WIDTH * DISP_BUF_LINES * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
-    s_buf2 = (lv_color_t *)heap_caps_malloc(
-        DISPLAY_WIDTH * DISP_BUF_LINES * sizeof(lv_color_t), MALLOC_CAP_SPIRAM);
-    if (!s_buf1 || !s_buf2) {
-        // Fallback to internal RAM with a smaller buffer
-        static lv_color_t fallbackBuf1[DISPLAY_WIDTH * 10];
-        static lv_color_t fallbackBuf2[DISPLAY_WIDTH * 10];
-        s_buf1 = fallbackBuf1;
-        s_buf2 = fallbackBuf2;
-        Serial.println("[LVGL] PSRAM unavailable – using internal RAM buffer");
-    }
+    // Draw buffers per the saved (or configured) render strategy; see
+    // render_strategy.h for the options and the low-memory fallbacks
     lv_display_t *disp = lv_display_create(DISPLAY_WIDTH, DISPLAY_HEIGHT);
     lv_display_set_flush_cb(disp, _displayFlush);
-    lv_display_set_buffers(disp, s_buf1, s_buf2,
-                           DISPLAY_WIDTH * DISP_BUF_LINES * sizeof(lv_color_t),
-                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+    RenderConfig render = {
+        g_prefs.getUChar(NVS_KEY_RENDER_MODE, RENDER_STRATEGY),
+        g_prefs.getUShort(NVS_KEY_RENDER_LINES, RENDER_BUF_LINES)
+    };
+    render = renderApply(disp, render);
+    Serial.printf("[LVGL] render strategy %s, %u lines\n",
+                  renderStrategyName(render.strategy), (unsigned)render.lines);
+    roundViewportInstall(disp);   // first, so later handlers see clipped areas
+    uiStatsInstall(disp);
+    traceOverlayInstall(disp);
+    traceOverlayShow(TRACE_OVERLAY);
 
     // Register touch input device
     lv_indev_t *indev = lv_indev_create();
@@ -319,25 +652,75 @@ void setup(void) {
     timerAttachInterrupt(lvTimer, _lvTickTimerCb, true);
     timerAlarmWrite(lvTimer, LV_TICK_PERIOD_MS * 1000UL, true);
     timerAlarmEnable(lvTimer);
+    bootEnd(h);
+
+    // ── First frame: the splash, before anything slow ─────────────────────
+    lv_obj_t *splash = _createSplash();
+    lv_screen_load(splash);
+    lv_refr_now(disp);
+    bootMark("first frame");
+
+    // ── Screens are built on first use; the clock by switchToScreen() ─────
+    // The layout must be loaded before the UI task may pre-warm its screen
+    h = bootBegin("layout");
+    _loadGaugeLayout();
+    bootEnd(h);
+    screenManagerInit(s_screenMgr, kScreens, SCREEN_SETUP + 1, g_screens,
+                      SCREEN_HEAP_BUDGET, gestureAttachScreen);
+
+#if RENDER_CALIBRATE
+    // ── Render strategy calibration ───────────────────────────────────────
+    // Needs every screen; those over the budget are deleted again once idle
+    h = bootBegin("calibrate");
+    for (int i = 0; i <= SCREEN_SETUP; i++) screenManagerGet(s_screenMgr, i);
+    RenderCalResult cal[RENDER_CANDIDATE_COUNT];
+    render = renderCalibrate(disp, g_screens, SCREEN_SETUP + 1, RENDER_CAL_FRAMES, cal);
+    for (size_t i = 0; i < RENDER_CANDIDATE_COUNT; i++) {
+        Serial.printf("[LVGL] calibrate %-13s %3u lines: %6lu us/frame "
+                      "(clock %lu, multiarc %lu, boost %lu, layout %lu, setup %lu)\n",
+                      renderStrategyName(cal[i].used.strategy), (unsigned)cal[i].used.lines,
+                      (unsigned long)cal[i].meanUs,
+                      (unsigned long)cal[i].screenUs[SCREEN_CLOCK],
+                      (unsigned long)cal[i].screenUs[SCREEN_MULTIARC],
+                      (unsigned long)cal[i].screenUs[SCREEN_BOOSTGAUGE],
+                      (unsigned long)cal[i].screenUs[SCREEN_LAYOUT],
+                      (unsigned long)cal[i].screenUs[SCREEN_SETUP]);
+    }
+    g_prefs.putUChar(NVS_KEY_RENDER_MODE, render.strategy);
+    g_prefs.putUShort(NVS_KEY_RENDER_LINES, render.lines);
+    Serial.printf("[LVGL] fastest: %s, %u lines (saved)\n",
+                  renderStrategyName(render.strategy), (unsigned)render.lines);
+    bootEnd(h);
+#endif
 
-    // ── NVS: load saved unit preference ──────────────────────────────────
-    g_prefs.begin(NVS_NAMESPACE, false);
-    g_isMetric = g_prefs.getBool(NVS_KEY_IS_METRIC, true);  // default: Metric
-    Serial.printf("[NVS] isMetric = %s\n", g_isMetric ? "true" : "false");
-
-    // ── Create all LVGL screens ───────────────────────────────────────────
-    g_screens[SCREEN_CLOCK]      = createClockScreen();
-    g_screens[SCREEN_MULTIARC]   = createMultiArcScreen();
-    g_screens[SCREEN_BOOSTGAUGE] = createAnalogBoostScreen();
-    g_screens[SCREEN_SETUP]      = createSetupScreen();
-
-    // ── Install gesture/long-press handlers ───────────────────────────────
+    // ── Long-press timer; screens get their handlers as they are built ────
     installGestureHandlers();
 
-    // ── Load default screen ───────────────────────────────────────────────
+    // ── Load default screen, fading in over the splash ────────────────────
+    h = bootBegin("clock screen");
     switchToScreen(SCREEN_CLOCK);
+    bootEnd(h);
+    lv_obj_delete_delayed(splash, 1000);   // after the fade, from the UI task
+    Serial.printf("[SCR] clock built in %lu us, %ld bytes\n",
+                  (unsigned long)s_screenMgr.info[SCREEN_CLOCK].createUs,
+                  (long)s_screenMgr.info[SCREEN_CLOCK].heapBytes);
+
+    // ── Hand LVGL over to the UI task ─────────────────────────────────────
+    // From here on only _uiTask() touches LVGL objects.
+    xTaskCreatePinnedToCore(_uiTask, "ui", UI_TASK_STACK, nullptr,
+                            UI_TASK_PRIO, &s_uiTask, UI_TASK_CORE);
+
+#if DATA_LOG
+    // ── Data logger (recording starts with the next decoded frame) ────────
+    // Last: a first boot formats LittleFS, which is not worth a late first frame
+    h = bootBegin("data log");
+    _startDataLog();
+    bootEnd(h);
+#endif
 
     Serial.println("[roundie] Setup complete");
+    bootEnd(hSetup);
+    bootProfileSetupDone();
 }
 
 // ═══════════════════════════════════════════════════════════════════════════════
@@ -345,45 +728,7 @@ void setup(void) {
 // ═══════════════════════════════════════════════════════════════════════════════
 
 void loop(void) {
-    // ── LVGL task handler ─────────────────────────────────────────────────
-    lv_timer_handler();
-
-    // ── CAN message processing ────────────────────────────────────────────
-#if CAN_INT_PIN >= 0
-    if (s_canMsgReady) {
-        _readCAN();
-    }
-#else
-    _readCAN();
-#endif
-
-    // ── Per-screen UI updates ─────────────────────────────────────────────
-    static uint32_t lastUpdateMs = 0;
-    uint32_t now = millis();
-    if (now - lastUpdateMs >= 100) {   // update UI at ~10 Hz
-        lastUpdateMs = now;
-
-        switch (g_currentScreen) {
-            case SCREEN_CLOCK: {
-                // Read time from RTC (only if initialised successfully)
-                if (s_rtcReady) {
-                    DateTime t = g_rtc.now();
-                    updateClockScreen(t.hour(), t.minute(), t.second());
-                }
-                break;
-            }
-            case SCREEN_MULTIARC:
-                updateMultiArcScreen();
-                break;
-            case SCREEN_BOOSTGAUGE:
-                updateAnalogBoostScreen();
-                break;
-            case SCREEN_SETUP:
-                // No continuous update needed; changes are event-driven
-                break;
-        }
-    }
-
-    // Small yield to keep watchdog happy
-    delay(1);
+    // All work runs in _canTask() and _uiTask(); the Arduino loop task is
+    // not needed once setup() has started them.
+    vTaskDelete(nullptr);
 }
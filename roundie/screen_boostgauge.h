@@ -10,9 +10,12 @@
  *   - Orange needle, smoothly animated
  *   - "bar" or "psi" unit label below center
  *
- * Range: 0–3.0 bar absolute (0–300 kPa, 0–43.5 psi)
+ * Range: 0–3.0 bar absolute (0–300 kPa), or 0–45 psi in imperial units.
+ * The dial's scale, ticks and numerals come from a per-unit-system table
+ * (unit_convert.h) and are rebuilt only when the unit system changes.
  *
- * Implemented with lv_meter (LVGL 8) – lv_scale is used in LVGL 9.
+ * Implemented with lv_meter on LVGL 8.  On LVGL 9 the dial face is painted
+ * once into a cached canvas and only the needle is redrawn.
  * Compile-time guard selects the correct API.
  */
 
@@ -21,17 +24,109 @@
 #include <lvgl.h>
 #include "config.h"
 #include "can_handler.h"
+#include "sensor_interp.h"
 #include "unit_convert.h"
+#include "dial_face.h"
+#include "ui_update.h"
+#include "trace.h"
 
 extern bool g_isMetric;
 
 static lv_obj_t *s_bgScreen      = nullptr;  // Screen 3 container
 static lv_obj_t *s_bgMeter       = nullptr;  // lv_meter widget
 static lv_obj_t *s_bgUnitLabel   = nullptr;  // "bar" / "psi"
+static UiLabel   s_uiBgUnit;
+static int       s_bgUnitSys     = -1;       // applied UnitSystem, -1 = none yet
+
+/** Channels shown by this screen (ui_runtime.h refreshes it when they change). */
+#define BOOSTGAUGE_CHANNELS  SENSOR_CH_BIT(CH_BOOST_KPA)
+static_assert(CH_BOOST_KPA < SENSOR_DISPLAY_COUNT,
+              "BOOSTGAUGE_CHANNELS need @tune lines in haltech_v2.sig");
 
 #if LVGL_VERSION_MAJOR >= 9
-// ── LVGL 9 implementation (lv_scale) ─────────────────────────────────────────
-static lv_obj_t *s_bgScale = nullptr;
+// ── LVGL 9 implementation (cached face + line needle) ────────────────────────
+// The dial – scale arc, ticks, major labels – only changes with the unit
+// system, so it is painted into a cached canvas (dial_face.h) when the
+// screen is created or the units change; only the needle, an anti-aliased
+// line (dial_hand.h), is redrawn per frame.  Angles follow lv_scale's
+// round-mode defaults: 0 at 135° (lower left), 270° clockwise sweep to full
+// scale (lower right).
+static lv_obj_t *s_bgFace   = nullptr;   // cached dial face canvas
+static lv_obj_t   *s_bgNeedle = nullptr; // needle host object
+static DialHandSet s_bgHands;
+static int         s_bgHand   = 0;       // the needle's index in s_bgHands
+static UiNeedle    s_uiBgNeedle;
+
+#define BOOST_DIAL_SIZE     400
+#define BOOST_NEEDLE_LEN    150
+#define BOOST_DIAL_START    135   // angle of 0 kPa (0° = 3 o'clock, clockwise)
+#define BOOST_DIAL_SWEEP    270
+
+/** Dial of one unit system: needle map (with ticks) and major-tick numerals. */
+struct BoostDialUnits {
+    GaugeMap<PressureTag> needle;
+    const char *const    *labels;   // one per major tick, string literals
+};
+
+static const char *const kBoostLabelsBar[] = { "0", "0.5", "1.0", "1.5", "2.0", "2.5", "3.0" };
+static const char *const kBoostLabelsPsi[] = { "0", "5", "10", "15", "20", "25", "30", "35",
+                                               "40", "45" };
+
+// Needle in thousandths of a bar (= tenths of a kPa) or hundredths of a psi
+static const BoostDialUnits kBoostDialUnits[UNIT_SYSTEM_COUNT] = {
+    { gaugeMap(kUnitBar, 0.0f, 3.0f,  1000, 0.1f, 5), kBoostLabelsBar },
+    { gaugeMap(kUnitPsi, 0.0f, 45.0f, 100,  1.0f, 5), kBoostLabelsPsi },
+};
+
+static const BoostDialUnits *s_bgUnits = &kBoostDialUnits[UNITS_METRIC];
+
+static void _paintBoostFace(lv_layer_t *layer, int32_t size) {
+    const int32_t c = size / 2;
+    const int32_t r = size / 2 - 2;
+
+    lv_draw_arc_dsc_t arc;
+    lv_draw_arc_dsc_init(&arc);
+    arc.color       = lv_color_make(0x44, 0x44, 0x44);
+    arc.width       = 2;
+    arc.center.x    = c;
+    arc.center.y    = c;
+    arc.radius      = (uint16_t)(r + 1);
+    arc.start_angle = BOOST_DIAL_START;
+    arc.end_angle   = (BOOST_DIAL_START + BOOST_DIAL_SWEEP) % 360;
+    lv_draw_arc(layer, &arc);
+
+    const GaugeMap<PressureTag> &m = s_bgUnits->needle;
+    const int32_t ticks = m.ticks();
+    for (int i = 0; i < ticks; i++) {
+        bool isMajor = (i % m.majorEvery == 0);
+        int32_t deg = BOOST_DIAL_START + i * BOOST_DIAL_SWEEP / (ticks - 1);
+        deg %= 360;
+        dialPaintRadial(layer, c, c, r - (isMajor ? 20 : 10), r, deg, 2,
+                        isMajor ? lv_color_white() : lv_color_make(0x80, 0x80, 0x80));
+        if (isMajor) {
+            int32_t lr = r - 20 - 18;
+            int32_t x = c + ((lv_trigo_cos((int16_t)deg) * lr) >> LV_TRIGO_SHIFT);
+            int32_t y = c + ((lv_trigo_sin((int16_t)deg) * lr) >> LV_TRIGO_SHIFT);
+            dialPaintText(layer, x, y, s_bgUnits->labels[i / m.majorEvery], LV_FONT_DEFAULT,
+                          lv_color_white());
+        }
+    }
+}
+
+/**
+ * Switch the dial to unit system us: repaint the face, rescale the needle
+ * and show the unit label.
+ */
+static void _bgApplyUnits(UnitSystem us) {
+    s_bgUnits   = &kBoostDialUnits[us];
+    s_bgUnitSys = us;
+    if (s_bgFace) lv_obj_delete(s_bgFace);
+    s_bgFace = dialFaceCreate(s_bgScreen, BOOST_DIAL_SIZE, lv_color_black(), _paintBoostFace);
+    if (s_bgFace) lv_obj_move_background(s_bgFace);
+    const GaugeMap<PressureTag> &m = s_bgUnits->needle;
+    uiNeedleInit(s_uiBgNeedle, s_bgHands, s_bgHand, m.lo, m.hi, BOOST_DIAL_START, BOOST_DIAL_SWEEP);
+    uiLabelSetStatic(s_uiBgUnit, m.label);
+}
 
 static lv_obj_t *createAnalogBoostScreen(void) {
     s_bgScreen = lv_obj_create(nullptr);
@@ -39,58 +134,77 @@ static lv_obj_t *createAnalogBoostScreen(void) {
     lv_obj_set_style_bg_opa(s_bgScreen, LV_OPA_COVER, 0);
     lv_obj_clear_flag(s_bgScreen, LV_OBJ_FLAG_SCROLLABLE);
 
-    // Use lv_scale in round/arc mode
-    s_bgScale = lv_scale_create(s_bgScreen);
-    lv_obj_set_size(s_bgScale, 400, 400);
-    lv_obj_align(s_bgScale, LV_ALIGN_CENTER, 0, 0);
-    lv_scale_set_mode(s_bgScale, LV_SCALE_MODE_ROUND_INNER);
-
-    // Range: 0-300 (kPa × 0.1 = bar; we display bar so map 0-30 internally → ×10)
-    lv_scale_set_range(s_bgScale, 0, 300);
-    lv_scale_set_total_tick_count(s_bgScale, 31);   // 0 to 30 → 31 ticks (×10 = 0–300 kPa)
-    lv_scale_set_major_tick_every(s_bgScale, 5);    // every 0.5 bar
-    lv_obj_set_style_length(s_bgScale, 20, LV_PART_INDICATOR);
-    lv_obj_set_style_length(s_bgScale, 10, LV_PART_ITEMS);
-
-    // Needle (orange)
-    static int32_t needleVal = 0;
-    lv_scale_set_line_needle_value(s_bgScale, s_bgScale, 150, needleVal);
-
-    // Color scheme
-    lv_obj_set_style_arc_color(s_bgScale, lv_color_make(0x44, 0x44, 0x44), LV_PART_MAIN);
-    lv_obj_set_style_line_color(s_bgScale, lv_color_white(), LV_PART_INDICATOR);
-    lv_obj_set_style_line_color(s_bgScale, lv_color_make(0x80, 0x80, 0x80), LV_PART_ITEMS);
-    lv_obj_set_style_text_color(s_bgScale, lv_color_white(), LV_PART_INDICATOR);
-
     // Unit label
     s_bgUnitLabel = lv_label_create(s_bgScreen);
     lv_label_set_text(s_bgUnitLabel, "bar");
     lv_obj_set_style_text_color(s_bgUnitLabel, lv_color_make(0xAA, 0xAA, 0xAA), 0);
     lv_obj_set_style_text_font(s_bgUnitLabel, &lv_font_unscii_16, 0);
     lv_obj_align(s_bgUnitLabel, LV_ALIGN_CENTER, 0, 80);
+    uiLabelInit(s_uiBgUnit, s_bgUnitLabel);
+
+    // Needle (orange line pivoting on the screen centre, short tail).  A move
+    // invalidates a strip along the old and new needle, not the whole dial.
+    s_bgNeedle = dialHandsCreate(s_bgHands, s_bgScreen, DISPLAY_WIDTH / 2, DISPLAY_HEIGHT / 2,
+                                 BOOST_NEEDLE_LEN + 4);
+    s_bgHand = dialHandAdd(s_bgHands, BOOST_NEEDLE_LEN, 20, 4, lv_color_make(0xFF, 0x80, 0x00));
+
+    // Face, needle scale and unit label for the current units
+    s_bgFace = nullptr;
+    _bgApplyUnits(unitSystem(g_isMetric));
+    uiNeedleSet(s_uiBgNeedle, 0);
 
     return s_bgScreen;
 }
 
-static void updateAnalogBoostScreen(void) {
-    if (!s_bgScreen || !s_bgScale) return;
-    // Map kPa (0-300) → internal scale (0-300, 1:1)
-    float kpa = g_boostKpa < 0.0f ? 0.0f : (g_boostKpa > 300.0f ? 300.0f : g_boostKpa);
-    static int32_t needleVal;
-    needleVal = (int32_t)kpa;
-    lv_scale_set_line_needle_value(s_bgScale, s_bgScale, 150, needleVal);
-
-    if (!g_isMetric) {
-        lv_label_set_text(s_bgUnitLabel, "psi");
-    } else {
-        lv_label_set_text(s_bgUnitLabel, "bar");
-    }
+/**
+ * Refresh the needle with boost interpolated to the current frame
+ * (sensor_interp.h).
+ * @return true while the needle is still gliding toward the latest sample
+ */
+static bool updateAnalogBoostScreen(void) {
+    TRACE_SCOPE("updateAnalogBoostScreen");
+    if (!s_bgScreen || !s_bgNeedle) return false;
+    float v[SENSOR_DISPLAY_COUNT];
+    SensorMask moving = sensorInterpSample(readSensors(), micros(), v);
+
+    UnitSystem us = unitSystem(g_isMetric);
+    if (us != s_bgUnitSys) _bgApplyUnits(us);
+
+    // The needle is set in fine steps (see kBoostDialUnits) so it glides
+    // rather than stepping; uiNeedleSet() clamps it to the dial, and the
+    // hand still redraws only when its pixels change.
+    uiNeedleSet(s_uiBgNeedle, (int32_t)lroundf(s_bgUnits->needle.at(Pressure(v[CH_BOOST_KPA]))));
+    return (moving & BOOSTGAUGE_CHANNELS) != 0;
 }
 
 #else
 // ── LVGL 8 implementation (lv_meter) ─────────────────────────────────────────
+static lv_meter_scale_t     *s_bgScale  = nullptr;
 static lv_meter_indicator_t *s_bgNeedle = nullptr;
 
+// lv_meter numbers its major ticks with the scale value itself, so the
+// scale runs in whole kPa or psi.
+static const GaugeMap<PressureTag> kBoostMeterUnits[UNIT_SYSTEM_COUNT] = {
+    gaugeMap(kUnitKPa, 0.0f, 300.0f, 1, 5.0f, 10),
+    gaugeMap(kUnitPsi, 0.0f, 45.0f,  1, 1.0f, 5),
+};
+
+static const GaugeMap<PressureTag> *s_bgUnits = &kBoostMeterUnits[UNITS_METRIC];
+
+/** Switch the meter's scale and unit label to unit system us. */
+static void _bgApplyUnits(UnitSystem us) {
+    s_bgUnits   = &kBoostMeterUnits[us];
+    s_bgUnitSys = us;
+    const GaugeMap<PressureTag> &m = *s_bgUnits;
+    // 235° sweep, start at lower-left, end at lower-right
+    lv_meter_set_scale_range(s_bgMeter, s_bgScale, m.lo, m.hi, 235, 152);
+    lv_meter_set_scale_ticks(s_bgMeter, s_bgScale, (uint16_t)m.ticks(), 2, 10,
+                             lv_color_make(0x80, 0x80, 0x80));
+    lv_meter_set_scale_major_ticks(s_bgMeter, s_bgScale, (uint16_t)m.majorEvery, 4, 20,
+                                   lv_color_white(), 14);
+    uiLabelSetStatic(s_uiBgUnit, m.label);
+}
+
 static lv_obj_t *createAnalogBoostScreen(void) {
     s_bgScreen = lv_obj_create(nullptr);
     lv_obj_set_style_bg_color(s_bgScreen, lv_color_black(), 0);
@@ -104,17 +218,12 @@ static lv_obj_t *createAnalogBoostScreen(void) {
     lv_obj_set_style_bg_opa(s_bgMeter, LV_OPA_COVER, 0);
     lv_obj_set_style_border_width(s_bgMeter, 0, 0);
 
-    // Add a scale: 0–300 kPa (represents 0–3.0 bar at ×0.1 scale)
-    lv_meter_scale_t *scale = lv_meter_add_scale(s_bgMeter);
-    // 235° sweep, start at lower-left, end at lower-right
-    lv_meter_set_scale_range(s_bgMeter, scale, 0, 300, 235, 152);
-    lv_meter_set_scale_ticks(s_bgMeter, scale, 61, 2, 10, lv_color_make(0x80, 0x80, 0x80));
-    // Major ticks every 50 kPa (= 0.5 bar)
-    lv_meter_set_scale_major_ticks(s_bgMeter, scale, 10, 4, 20, lv_color_white(), 14);
+    // Scale (range and ticks are set by _bgApplyUnits)
+    s_bgScale = lv_meter_add_scale(s_bgMeter);
 
     // Orange needle
     lv_color_t orange = lv_color_make(0xFF, 0x80, 0x00);
-    s_bgNeedle = lv_meter_add_needle_line(s_bgMeter, scale, 4, orange, -40);
+    s_bgNeedle = lv_meter_add_needle_line(s_bgMeter, s_bgScale, 4, orange, -40);
 
     // Set initial value
     lv_meter_set_indicator_value(s_bgMeter, s_bgNeedle, 0);
@@ -125,17 +234,40 @@ static lv_obj_t *createAnalogBoostScreen(void) {
     lv_obj_set_style_text_color(s_bgUnitLabel, lv_color_make(0xAA, 0xAA, 0xAA), 0);
     lv_obj_set_style_text_font(s_bgUnitLabel, &lv_font_unscii_16, 0);
     lv_obj_align(s_bgUnitLabel, LV_ALIGN_CENTER, 0, 80);
+    uiLabelInit(s_uiBgUnit, s_bgUnitLabel);
+    _bgApplyUnits(unitSystem(g_isMetric));
 
     return s_bgScreen;
 }
 
-static void updateAnalogBoostScreen(void) {
-    if (!s_bgScreen || !s_bgMeter) return;
+static bool updateAnalogBoostScreen(void) {
+    TRACE_SCOPE("updateAnalogBoostScreen");
+    if (!s_bgScreen || !s_bgMeter) return false;
+    float v[SENSOR_DISPLAY_COUNT];
+    SensorMask moving = sensorInterpSample(readSensors(), micros(), v);
 
-    // Clamp to 0-300 kPa
-    float kpa = g_boostKpa < 0.0f ? 0.0f : (g_boostKpa > 300.0f ? 300.0f : g_boostKpa);
-    lv_meter_set_indicator_value(s_bgMeter, s_bgNeedle, (int32_t)kpa);
+    UnitSystem us = unitSystem(g_isMetric);
+    if (us != s_bgUnitSys) _bgApplyUnits(us);
 
-    lv_label_set_text(s_bgUnitLabel, g_isMetric ? "bar" : "psi");
+    // Clamp to the scale
+    const GaugeMap<PressureTag> &m = *s_bgUnits;
+    int32_t value = (int32_t)m.at(Pressure(v[CH_BOOST_KPA]));
+    value = value < m.lo ? m.lo : (value > m.hi ? m.hi : value);
+    lv_meter_set_indicator_value(s_bgMeter, s_bgNeedle, value);
+    return (moving & BOOSTGAUGE_CHANNELS) != 0;
 }
 #endif  // LVGL_VERSION_MAJOR >= 9
+
+/** Forget the widgets after the screen was deleted (screen_manager.h). */
+static void releaseAnalogBoostScreen(void) {
+    s_bgScreen    = nullptr;
+    s_bgMeter     = nullptr;
+    s_bgUnitLabel = nullptr;
+    s_bgNeedle    = nullptr;
+#if LVGL_VERSION_MAJOR >= 9
+    s_bgFace      = nullptr;
+#else
+    s_bgScale     = nullptr;
+#endif
+    s_bgUnitSys   = -1;
+}
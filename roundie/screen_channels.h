@@ -0,0 +1,23 @@
+/**
+ * screen_channels.h
+ * The sensor channels each screen displays (SensorMask), shared by
+ * the firmware and the simulator.  A change to one of them triggers the
+ * screen's update (ui_runtime.h).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "config.h"
+#include "screen_multiarc.h"
+#include "screen_boostgauge.h"
+#include "screen_layout.h"
+
+static inline SensorMask screenChannels(int screen) {
+    switch (screen) {
+        case SCREEN_MULTIARC:   return MULTIARC_CHANNELS;
+        case SCREEN_BOOSTGAUGE: return BOOSTGAUGE_CHANNELS;
+        case SCREEN_LAYOUT:     return layoutScreenChannels();
+        default:                return 0;
+    }
+}
@@ -4,28 +4,37 @@
  *
  * Layout (466×466 round AMOLED):
  *   - Black background
- *   - White dial with 12, 3, 6, 9 numerals and tick marks
- *   - Orange hour, minute, and (thin) second hands
+ *   - White dial with 12, 3, 6, 9 numerals and tick marks, pre-rendered once
+ *     into a cached canvas (dial_face.h)
+ *   - Orange hour, minute, and (thin) second hands, drawn as anti-aliased
+ *     lines (dial_hand.h); the second hand sweeps smoothly between ticks
  *   - Centered on the round display
  *
- * Requires LVGL 8.x or 9.x.
+ * Requires LVGL 9.x.
  */
 
 #pragma once
 
 #include <lvgl.h>
 #include "config.h"
+#include "dial_face.h"
+#include "dial_hand.h"
+#include "trace.h"
 
 // ── Clock screen objects (file-scoped) ───────────────────────────────────────
 static lv_obj_t  *s_clockScreen    = nullptr;
-static lv_obj_t  *s_clockCanvas    = nullptr;  // canvas for custom clock drawing
-static lv_obj_t  *s_hourHand       = nullptr;
-static lv_obj_t  *s_minuteHand     = nullptr;
-static lv_obj_t  *s_secondHand     = nullptr;
+static lv_obj_t  *s_clockCanvas    = nullptr;  // cached dial face (ticks + numerals)
 static lv_obj_t  *s_clockCenter    = nullptr;  // center dot
+static DialHandSet s_clockHands;               // hour, minute, second (dial_hand.h)
+static int        s_hourHand       = -1;
+static int        s_minuteHand     = -1;
+static int        s_secondHand     = -1;
+static lv_timer_t *s_clockSweepTimer = nullptr;
 
-// Clock face numerals
-static lv_obj_t  *s_numLabels[4]   = {};       // 12, 3, 6, 9
+// Time last passed to updateClockScreen(), and the tick at which its second
+// began, for the sub-second sweep
+static uint8_t    s_clockH = 0, s_clockM = 0, s_clockS = 0xFF;
+static uint32_t   s_clockSecStartMs = 0;
 
 // ── Constants ────────────────────────────────────────────────────────────────
 #define CLOCK_CX        (DISPLAY_WIDTH  / 2)   // 233
@@ -34,76 +43,71 @@ static lv_obj_t  *s_numLabels[4]   = {};       // 12, 3, 6, 9
 #define HOUR_LEN        100
 #define MIN_LEN         140
 #define SEC_LEN         160
-
-// Degrees to radians
-static inline float _deg2rad(float deg) { return deg * (float)M_PI / 180.0f; }
+#define CLOCK_FACE_SIZE (2 * CLOCK_R + 4)      // canvas holding the static dial
 
 /**
- * Helper – create a thin line object to represent a clock hand.
- * The hand rotates around the screen center; LVGL transform pivot is set to
- * the bottom mid-point of the image so it pivots at the clock center.
- *
- * We draw each hand as a 4-px-wide, length-px-tall rectangle with a pivot at
- * the bottom center, then rotate via lv_obj_set_style_transform_rotation().
+ * Paint the static dial – 60 tick marks and the 12/3/6/9 numerals – into
+ * the cached face canvas (dial_face.h).  Runs once, from createClockScreen().
  */
-static lv_obj_t *_createHand(lv_obj_t *parent, int32_t length, int32_t width,
-                              lv_color_t color) {
-    lv_obj_t *hand = lv_obj_create(parent);
-    lv_obj_remove_style_all(hand);
-    lv_obj_set_size(hand, width, length);
-    lv_obj_set_style_bg_color(hand, color, 0);
-    lv_obj_set_style_bg_opa(hand, LV_OPA_COVER, 0);
-    lv_obj_set_style_radius(hand, width / 2, 0);
-    // Pivot at bottom-center of the hand rectangle so it rotates around CX,CY
-    lv_obj_set_style_transform_pivot_x(hand, width / 2, 0);
-    lv_obj_set_style_transform_pivot_y(hand, length, 0);
-    // Place the pivot point at the screen center
-    lv_obj_set_pos(hand, CLOCK_CX - width / 2, CLOCK_CY - length);
-    return hand;
-}
+static void _paintClockFace(lv_layer_t *layer, int32_t size) {
+    const int32_t c = size / 2;   // canvas centre = clock centre
 
-/**
- * Draw major and minor tick marks directly on the clock screen background.
- * Called once during createClockScreen().
- */
-static void _drawTicks(lv_obj_t *parent) {
     for (int i = 0; i < 60; i++) {
-        float angle = _deg2rad(i * 6.0f - 90.0f);
         bool isMajor = (i % 5 == 0);
-        int32_t outerR = CLOCK_R;
         int32_t innerR = isMajor ? CLOCK_R - 20 : CLOCK_R - 10;
+        dialPaintRadial(layer, c, c, innerR, CLOCK_R, i * 6 - 90,
+                        isMajor ? 3 : 2, lv_color_white());
+    }
 
-        lv_obj_t *tick = lv_obj_create(parent);
-        lv_obj_remove_style_all(tick);
-
-        int32_t x1 = (int32_t)(CLOCK_CX + cosf(angle) * innerR);
-        int32_t y1 = (int32_t)(CLOCK_CY + sinf(angle) * innerR);
-        int32_t x2 = (int32_t)(CLOCK_CX + cosf(angle) * outerR);
-        int32_t y2 = (int32_t)(CLOCK_CY + sinf(angle) * outerR);
-
-        int32_t dx = x2 - x1;
-        int32_t dy = y2 - y1;
-        int32_t len = (int32_t)sqrtf((float)(dx * dx + dy * dy));
-        int32_t w   = isMajor ? 3 : 2;
-
-        lv_obj_set_size(tick, w, len);
-        lv_obj_set_style_bg_color(tick, lv_color_white(), 0);
-        lv_obj_set_style_bg_opa(tick, LV_OPA_COVER, 0);
-        lv_obj_set_style_radius(tick, 1, 0);
-
-        // Position tick center at midpoint between inner and outer radius
-        int32_t midX = (x1 + x2) / 2;
-        int32_t midY = (y1 + y2) / 2;
-        lv_obj_set_pos(tick, midX - w / 2, midY - len / 2);
-
-        // Rotate the tick to point radially
-        float angleDeg = (float)i * 6.0f;  // 0° at 12 o'clock, then clockwise
-        lv_obj_set_style_transform_rotation(tick, (int32_t)(angleDeg * 10.0f), 0);
-        lv_obj_set_style_transform_pivot_x(tick, w / 2, 0);
-        lv_obj_set_style_transform_pivot_y(tick, len / 2, 0);
+    // Hour numerals: 12, 3, 6, 9
+    static const char *numerals[] = { "12", "3", "6", "9" };
+    static const int32_t numAngles[] = { -90, 0, 90, 180 };
+    static const int32_t numR = CLOCK_R - 40;
+    for (int i = 0; i < 4; i++) {
+        int32_t x = c + ((lv_trigo_cos((int16_t)numAngles[i]) * numR) >> LV_TRIGO_SHIFT);
+        int32_t y = c + ((lv_trigo_sin((int16_t)numAngles[i]) * numR) >> LV_TRIGO_SHIFT);
+        dialPaintText(layer, x, y, numerals[i], &lv_font_unscii_16, lv_color_white());
     }
 }
 
+/**
+ * Point the hands at the stored time plus frac (0..1) of a second.  Angles
+ * are fractional degrees from 12 o'clock; dial_hand.h rounds them to pixels
+ * and skips hands whose pixels did not change, so the slow hands are only
+ * redrawn when they actually move a pixel.
+ */
+static void _clockSetHands(float frac) {
+    float sec  = s_clockS + frac;
+    float min  = s_clockM + sec / 60.0f;
+    float hour = (s_clockH % 12) + min / 60.0f;
+    dialHandSetAngle(s_clockHands, s_hourHand,   hour * 30.0f - 90.0f);
+    dialHandSetAngle(s_clockHands, s_minuteHand, min  * 6.0f  - 90.0f);
+    dialHandSetAngle(s_clockHands, s_secondHand, sec  * 6.0f  - 90.0f);
+}
+
+/**
+ * Fraction of the current second elapsed since the RTC second last changed,
+ * held just short of the next tick so a late update never makes the second
+ * hand jump backwards.  Always 0 when the sweep is disabled.
+ */
+static float _clockSweepFrac(void) {
+#if CLOCK_SWEEP_PERIOD_MS > 0
+    uint32_t ms = lv_tick_elaps(s_clockSecStartMs);
+    return ms >= 999 ? 0.999f : ms / 1000.0f;
+#else
+    return 0.0f;
+#endif
+}
+
+#if CLOCK_SWEEP_PERIOD_MS > 0
+/** Sweep the second hand between whole-second updates. */
+static void _clockSweepTimerCb(lv_timer_t *t) {
+    (void)t;
+    if (s_clockS == 0xFF || lv_screen_active() != s_clockScreen) return;
+    _clockSetHands(_clockSweepFrac());
+}
+#endif
+
 /**
  * Create all LVGL widgets for the clock screen.
  * @return  pointer to the created screen object
@@ -114,33 +118,19 @@ static lv_obj_t *createClockScreen(void) {
     lv_obj_set_style_bg_opa(s_clockScreen, LV_OPA_COVER, 0);
     lv_obj_clear_flag(s_clockScreen, LV_OBJ_FLAG_SCROLLABLE);
 
-    // Draw tick marks
-    _drawTicks(s_clockScreen);
-
-    // Hour numerals: 12, 3, 6, 9
-    static const char *numerals[] = { "12", "3", "6", "9" };
-    static const float numAngles[] = { -90.0f, 0.0f, 90.0f, 180.0f };
-    static const int32_t numR = CLOCK_R - 40;
-
-    for (int i = 0; i < 4; i++) {
-        lv_obj_t *lbl = lv_label_create(s_clockScreen);
-        lv_label_set_text(lbl, numerals[i]);
-        lv_obj_set_style_text_color(lbl, lv_color_white(), 0);
-        lv_obj_set_style_text_font(lbl, &lv_font_unscii_16, 0);
-
-        float rad = _deg2rad(numAngles[i]);
-        int32_t x = CLOCK_CX + (int32_t)(cosf(rad) * numR);
-        int32_t y = CLOCK_CY + (int32_t)(sinf(rad) * numR);
-        lv_obj_align(lbl, LV_ALIGN_TOP_LEFT, 0, 0);
-        lv_obj_set_pos(lbl, x - 10, y - 12);
-        s_numLabels[i] = lbl;
-    }
+    // Ticks and numerals, pre-rendered once into a cached canvas
+    s_clockCanvas = dialFaceCreate(s_clockScreen, CLOCK_FACE_SIZE, lv_color_black(),
+                                   _paintClockFace);
 
-    // Clock hands (orange)
+    // Clock hands (orange), all drawn by one host object
     lv_color_t orange = lv_color_make(0xFF, 0x80, 0x00);
-    s_hourHand   = _createHand(s_clockScreen, HOUR_LEN, 6,  orange);
-    s_minuteHand = _createHand(s_clockScreen, MIN_LEN,  4,  orange);
-    s_secondHand = _createHand(s_clockScreen, SEC_LEN,  2,  orange);
+    dialHandsCreate(s_clockHands, s_clockScreen, CLOCK_CX, CLOCK_CY, SEC_LEN + 4);
+    s_hourHand   = dialHandAdd(s_clockHands, HOUR_LEN, 0,  6, orange);
+    s_minuteHand = dialHandAdd(s_clockHands, MIN_LEN,  0,  4, orange);
+    s_secondHand = dialHandAdd(s_clockHands, SEC_LEN,  20, 2, orange);
+    dialHandSetAngle(s_clockHands, s_hourHand,   -90.0f);   // 12 o'clock until the
+    dialHandSetAngle(s_clockHands, s_minuteHand, -90.0f);   // first update
+    dialHandSetAngle(s_clockHands, s_secondHand, -90.0f);
 
     // Center dot (orange cap)
     s_clockCenter = lv_obj_create(s_clockScreen);
@@ -151,31 +141,39 @@ static lv_obj_t *createClockScreen(void) {
     lv_obj_set_style_radius(s_clockCenter, LV_RADIUS_CIRCLE, 0);
     lv_obj_align(s_clockCenter, LV_ALIGN_CENTER, 0, 0);
 
+#if CLOCK_SWEEP_PERIOD_MS > 0
+    s_clockSweepTimer = lv_timer_create(_clockSweepTimerCb, CLOCK_SWEEP_PERIOD_MS, nullptr);
+#endif
     return s_clockScreen;
 }
 
+/** Forget the widgets after the screen was deleted (screen_manager.h). */
+static void releaseClockScreen(void) {
+    if (s_clockSweepTimer) lv_timer_delete(s_clockSweepTimer);
+    s_clockSweepTimer = nullptr;
+    s_clockScreen     = nullptr;
+    s_clockCanvas     = nullptr;
+    s_clockCenter     = nullptr;
+    s_clockS          = 0xFF;
+}
+
 /**
  * Update the clock hand angles from the provided hour/minute/second values.
- * Call this once per second from the main loop.
+ * Call this at least once per second from the main loop; between calls the
+ * sweep timer advances the second hand.
  *
  * @param hour    0-23
  * @param minute  0-59
  * @param second  0-59
  */
 static void updateClockScreen(uint8_t hour, uint8_t minute, uint8_t second) {
+    TRACE_SCOPE("updateClockScreen");
     if (!s_clockScreen) return;
-
-    // Convert to 12-hour for the clock face
-    uint8_t h12 = hour % 12;
-
-    // Angles in tenths-of-degrees (LVGL transform_rotation unit)
-    // 12 o'clock = -90° (or 270°).  We use 0° = 12 o'clock convention:
-    //   second hand: 6°/sec,  minute hand: 0.1°/sec,  hour hand: 0.00833°/sec
-    int32_t secAngle  = (int32_t)(second * 6)            * 10;  // 6° per second
-    int32_t minAngle  = (int32_t)(minute * 6 + second / 10) * 10;
-    int32_t hourAngle = (int32_t)((h12 * 30) + (minute / 2)) * 10;
-
-    lv_obj_set_style_transform_rotation(s_secondHand, secAngle,  0);
-    lv_obj_set_style_transform_rotation(s_minuteHand, minAngle,  0);
-    lv_obj_set_style_transform_rotation(s_hourHand,   hourAngle, 0);
+    if (second != s_clockS || minute != s_clockM || hour != s_clockH) {
+        s_clockSecStartMs = lv_tick_get();
+    }
+    s_clockH = hour;
+    s_clockM = minute;
+    s_clockS = second;
+    _clockSetHands(_clockSweepFrac());
 }
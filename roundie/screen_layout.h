@@ -0,0 +1,76 @@
+/**
+ * screen_layout.h
+ * Screen 3 – Engine gauges instantiated from a layout (gauge_layout.h).
+ *
+ * Nothing on this screen is hand-written: its arcs, needles, dial scales
+ * and readouts come from a binary layout compiled on the host by
+ * tools/gauge2rgl.py.  The default, tools/engine.gauge (tachometer, coolant
+ * ring, oil pressure readout), is built into flash as
+ * gauge_layout_default.h; layoutScreenLoad() at boot replaces it with a
+ * layout file if one is present (LittleFS on the device, --layout in the
+ * simulator).  A file that fails validation is reported and ignored.
+ *
+ * Requires LVGL 9.x.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include "config.h"
+#include "can_handler.h"
+#include "sensor_interp.h"
+#include "unit_convert.h"
+#include "gauge_layout.h"
+#include "trace.h"
+#include "gauge_layout_default.h"
+
+extern bool g_isMetric;
+
+static GaugeLayout s_layout;          // validated at boot, read-only afterwards
+static GaugeView   s_layoutView;
+
+/**
+ * Use blob as the screen's layout, or the built-in one if blob is nullptr
+ * or invalid.  Call before the screen is first built.
+ * @return nullptr, or why blob was rejected
+ */
+static const char *layoutScreenLoad(const uint8_t *blob, size_t len) {
+    const char *err = blob ? gaugeLayoutLoad(s_layout, blob, len) : nullptr;
+    if (!blob || err) {
+        const char *builtin = gaugeLayoutLoad(s_layout, kGaugeLayoutDefault,
+                                              sizeof(kGaugeLayoutDefault));
+        if (builtin) {   // stale header: regenerate it with tools/gauge2rgl.py
+            LV_LOG_WARN("built-in gauge layout: %s", builtin);
+            memset(&s_layout, 0, sizeof(s_layout));
+        }
+    }
+    return err;
+}
+
+static lv_obj_t *createLayoutScreen(void) {
+    return gaugeViewCreate(s_layoutView, s_layout, unitSystem(g_isMetric));
+}
+
+/** Forget the widgets after the screen was deleted (screen_manager.h). */
+static void releaseLayoutScreen(void) {
+    gaugeViewRelease(s_layoutView);
+}
+
+/** Channels shown by this screen (ui_runtime.h refreshes it when they change). */
+static inline SensorMask layoutScreenChannels(void) {
+    return s_layout.channels;
+}
+
+/**
+ * Refresh the bound widgets with the latest sensor data, interpolated to
+ * the current frame (sensor_interp.h).
+ * @return true while a bound widget is still moving toward its latest sample
+ */
+static bool updateLayoutScreen(void) {
+    TRACE_SCOPE("updateLayoutScreen");
+    if (!s_layoutView.screen) return false;
+    float v[SENSOR_DISPLAY_COUNT];
+    SensorMask moving = sensorInterpSample(readSensors(), micros(), v);
+    gaugeViewUpdate(s_layoutView, v, unitSystem(g_isMetric));
+    return (moving & s_layout.channels) != 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * screen_manager.h
+ * Screens created on first use and deleted again under a memory budget.
+ *
+ * Building every screen at boot delays the first frame by the sum of their
+ * creation times and keeps all of their widgets in internal RAM for good.
+ * The manager instead creates a screen when screenManagerGet() first asks
+ * for it (from switchToScreen()) and records its cost:
+ *
+ *   createUs    time spent in its create function
+ *   heapBytes   LVGL heap plus, on the device, internal RAM it took
+ *
+ * screenManagerIdle(), called by the UI task when it has nothing else to
+ * do, then
+ *   - pre-warms one swipe neighbour of the active screen at a time (the
+ *     main screens 0..SCREEN_COUNT-1 wrap around, as in gestures.h) when
+ *     SCREEN_PREWARM is set, but only while it still fits
+ *     SCREEN_HEAP_BUDGET, and
+ *   - while the resident screens exceed the budget, deletes the one used
+ *     least recently.  The active screen, and any screen shown within the
+ *     last SCREEN_EVICT_HOLD_MS (still fading out, or likely to be swiped
+ *     back to), are never deleted.
+ *
+ * A deleted screen's release function clears the module's static handles
+ * and timers, so its update function sees a null screen and returns, and
+ * the next screenManagerGet() builds it afresh.  Cached PSRAM canvases
+ * (dial faces) are freed with their screen; the digit atlas stays.
+ *
+ * UI task only, like every other LVGL call.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "trace.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+
+#define SCREEN_MANAGER_MAX  8
+
+typedef lv_obj_t *(*ScreenCreateFn)(void);
+typedef void      (*ScreenReleaseFn)(void);
+
+/** One screen the manager can build and tear down. */
+struct ScreenDef {
+    const char     *name;
+    ScreenCreateFn  create;
+    ScreenReleaseFn release;   // clear the module's handles after deletion
+};
+
+/** What a screen costs, as measured at its last creation. */
+struct ScreenInfo {
+    uint32_t createUs;
+    int32_t  heapBytes;
+    uint32_t creations;        // times built since boot
+    uint32_t lastUseMs;        // millis() of the last screenManagerGet()
+};
+
+struct ScreenManager {
+    const ScreenDef *defs;
+    int              count;
+    lv_obj_t       **objs;                    // g_screens[], nullptr = not resident
+    ScreenInfo       info[SCREEN_MANAGER_MAX];
+    size_t           budget;                  // bytes of resident screens
+    void           (*onCreate)(lv_obj_t *);   // e.g. attach gesture handlers
+    int              active;
+    uint32_t         evictions;
+};
+
+/** LVGL heap in use, plus internal RAM in use on the device. */
+static size_t _screenMemUsed(void) {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    size_t used = mon.total_size - mon.free_size;
+#if defined(ESP_PLATFORM)
+    used += heap_caps_get_total_size(MALLOC_CAP_INTERNAL) -
+            heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+#endif
+    return used;
+}
+
+/**
+ * Set up the manager for count screens; objs receives the screen objects.
+ * Nothing is created until the first screenManagerGet().
+ */
+static void screenManagerInit(ScreenManager &m, const ScreenDef *defs, int count,
+                              lv_obj_t **objs, size_t budget,
+                              void (*onCreate)(lv_obj_t *)) {
+    m.defs      = defs;
+    m.count     = count < SCREEN_MANAGER_MAX ? count : SCREEN_MANAGER_MAX;
+    m.objs      = objs;
+    m.budget    = budget;
+    m.onCreate  = onCreate;
+    m.active    = -1;
+    m.evictions = 0;
+    memset(m.info, 0, sizeof(m.info));
+    for (int i = 0; i < m.count; i++) m.objs[i] = nullptr;
+}
+
+static lv_obj_t *_screenCreate(ScreenManager &m, int idx) {
+    TRACE_SCOPE("screen create");
+    size_t   mem0 = _screenMemUsed();
+    uint32_t t0   = micros();
+    lv_obj_t *obj = m.defs[idx].create();
+    ScreenInfo &s = m.info[idx];
+    s.createUs  = micros() - t0;
+    s.heapBytes = (int32_t)(_screenMemUsed() - mem0);
+    s.creations++;
+    m.objs[idx] = obj;
+    if (obj && m.onCreate) m.onCreate(obj);
+    return obj;
+}
+
+static void _screenDelete(ScreenManager &m, int idx) {
+    lv_obj_delete(m.objs[idx]);
+    m.objs[idx] = nullptr;
+    if (m.defs[idx].release) m.defs[idx].release();
+    m.evictions++;
+}
+
+/** Bytes held by the resident screens, as measured when each was created. */
+static size_t screenManagerResident(const ScreenManager &m) {
+    size_t total = 0;
+    for (int i = 0; i < m.count; i++) {
+        if (m.objs[i] && m.info[i].heapBytes > 0) total += (size_t)m.info[i].heapBytes;
+    }
+    return total;
+}
+
+/**
+ * The screen object for idx, created now if it is not resident, and marked
+ * as the active screen.
+ * @return the screen, or nullptr if idx is invalid or creation failed
+ */
+static lv_obj_t *screenManagerGet(ScreenManager &m, int idx) {
+    if (idx < 0 || idx >= m.count) return nullptr;
+    lv_obj_t *obj = m.objs[idx] ? m.objs[idx] : _screenCreate(m, idx);
+    m.info[idx].lastUseMs = millis();
+    m.active = idx;
+    return obj;
+}
+
+/** The resident screen that may be deleted first, or -1. */
+static int _screenEvictable(const ScreenManager &m, uint32_t now) {
+    int victim = -1;
+    for (int i = 0; i < m.count; i++) {
+        if (!m.objs[i] || i == m.active) continue;
+        if (now - m.info[i].lastUseMs < SCREEN_EVICT_HOLD_MS) continue;
+        if (victim < 0 || m.info[i].lastUseMs < m.info[victim].lastUseMs) victim = i;
+    }
+    return victim;
+}
+
+/**
+ * Background work between frames: delete one screen if the resident ones
+ * exceed the budget, otherwise pre-warm one swipe neighbour of the active
+ * screen that fits.  Does at most one creation or deletion per call.
+ * @return true if it did something (call again on the next idle pass)
+ */
+static bool screenManagerIdle(ScreenManager &m) {
+    if (m.active < 0) return false;
+    uint32_t now = millis();
+    size_t resident = screenManagerResident(m);
+    if (resident > m.budget) {
+        int victim = _screenEvictable(m, now);
+        if (victim < 0) return false;
+        _screenDelete(m, victim);
+        return true;
+    }
+#if SCREEN_PREWARM
+    if (m.active >= SCREEN_COUNT || m.count < SCREEN_COUNT) return false;
+    const int next[2] = { (m.active + 1) % SCREEN_COUNT,
+                          (m.active + SCREEN_COUNT - 1) % SCREEN_COUNT };
+    for (int n : next) {
+        if (m.objs[n]) continue;
+        // Screens never built are assumed to fit; a measured one must
+        if (m.info[n].creations && resident + (size_t)m.info[n].heapBytes > m.budget) continue;
+        _screenCreate(m, n);
+        m.info[n].lastUseMs = now;
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * Cost of every screen, e.g. "multiarc 14.2 kB 9.8 ms x1 resident | ...",
+ * followed by the resident total against the budget, into buf.
+ * @return buf
+ */
+static char *screenManagerFormat(const ScreenManager &m, char *buf, size_t size) {
+    size_t n = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < m.count && n < size; i++) {
+        const ScreenInfo &s = m.info[i];
+        int w = s.creations
+            ? snprintf(buf + n, size - n, "%s %.1f kB %.1f ms x%lu %s | ", m.defs[i].name,
+                       s.heapBytes / 1024.0f, s.createUs / 1000.0f, (unsigned long)s.creations,
+                       m.objs[i] ? "resident" : "released")
+            : snprintf(buf + n, size - n, "%s not built | ", m.defs[i].name);
+        if (w < 0) return buf;
+        n += (size_t)w;
+    }
+    if (n < size) {
+        snprintf(buf + n, size - n, "resident %.1f/%.1f kB, %lu evictions",
+                 screenManagerResident(m) / 1024.0f, m.budget / 1024.0f,
+                 (unsigned long)m.evictions);
+    }
+    return buf;
+}
@@ -5,9 +5,11 @@
  * Layout (466×466 round AMOLED, black background):
  *
  * Top section – two nested arcs, ~235° sweep:
- *   Outer arc  – Boost Pressure  (white/light-gray)
+ *   Outer arc  – Boost Pressure  (white/light-gray), amber peak-hold mark
+ *                at the session maximum (sensor_stats.h)
  *   Inner arc  – Lambda / AFR    (light-blue; red when boost>120 kPa AND lambda>1.1)
- *   Center     – Digital boost readout (large, bold, white)
+ *   Center     – Digital boost readout (large, bold, white; LVGL 9 draws
+ *                it from a seven-segment digit atlas, digit_readout.h)
  *
  * Bottom section – single arc, 135° sweep:
  *   Fuel Pressure arc (white/light-gray)
@@ -15,26 +17,49 @@
  * Unit modes (controlled by global bool g_isMetric):
  *   Metric   – boost in kPa (0-300), lambda (0.7-1.3), fuel in kPa (0-500)
  *   Imperial – boost in psi (0-43.5), AFR (10.3-19.1), fuel in psi (0-75)
+ * Each mode is a constexpr table of gauge maps (unit_convert.h), applied
+ * once when the mode changes.
  */
 
 #pragma once
 
-#include <cstdio>
 #include <lvgl.h>
 #include "config.h"
 #include "can_handler.h"
+#include "sensor_interp.h"
 #include "unit_convert.h"
+#include "ui_update.h"
+#include "trace.h"
+#if LVGL_VERSION_MAJOR >= 9
+#include "digit_readout.h"
+#endif
 
 extern bool g_isMetric;
 
 // ── Widget handles ────────────────────────────────────────────────────────────
 static lv_obj_t *s_maScreen        = nullptr;
 static lv_obj_t *s_arcBoost        = nullptr;
+static lv_obj_t *s_arcBoostPeak    = nullptr;   // peak-hold mark over the boost arc
 static lv_obj_t *s_arcLambda       = nullptr;
 static lv_obj_t *s_arcFuel         = nullptr;
-static lv_obj_t *s_lblBoostVal     = nullptr;   // large center digital readout
+#if LVGL_VERSION_MAJOR >= 9
+static DigitAtlas   s_maDigits;                  // large bold digits, PSRAM
+static DigitReadout s_boostReadout;              // large center digital readout
+#else
+static lv_obj_t *s_lblBoostVal     = nullptr;   // center digital readout
+#endif
 static lv_obj_t *s_lblBoostUnit    = nullptr;   // "kPa" or "psi"
 
+// Last-rendered state of each widget (see ui_update.h)
+static UiArc   s_uiArcBoost;
+static UiArcMark s_uiBoostPeak;
+static UiArc   s_uiArcLambda;
+static UiArc   s_uiArcFuel;
+#if LVGL_VERSION_MAJOR < 9
+static UiLabel s_uiBoostVal;
+#endif
+static UiLabel s_uiBoostUnit;
+
 // ── Arc geometry ─────────────────────────────────────────────────────────────
 // Top arcs: start=-145°, end=90°  → 235° sweep, opening at bottom
 #define TOP_ARC_START_ANGLE     145   // LVGL: 0° = 3 o'clock, clockwise
@@ -52,10 +77,38 @@ static lv_obj_t *s_lblBoostUnit    = nullptr;   // "kPa" or "psi"
 #define BOOST_ARC_SIZE          430   // outer arc diameter
 #define LAMBDA_ARC_SIZE         390   // inner arc diameter
 #define FUEL_ARC_SIZE           320   // bottom arc diameter
+#define BOOST_PEAK_MARK_DEG     3     // width of the peak-hold mark
+
+// ── Center readout: "300.0" in 44×72 seven-segment cells ─────────────────────
+#define BOOST_DIGIT_W           44
+#define BOOST_DIGIT_H           72
+#define BOOST_DIGIT_STROKE      9
+#define BOOST_DIGIT_CELLS       4     // three integer digits and one decimal
 
 // ── Boost warning thresholds ─────────────────────────────────────────────────
 #define BOOST_WARN_KPA          120.0f   // > 120 kPa absolute
 #define LAMBDA_WARN             1.1f     // > 1.1 lambda
+#define LAMBDA_WARN_STATE       LV_STATE_USER_1   // lambda arc drawn red
+
+// ── Units ─────────────────────────────────────────────────────────────────────
+/** Gauge maps of the screen in one unit system. */
+struct MultiArcUnits {
+    GaugeMap<PressureTag> boost;     // boost arc, peak mark and readout, in tenths
+    GaugeMap<MixtureTag>  mixture;   // lambda × 1000 or AFR × 10
+    GaugeMap<PressureTag> fuel;
+};
+
+static constexpr MultiArcUnits kMultiArcUnits[UNIT_SYSTEM_COUNT] = {
+    { gaugeMap(kUnitKPa,    0.0f, 300.0f, 10),
+      gaugeMap(kUnitLambda, 0.7f, 1.3f,   1000),
+      gaugeMap(kUnitKPa,    0.0f, 500.0f, 1) },
+    { gaugeMap(kUnitPsi,    0.0f, 43.5f,  10),
+      gaugeMap(kUnitAFR,    10.3f, 19.1f, 10),
+      gaugeMap(kUnitPsi,    0.0f, 75.0f,  1) },
+};
+
+static const MultiArcUnits *s_maUnits   = &kMultiArcUnits[UNITS_METRIC];
+static int                  s_maUnitSys = -1;   // applied UnitSystem, -1 = none yet
 
 /**
  * Create all widgets for Screen 2.
@@ -73,7 +126,6 @@ static lv_obj_t *createMultiArcScreen(void) {
     lv_obj_align(s_arcBoost, LV_ALIGN_TOP_MID, 0, 5);
     // bg_angles: 150→30 clockwise = 240° sweep, centred at 12 o'clock (top)
     lv_arc_set_bg_angles(s_arcBoost, 150, 30);
-    lv_arc_set_range(s_arcBoost, 0, 300);          // 0-300 kPa (metric default)
     lv_arc_set_value(s_arcBoost, 0);
     lv_arc_set_mode(s_arcBoost, LV_ARC_MODE_NORMAL);
     lv_obj_set_style_arc_color(s_arcBoost, lv_color_make(0xCC, 0xCC, 0xCC), LV_PART_INDICATOR);
@@ -83,16 +135,26 @@ static lv_obj_t *createMultiArcScreen(void) {
     lv_obj_remove_style(s_arcBoost, nullptr, LV_PART_KNOB);
     lv_obj_clear_flag(s_arcBoost, LV_OBJ_FLAG_CLICKABLE);
 
+    // Peak-hold mark: indicator-only arc on top of the boost arc
+    s_arcBoostPeak = lv_arc_create(s_maScreen);
+    lv_obj_set_size(s_arcBoostPeak, BOOST_ARC_SIZE, BOOST_ARC_SIZE);
+    lv_obj_align(s_arcBoostPeak, LV_ALIGN_TOP_MID, 0, 5);
+    lv_obj_set_style_arc_opa(s_arcBoostPeak, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_arc_color(s_arcBoostPeak, lv_color_make(0xFF, 0xA0, 0x00), LV_PART_INDICATOR);
+    lv_obj_set_style_arc_width(s_arcBoostPeak, 14, LV_PART_INDICATOR);
+    lv_obj_set_style_arc_rounded(s_arcBoostPeak, false, LV_PART_INDICATOR);
+    lv_obj_remove_style(s_arcBoostPeak, nullptr, LV_PART_KNOB);
+    lv_obj_clear_flag(s_arcBoostPeak, LV_OBJ_FLAG_CLICKABLE);
+
     // ── Inner arc: Lambda / AFR ───────────────────────────────────────────
     s_arcLambda = lv_arc_create(s_maScreen);
     lv_obj_set_size(s_arcLambda, LAMBDA_ARC_SIZE, LAMBDA_ARC_SIZE);
     lv_obj_align(s_arcLambda, LV_ALIGN_TOP_MID, 0, 5 + (BOOST_ARC_SIZE - LAMBDA_ARC_SIZE) / 2);
     lv_arc_set_bg_angles(s_arcLambda, 150, 30);
-    // Range internally stored × 1000 to keep integer precision:  700-1300
-    lv_arc_set_range(s_arcLambda, 700, 1300);      // 0.7-1.3 lambda × 1000
-    lv_arc_set_value(s_arcLambda, 700);
     lv_arc_set_mode(s_arcLambda, LV_ARC_MODE_NORMAL);
     lv_obj_set_style_arc_color(s_arcLambda, lv_color_make(0x00, 0xBF, 0xFF), LV_PART_INDICATOR); // light-blue
+    lv_obj_set_style_arc_color(s_arcLambda, lv_color_make(0xFF, 0x00, 0x00),
+                               LV_PART_INDICATOR | LAMBDA_WARN_STATE);                         // red when lean
     lv_obj_set_style_arc_width(s_arcLambda, 10, LV_PART_INDICATOR);
     lv_obj_set_style_arc_color(s_arcLambda, lv_color_make(0x30, 0x30, 0x30), LV_PART_MAIN);
     lv_obj_set_style_arc_width(s_arcLambda, 10, LV_PART_MAIN);
@@ -100,17 +162,32 @@ static lv_obj_t *createMultiArcScreen(void) {
     lv_obj_clear_flag(s_arcLambda, LV_OBJ_FLAG_CLICKABLE);
 
     // ── Center digital boost readout ─────────────────────────────────────
+#if LVGL_VERSION_MAJOR >= 9
+    if (!s_maDigits.buf) {   // shared by every rebuild of the screen
+        digitAtlasCreate(s_maDigits, s_maScreen, BOOST_DIGIT_W, BOOST_DIGIT_H,
+                         BOOST_DIGIT_STROKE, lv_color_white(), lv_color_black());
+    }
+    lv_obj_t *readout = digitReadoutCreate(s_boostReadout, s_maScreen, s_maDigits,
+                                           BOOST_DIGIT_CELLS, 1);
+    if (readout) {
+        lv_obj_align(readout, LV_ALIGN_CENTER, 0, -24);
+        lv_obj_update_layout(readout);   // cells are invalidated by screen coordinates
+    }
+    const int32_t unitY = 34;
+#else
     s_lblBoostVal = lv_label_create(s_maScreen);
     lv_label_set_text(s_lblBoostVal, "---");
     lv_obj_set_style_text_color(s_lblBoostVal, lv_color_white(), 0);
     lv_obj_set_style_text_font(s_lblBoostVal, &lv_font_unscii_16, 0);
     lv_obj_align(s_lblBoostVal, LV_ALIGN_CENTER, 0, -14);
+    const int32_t unitY = 30;
+#endif
 
     s_lblBoostUnit = lv_label_create(s_maScreen);
     lv_label_set_text(s_lblBoostUnit, "kPa");
     lv_obj_set_style_text_color(s_lblBoostUnit, lv_color_make(0xAA, 0xAA, 0xAA), 0);
     lv_obj_set_style_text_font(s_lblBoostUnit, &lv_font_unscii_16, 0);
-    lv_obj_align(s_lblBoostUnit, LV_ALIGN_CENTER, 0, 30);
+    lv_obj_align(s_lblBoostUnit, LV_ALIGN_CENTER, 0, unitY);
 
     // ── Bottom arc: Fuel Pressure (135° sweep) ────────────────────────────
     s_arcFuel = lv_arc_create(s_maScreen);
@@ -118,7 +195,6 @@ static lv_obj_t *createMultiArcScreen(void) {
     lv_obj_align(s_arcFuel, LV_ALIGN_BOTTOM_MID, 0, -10);
     // bg_angles: 22→158 clockwise = 136° sweep, centred at 6 o'clock (bottom)
     lv_arc_set_bg_angles(s_arcFuel, 22, 158);
-    lv_arc_set_range(s_arcFuel, 0, 500);           // 0-500 kPa (metric default)
     lv_arc_set_value(s_arcFuel, 0);
     lv_arc_set_mode(s_arcFuel, LV_ARC_MODE_NORMAL);
     lv_obj_set_style_arc_color(s_arcFuel, lv_color_make(0xCC, 0xCC, 0xCC), LV_PART_INDICATOR);
@@ -128,49 +204,97 @@ static lv_obj_t *createMultiArcScreen(void) {
     lv_obj_remove_style(s_arcFuel, nullptr, LV_PART_KNOB);
     lv_obj_clear_flag(s_arcFuel, LV_OBJ_FLAG_CLICKABLE);
 
+    uiArcInit(s_uiArcBoost,  s_arcBoost,  240);
+    uiArcMarkInit(s_uiBoostPeak, s_arcBoostPeak, 150, 240, BOOST_PEAK_MARK_DEG);
+    uiArcInit(s_uiArcLambda, s_arcLambda, 240);
+    uiArcInit(s_uiArcFuel,   s_arcFuel,   136);
+#if LVGL_VERSION_MAJOR < 9
+    uiLabelInit(s_uiBoostVal,  s_lblBoostVal);
+#endif
+    uiLabelInit(s_uiBoostUnit, s_lblBoostUnit);
+    s_maUnitSys = -1;   // ranges and unit label are set by the first update
+
     return s_maScreen;
 }
 
+/** Forget the widgets after the screen was deleted (screen_manager.h). */
+static void releaseMultiArcScreen(void) {
+    s_maScreen     = nullptr;
+    s_arcBoost     = nullptr;
+    s_arcBoostPeak = nullptr;
+    s_arcLambda    = nullptr;
+    s_arcFuel      = nullptr;
+#if LVGL_VERSION_MAJOR >= 9
+    s_boostReadout.obj = nullptr;   // the digit atlas is kept for the next build
+#else
+    s_lblBoostVal  = nullptr;
+#endif
+    s_lblBoostUnit = nullptr;
+}
+
+/** Switch the gauge maps to unit system us and show its unit label. */
+static void _maApplyUnits(UnitSystem us) {
+    s_maUnits   = &kMultiArcUnits[us];
+    s_maUnitSys = us;
+    uiLabelSetStatic(s_uiBoostUnit, s_maUnits->boost.label);
+}
+
+/** Channels shown by this screen (ui_runtime.h refreshes it when they change). */
+#define MULTIARC_CHANNELS \
+    (SENSOR_CH_BIT(CH_BOOST_KPA) | SENSOR_CH_BIT(CH_LAMBDA) | SENSOR_CH_BIT(CH_FUEL_PRESS_KPA))
+static_assert(CH_BOOST_KPA < SENSOR_DISPLAY_COUNT && CH_LAMBDA < SENSOR_DISPLAY_COUNT &&
+              CH_FUEL_PRESS_KPA < SENSOR_DISPLAY_COUNT,
+              "MULTIARC_CHANNELS need @tune lines in haltech_v2.sig");
+
 /**
- * Refresh Screen 2 with the latest sensor data.
- * Call from the main loop when this screen is active.
+ * Refresh Screen 2 with the latest sensor data, interpolated to the current
+ * frame (sensor_interp.h).  Called by the UI task when this screen is
+ * active.  Widgets whose rendered appearance would not change are left
+ * untouched (ui_update.h).
+ * @return true while an arc is still moving toward its latest sample
  */
-static void updateMultiArcScreen(void) {
-    if (!s_maScreen) return;
+static bool updateMultiArcScreen(void) {
+    TRACE_SCOPE("updateMultiArcScreen");
+    if (!s_maScreen) return false;
+
+    // One consistent snapshot for the whole update, so boost and lambda in
+    // the lean check below always come from the same published record.
+    float v[SENSOR_DISPLAY_COUNT];
+    SensorMask moving = sensorInterpSample(readSensors(), micros(), v);
+
+    UnitSystem us = unitSystem(g_isMetric);
+    if (us != s_maUnitSys) _maApplyUnits(us);
+    const MultiArcUnits &u = *s_maUnits;
 
     // ── Boost arc ─────────────────────────────────────────────────────────
-    float boostDisplay  = g_isMetric ? g_boostKpa : kPaToPsi(g_boostKpa);
-    int32_t boostRange  = g_isMetric ? 300 : 44;   // 0-300 kPa or 0~43.5 psi
-    lv_arc_set_range(s_arcBoost, 0, boostRange);
-    lv_arc_set_value(s_arcBoost, (int32_t)boostDisplay);
+    Pressure boost(v[CH_BOOST_KPA]);
+    Mixture  mixture(v[CH_LAMBDA]);
+    float    boostTenths = u.boost.at(boost);
+    uiArcSet(s_uiArcBoost, u.boost.lo, u.boost.hi, (int32_t)boostTenths);
+
+    // Peak hold: the session maximum, read from the statistics snapshot
+    SensorChannelStats boostStats = readSensorStats().ch[CH_BOOST_KPA];
+    if (boostStats.count) {
+        uiArcMarkSet(s_uiBoostPeak, u.boost.lo, u.boost.hi,
+                     (int32_t)u.boost.at(Pressure(boostStats.max)));
+    }
 
-    // Center readout
-    static char boostBuf[16];
-    snprintf(boostBuf, sizeof(boostBuf), "%.1f", boostDisplay);
-    lv_label_set_text(s_lblBoostVal, boostBuf);
-    lv_label_set_text(s_lblBoostUnit, g_isMetric ? "kPa" : "psi");
+    // Center readout, in tenths
+#if LVGL_VERSION_MAJOR >= 9
+    digitReadoutSet(s_boostReadout, (int32_t)lroundf(boostTenths));
+#else
+    uiLabelSetTenths(s_uiBoostVal, boostTenths * 0.1f);
+#endif
 
     // ── Lambda / AFR arc ──────────────────────────────────────────────────
-    if (g_isMetric) {
-        // Display lambda × 1000 so we can use integer arc range 700-1300
-        lv_arc_set_range(s_arcLambda, 700, 1300);
-        lv_arc_set_value(s_arcLambda, (int32_t)(g_lambda * 1000.0f));
-    } else {
-        // AFR mode: range 103-191 (× 10 for integer precision)
-        lv_arc_set_range(s_arcLambda, 103, 191);
-        lv_arc_set_value(s_arcLambda, (int32_t)(lambdaToAFR(g_lambda) * 10.0f));
-    }
+    uiArcSet(s_uiArcLambda, u.mixture.lo, u.mixture.hi, (int32_t)u.mixture.at(mixture));
 
     // Lambda warning: red when boost > 120 kPa AND lambda > 1.1
-    bool warnLean = (g_boostKpa > BOOST_WARN_KPA) && (g_lambda > LAMBDA_WARN);
-    lv_color_t lambdaColor = warnLean
-        ? lv_color_make(0xFF, 0x00, 0x00)      // red
-        : lv_color_make(0x00, 0xBF, 0xFF);     // light-blue
-    lv_obj_set_style_arc_color(s_arcLambda, lambdaColor, LV_PART_INDICATOR);
+    bool warnLean = (boost.base > BOOST_WARN_KPA) && (mixture.base > LAMBDA_WARN);
+    uiSetState(s_arcLambda, LAMBDA_WARN_STATE, warnLean);
 
     // ── Fuel pressure arc ─────────────────────────────────────────────────
-    float fuelDisplay = g_isMetric ? g_fuelPressKpa : kPaToPsi(g_fuelPressKpa);
-    int32_t fuelRange = g_isMetric ? 500 : 75;
-    lv_arc_set_range(s_arcFuel, 0, fuelRange);
-    lv_arc_set_value(s_arcFuel, (int32_t)fuelDisplay);
+    Pressure fuel(v[CH_FUEL_PRESS_KPA]);
+    uiArcSet(s_uiArcFuel, u.fuel.lo, u.fuel.hi, (int32_t)u.fuel.at(fuel));
+    return (moving & MULTIARC_CHANNELS) != 0;
 }
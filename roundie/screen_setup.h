@@ -139,6 +139,17 @@ static lv_obj_t *createSetupScreen(void) {
     return s_setupScreen;
 }
 
+/** Forget the widgets after the screen was deleted (screen_manager.h). */
+static void releaseSetupScreen(void) {
+    s_setupScreen   = nullptr;
+    s_btnMetric     = nullptr;
+    s_btnMerican    = nullptr;
+    s_lblSetupTitle = nullptr;
+    s_lblSetupHint  = nullptr;
+    lv_style_reset(&s_styleBtnNormal);     // re-initialised by the next build
+    lv_style_reset(&s_styleBtnSelected);
+}
+
 /**
  * Refresh the setup-screen highlight to match the current g_isMetric value.
  * Call whenever this screen becomes active.
@@ -0,0 +1,85 @@
+/**
+ * sensor_filter.h
+ * Per-channel filtering of decoded CAN samples.
+ *
+ * Every decoded sample passes through its channel's filter before it is
+ * published, using the frame's reception time, so irregular arrivals (a
+ * late frame, a dropped one) are weighted by the time that actually passed:
+ *
+ *   SENSOR_FILTER_NONE    raw value
+ *   SENSOR_FILTER_EMA     exponential moving average; a = time constant (ms)
+ *   SENSOR_FILTER_RATE    rate limiter; a = largest change per second, so a
+ *                         single corrupt frame cannot throw a needle
+ *   SENSOR_FILTER_KALMAN  1-D Kalman filter on a constant-value model;
+ *                         a = process noise (units² per s), b = measurement
+ *                         noise (units²).  Tracks real steps quickly while
+ *                         averaging sensor noise at steady state
+ *
+ * The first sample of a channel is taken as is.  The per-channel choice is
+ * SENSOR_FILTERS, generated into can_signals.h from the signal table.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+enum SensorFilterKind : uint8_t {
+    SENSOR_FILTER_NONE = 0,
+    SENSOR_FILTER_EMA,
+    SENSOR_FILTER_RATE,
+    SENSOR_FILTER_KALMAN
+};
+
+/** Filter of one channel (see the table above for a and b). */
+struct SensorFilterCfg {
+    uint8_t kind;   // SensorFilterKind
+    float   a, b;
+};
+
+/** Running state of one channel's filter. */
+struct SensorFilterState {
+    float    x;        // filtered value
+    float    p;        // Kalman estimate variance
+    uint32_t tsUs;     // time of the previous sample
+    bool     primed;
+};
+
+/**
+ * Feed raw sample z received at tsUs through the filter.
+ * @return the filtered value
+ */
+inline float sensorFilterStep(const SensorFilterCfg &cfg, SensorFilterState &s,
+                              float z, uint32_t tsUs) {
+    if (!s.primed || cfg.kind == SENSOR_FILTER_NONE) {
+        s.x      = z;
+        s.p      = cfg.b;
+        s.tsUs   = tsUs;
+        s.primed = true;
+        return z;
+    }
+    float dt = (float)(uint32_t)(tsUs - s.tsUs) * 1e-6f;   // s, wrap-safe
+    s.tsUs = tsUs;
+
+    switch (cfg.kind) {
+        case SENSOR_FILTER_EMA: {
+            float tau = cfg.a * 1e-3f;
+            float alpha = dt / (tau + dt);                 // 1 - e^(-dt/tau), first order
+            s.x += alpha * (z - s.x);
+            break;
+        }
+        case SENSOR_FILTER_RATE: {
+            float step = cfg.a * dt;
+            float d = z - s.x;
+            s.x += d > step ? step : (d < -step ? -step : d);
+            break;
+        }
+        case SENSOR_FILTER_KALMAN: {
+            s.p += cfg.a * dt;                             // predict: value may have drifted
+            float k = s.p / (s.p + cfg.b);
+            s.x += k * (z - s.x);                          // update with the measurement
+            s.p *= 1.0f - k;
+            break;
+        }
+    }
+    return s.x;
+}
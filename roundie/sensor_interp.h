@@ -0,0 +1,77 @@
+/**
+ * sensor_interp.h
+ * Frame-paced interpolation of filtered sensor samples for the UI.
+ *
+ * Samples arrive at 50–100 Hz, but not on the display's frame grid, so
+ * showing the latest sample each frame makes a needle stutter.  Instead,
+ * each new sample starts a linear ramp from the value currently shown to
+ * the sample, lasting as long as the gap between the samples the UI saw.
+ * Every frame shows the ramp's value at the frame time.  The needle then
+ * runs one sample interval behind the data, but it moves continuously.
+ *
+ * A channel is "moving" while its ramp is unfinished; steps smaller than
+ * the channel's SENSOR_INTERP_MIN_STEP (below what the display can
+ * resolve) are applied at once, so a settled, slightly noisy value never
+ * keeps the UI animating.  After a gap longer than SENSOR_INTERP_MAX_US –
+ * a silent bus, or a screen that was not visible – the new value is shown
+ * directly.  Only the displayed channels (CH_x < SENSOR_DISPLAY_COUNT) are
+ * interpolated.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+#include "config.h"
+#include "can_handler.h"
+
+#define SENSOR_INTERP_MIN_US  5000     // shortest ramp
+#define SENSOR_INTERP_MAX_US  100000   // longest ramp; longer gaps jump
+
+static const float kSensorInterpMinStep[] = SENSOR_INTERP_MIN_STEP;
+static_assert(sizeof(kSensorInterpMinStep) / sizeof(kSensorInterpMinStep[0]) == SENSOR_DISPLAY_COUNT,
+              "SENSOR_INTERP_MIN_STEP needs one entry per displayed channel");
+
+struct SensorInterpChannel {
+    float    from, to;
+    uint32_t startUs, durUs;
+    uint32_t sampleUs;   // chUs of the sample ramped to (0 = none yet)
+};
+
+static SensorInterpChannel s_sensorInterp[SENSOR_DISPLAY_COUNT];
+
+static float _sensorInterpAt(const SensorInterpChannel &c, uint32_t nowUs) {
+    uint32_t t = nowUs - c.startUs;
+    if (t >= c.durUs) return c.to;
+    return c.from + (c.to - c.from) * ((float)t / (float)c.durUs);
+}
+
+/**
+ * Values of every displayed channel of rec at frame time nowUs, into out.
+ * @return the channels still moving
+ */
+static SensorMask sensorInterpSample(const SensorRecord &rec, uint32_t nowUs,
+                                     float out[SENSOR_DISPLAY_COUNT]) {
+    SensorMask moving = 0;
+    for (int ch = 0; ch < SENSOR_DISPLAY_COUNT; ch++) {
+        SensorInterpChannel &c = s_sensorInterp[ch];
+        if (rec.chUs[ch] == 0) {             // no sample yet: default value
+            out[ch] = rec.ch[ch];
+            continue;
+        }
+        if (rec.chUs[ch] != c.sampleUs) {
+            uint32_t gap = rec.chUs[ch] - c.sampleUs;
+            float    cur = _sensorInterpAt(c, nowUs);
+            bool     jump = c.sampleUs == 0 || gap > SENSOR_INTERP_MAX_US ||
+                            fabsf(rec.ch[ch] - cur) < kSensorInterpMinStep[ch];
+            c.from     = jump ? rec.ch[ch] : cur;
+            c.to       = rec.ch[ch];
+            c.startUs  = nowUs;
+            c.durUs    = gap < SENSOR_INTERP_MIN_US ? SENSOR_INTERP_MIN_US : gap;
+            c.sampleUs = rec.chUs[ch];
+        }
+        out[ch] = _sensorInterpAt(c, nowUs);
+        if (out[ch] != c.to) moving |= SENSOR_CH_BIT(ch);
+    }
+    return moving;
+}
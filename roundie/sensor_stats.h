@@ -0,0 +1,143 @@
+/**
+ * sensor_stats.h
+ * Session statistics of every channel, updated per decoded sample.
+ *
+ * The decoder feeds each filtered sample to sensorStatsAdd(), which costs
+ * the same O(1) work regardless of session length, so it keeps up at full
+ * bus load:
+ *
+ *   min / max    peak hold in both directions (max boost, leanest lambda)
+ *   mean / var   Welford's running mean and sum of squared deviations
+ *   hist         SENSOR_STATS_BINS equal buckets over the channel's
+ *                SENSOR_STATS_RANGE; samples outside land in the end buckets
+ *
+ * Filtered rather than raw values are counted, so a single corrupt frame
+ * cannot set a peak the gauge never showed.  The decoder publishes the
+ * statistics together with each sensor record through their own seqlock;
+ * readers (a peak-hold marker, a summary over serial) take a consistent
+ * copy with readSensorStats() without ever scanning sample history.
+ *
+ * Statistics start at boot; sensorStatsRequestReset() starts a new session
+ * at the decoder's next publish.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "config.h"
+#include "can_signals.h"
+#include "seqlock.h"
+
+#define SENSOR_STATS_BINS  32
+
+/** Statistics of one channel. */
+struct SensorChannelStats {
+    uint32_t count;                     // samples since the session started
+    float    min, max;
+    float    mean;
+    float    m2;                        // sum of squared deviations from the mean
+    uint32_t hist[SENSOR_STATS_BINS];
+};
+
+/** Statistics of every channel, published as one snapshot. */
+struct SensorStats {
+    uint32_t           session;         // bumped on every reset
+    SensorChannelStats ch[SENSOR_CHANNEL_COUNT];  // indexed by SensorChannel
+};
+
+static const float kSensorStatsRange[][2] = SENSOR_STATS_RANGE;
+static_assert(sizeof(kSensorStatsRange) / sizeof(kSensorStatsRange[0]) == SENSOR_CHANNEL_COUNT,
+              "SENSOR_STATS_RANGE needs one entry per channel");
+
+static SensorStats           s_statsWork;         // decoder thread only
+static SeqLock<SensorStats>  s_sensorStats;       // published snapshot
+static std::atomic<bool>     s_statsResetReq{false};
+
+// ── Decoder side ──────────────────────────────────────────────────────────────
+
+static inline void _sensorStatsClear(SensorStats &st) {
+    uint32_t session = st.session + 1;
+    memset(&st, 0, sizeof(st));
+    st.session = session;
+}
+
+/** Fold one sample of channel ch into the statistics.  Decoder thread only. */
+static inline void sensorStatsAdd(int ch, float x) {
+    SensorChannelStats &s = s_statsWork.ch[ch];
+    if (s.count++ == 0) {
+        s.min = s.max = s.mean = x;
+    } else {
+        if (x < s.min) s.min = x;
+        if (x > s.max) s.max = x;
+        float d = x - s.mean;
+        s.mean += d / (float)s.count;
+        s.m2   += d * (x - s.mean);
+    }
+    const float lo = kSensorStatsRange[ch][0], hi = kSensorStatsRange[ch][1];
+    int bin = (int)((x - lo) * ((float)SENSOR_STATS_BINS / (hi - lo)));
+    s.hist[bin < 0 ? 0 : (bin >= SENSOR_STATS_BINS ? SENSOR_STATS_BINS - 1 : bin)]++;
+}
+
+/** Publish the statistics to readers, applying a pending reset.  Decoder thread only. */
+static inline void sensorStatsPublish(void) {
+    if (s_statsResetReq.exchange(false, std::memory_order_relaxed)) _sensorStatsClear(s_statsWork);
+    s_sensorStats.write(s_statsWork);
+}
+
+// ── Readers ───────────────────────────────────────────────────────────────────
+
+/** Consistent copy of the latest published statistics.  Any thread. */
+static inline SensorStats readSensorStats(void) {
+    return s_sensorStats.read();
+}
+
+/** Start a new session: clear every channel at the decoder's next publish.  Any thread. */
+static inline void sensorStatsRequestReset(void) {
+    s_statsResetReq.store(true, std::memory_order_relaxed);
+}
+
+static inline float sensorStatsStdDev(const SensorChannelStats &s) {
+    return s.count > 1 ? sqrtf(s.m2 / (float)(s.count - 1)) : 0.0f;
+}
+
+/**
+ * Value below which fraction p (0..1) of the channel's samples fell,
+ * to the resolution of one histogram bucket (upper edge of the bucket).
+ */
+static inline float sensorStatsPercentile(const SensorChannelStats &s, int ch, float p) {
+    if (s.count == 0) return 0.0f;
+    const float lo = kSensorStatsRange[ch][0], hi = kSensorStatsRange[ch][1];
+    uint32_t want = (uint32_t)ceilf(p * (float)s.count), seen = 0;
+    for (int i = 0; i < SENSOR_STATS_BINS; i++) {
+        seen += s.hist[i];
+        if (seen >= want && seen > 0) {
+            float edge = lo + (hi - lo) * (float)(i + 1) / SENSOR_STATS_BINS;
+            return edge < s.max ? edge : s.max;
+        }
+    }
+    return s.max;
+}
+
+/**
+ * One-line summary of the displayed channels in mask (a SensorMask), e.g.
+ * "BOOST_KPA 98.1..187.3 mean 121.4 sd 22.0 p90<168.8".
+ * @return buf
+ */
+static inline char *sensorStatsFormat(const SensorStats &st, uint64_t mask, char *buf, size_t size) {
+    static const char *const kNames[SENSOR_CHANNEL_COUNT] = SENSOR_CHANNEL_NAMES;
+    size_t n = 0;
+    buf[0] = '\0';
+    for (int ch = 0; ch < SENSOR_DISPLAY_COUNT && n < size; ch++) {
+        const SensorChannelStats &s = st.ch[ch];
+        if (!(mask & ((uint64_t)1 << ch)) || s.count == 0) continue;
+        int w = snprintf(buf + n, size - n, "%s%s %.4g..%.4g mean %.4g sd %.3g p90<%.4g",
+                         n ? " | " : "", kNames[ch], s.min, s.max, s.mean,
+                         sensorStatsStdDev(s), sensorStatsPercentile(s, ch, 0.9f));
+        if (w < 0) break;
+        n += (size_t)w;
+    }
+    return buf;
+}
@@ -0,0 +1,82 @@
+/**
+ * seqlock.h
+ * Single-writer / multi-reader sequence lock for small POD records.
+ *
+ * The writer bumps the sequence to an odd value, stores the payload, then
+ * bumps it back to even.  A reader copies the payload between two loads of
+ * the sequence and retries if the sequence was odd or changed – so every
+ * copy a reader returns was published whole by one write() call.
+ *
+ * Neither side ever blocks: the writer never waits for readers, and readers
+ * only spin for the few hundred nanoseconds a write takes.  The payload is
+ * held as an array of 32-bit atomics (relaxed), so concurrent access is
+ * well-defined C++ and compiles to plain loads/stores on the ESP32-S3.
+ *
+ * Exactly one thread may call write(); any number may call read().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock payload must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(uint32_t) == 0, "SeqLock payload must be a multiple of 4 bytes");
+
+    static constexpr size_t kWords = sizeof(T) / sizeof(uint32_t);
+
+public:
+    explicit SeqLock(const T &initial = T()) { _store(initial); }
+
+    /** Publish a new value.  Single writer only. */
+    void write(const T &v) {
+        uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);       // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        _store(v);
+        m_seq.store(seq + 2, std::memory_order_release);       // even: stable
+    }
+
+    /**
+     * Copy out the most recently published value.
+     * @param retries  optional; receives the number of torn attempts discarded
+     */
+    T read(uint32_t *retries = nullptr) const {
+        uint32_t words[kWords];
+        uint32_t attempts = 0;
+        for (;;) {
+            uint32_t s1 = m_seq.load(std::memory_order_acquire);
+            if ((s1 & 1u) == 0) {
+                for (size_t i = 0; i < kWords; i++) {
+                    words[i] = m_words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_seq.load(std::memory_order_relaxed) == s1) break;
+            }
+            attempts++;
+        }
+        if (retries) *retries = attempts;
+        T out;
+        memcpy(&out, words, sizeof(T));
+        return out;
+    }
+
+    /** Number of completed writes since construction. */
+    uint32_t writeCount() const { return m_seq.load(std::memory_order_acquire) / 2; }
+
+private:
+    void _store(const T &v) {
+        uint32_t words[kWords];
+        memcpy(words, &v, sizeof(T));
+        for (size_t i = 0; i < kWords; i++) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint32_t> m_seq{0};
+    std::atomic<uint32_t> m_words[kWords];
+};
@@ -0,0 +1,85 @@
+/**
+ * task_signal.h
+ * Event bits posted to a single waiting thread.
+ *
+ * On the ESP32 this is the owning task's FreeRTOS direct-to-task
+ * notification used as a bit set (eSetBits): no queue or event group to
+ * allocate, and it can be posted from an ISR.  On the host – simulator and
+ * benches – it is a mutex plus condition variable, so the firmware's task
+ * code runs unchanged on std::thread.
+ *
+ *   owner:   sig.bindCurrentTask();  for (;;) { bits = sig.wait(ms); ... }
+ *   others:  sig.post(BIT);
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+class TaskSignal {
+public:
+#if defined(ESP_PLATFORM)
+    /** Make the calling task the one that wait()s.  Posts before this are dropped. */
+    void bindCurrentTask(void) { m_task = xTaskGetCurrentTaskHandle(); }
+
+    void post(uint32_t bits) {
+        TaskHandle_t t = m_task;
+        if (t) xTaskNotify(t, bits, eSetBits);
+    }
+
+    void IRAM_ATTR postFromIsr(uint32_t bits) {
+        TaskHandle_t t = m_task;
+        if (!t) return;
+        BaseType_t woken = pdFALSE;
+        xTaskNotifyFromISR(t, bits, eSetBits, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+
+    /**
+     * Block until any bit is posted or timeoutMs elapses.
+     * @return the bits posted since the last wait (0 on timeout); all cleared
+     */
+    uint32_t wait(uint32_t timeoutMs) {
+        TickType_t ticks = pdMS_TO_TICKS(timeoutMs);
+        if (ticks == 0 && timeoutMs > 0) ticks = 1;
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, ticks);
+        return bits;
+    }
+
+private:
+    TaskHandle_t volatile m_task = nullptr;
+#else
+    void bindCurrentTask(void) {}
+
+    void post(uint32_t bits) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bits |= bits;
+        }
+        m_cv.notify_one();
+    }
+
+    uint32_t wait(uint32_t timeoutMs) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return m_bits != 0; });
+        uint32_t bits = m_bits;
+        m_bits = 0;
+        return bits;
+    }
+
+private:
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+    uint32_t                m_bits = 0;
+#endif
+};
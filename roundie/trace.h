@@ -0,0 +1,246 @@
+/**
+ * trace.h
+ * Scoped trace spans on the hot paths, kept in a fixed ring buffer.
+ *
+ *   void parseCAN(...) { TRACE_SCOPE("parseCAN"); ... }
+ *
+ * A span is timed with the CPU cycle counter on the ESP32-S3 (one register
+ * read at each end) and with steady_clock on the host, and written to a
+ * TRACE_RING_LEN entry ring on scope exit; the oldest spans are
+ * overwritten.  Ticks become timestamps through a per-thread anchor
+ * (micros() and ticks read together), refreshed at the start of an
+ * outermost span once it is a second old – well before a 240 MHz cycle
+ * count wraps – so nested spans keep sub-µs order.  Any thread may record:
+ * a slot is claimed with one atomic increment.  With TRACE_ENABLED 0 every
+ * macro and function here compiles to nothing.
+ *
+ * traceWriteChrome() writes the ring as Chrome trace JSON (chrome://tracing
+ * or ui.perfetto.dev), one track per thread named with traceThreadName().
+ *
+ * The UI thread brackets each pass with traceFrameBegin()/traceFrameEnd();
+ * the longest pass and the spans inside it, and the time each thread spent
+ * in outermost spans, feed the on-screen overlay (trace_overlay.h).
+ *
+ * Span names must be string literals (only the pointer is kept).
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include "config.h"
+
+#if TRACE_ENABLED
+
+#if !defined(ESP_PLATFORM)
+#include <chrono>
+#endif
+
+#define TRACE_MAX_THREADS   8
+#define TRACE_FRAME_NAMES   8     // distinct span names in a frame's breakdown
+
+static_assert((TRACE_RING_LEN & (TRACE_RING_LEN - 1)) == 0, "TRACE_RING_LEN must be a power of two");
+
+/** One finished span. */
+struct TraceEvent {
+    std::atomic<uint32_t> seq;    // ring position + 1 once complete, 0 while written
+    const char *name;
+    uint32_t    anchorUs;         // the thread's anchor when the span started
+    uint32_t    startTicks;       // start, in trace ticks after the anchor
+    uint32_t    ticks;            // duration in trace ticks
+    uint8_t     tid;
+};
+
+/** Spans of one UI pass, summed by name. */
+struct TraceFrame {
+    const char *names[TRACE_FRAME_NAMES];
+    uint32_t    ticks[TRACE_FRAME_NAMES];
+    uint8_t     count;
+    uint32_t    total;            // the whole pass
+};
+
+static TraceEvent            s_traceRing[TRACE_RING_LEN];
+static std::atomic<uint32_t> s_traceHead{0};
+static std::atomic<bool>     s_tracePaused{false};
+
+static const char           *s_traceThreadNames[TRACE_MAX_THREADS];
+static std::atomic<uint8_t>  s_traceThreadCount{0};
+static std::atomic<uint32_t> s_traceBusy[TRACE_MAX_THREADS];   // ticks in outermost spans
+
+static thread_local int      t_traceTid   = -1;
+static thread_local uint8_t  t_traceDepth = 0;
+static thread_local bool     t_traceFrame = false;              // inside a UI pass
+static thread_local bool     t_traceAnchored = false;
+static thread_local uint32_t t_traceAnchorUs, t_traceAnchorTicks;
+
+// UI thread only; trace_overlay.h clears s_traceWorst once per window
+static TraceFrame s_traceCur, s_traceWorst;
+static uint32_t   s_traceFrameT0;
+
+// ── Clock ─────────────────────────────────────────────────────────────────────
+
+#if defined(ESP_PLATFORM)
+/** CPU cycles: per-core, but a span starts and ends on the same core. */
+static inline uint32_t traceTicks(void) { return ESP.getCycleCount(); }
+static inline uint32_t traceTicksPerUs(void) { return getCpuFrequencyMhz(); }
+#else
+static inline uint32_t traceTicks(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static inline uint32_t traceTicksPerUs(void) { return 1000; }
+#endif
+
+// ── Recording ─────────────────────────────────────────────────────────────────
+
+/** Name the calling thread's track, e.g. "ui" or "can".  Call once per thread. */
+static inline void traceThreadName(const char *name) {
+    if (t_traceTid < 0) {
+        uint8_t tid = s_traceThreadCount.fetch_add(1);
+        t_traceTid = tid < TRACE_MAX_THREADS ? tid : TRACE_MAX_THREADS - 1;
+    }
+    s_traceThreadNames[t_traceTid] = name;
+}
+
+static inline int _traceTid(void) {
+    if (t_traceTid < 0) traceThreadName("thread");
+    return t_traceTid;
+}
+
+static inline void _traceFrameAdd(TraceFrame &f, const char *name, uint32_t ticks) {
+    for (uint8_t i = 0; i < f.count; i++) {
+        if (f.names[i] == name) { f.ticks[i] += ticks; return; }
+    }
+    if (f.count < TRACE_FRAME_NAMES) {
+        f.names[f.count]   = name;
+        f.ticks[f.count++] = ticks;
+    }
+}
+
+/** Start of a span: re-anchor the thread's timestamps if outermost. */
+static inline uint32_t _traceEnter(void) {
+    if (t_traceDepth++ == 0) {
+        uint32_t us = micros();
+        if (!t_traceAnchored || us - t_traceAnchorUs >= 1000000u) {
+            t_traceAnchorUs    = us;
+            t_traceAnchorTicks = traceTicks();
+            t_traceAnchored    = true;
+        }
+    }
+    return traceTicks();
+}
+
+/** Store a span that started at tick t0 and is finishing now. */
+static inline void _traceLeave(const char *name, uint32_t t0) {
+    uint32_t ticks = traceTicks() - t0;
+    bool outermost = --t_traceDepth == 0;
+    int tid = _traceTid();
+    if (outermost) s_traceBusy[tid].fetch_add(ticks, std::memory_order_relaxed);
+    if (t_traceFrame) _traceFrameAdd(s_traceCur, name, ticks);
+    if (s_tracePaused.load(std::memory_order_relaxed)) return;
+
+    uint32_t pos = s_traceHead.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent &e = s_traceRing[pos & (TRACE_RING_LEN - 1)];
+    e.seq.store(0, std::memory_order_relaxed);
+    e.name       = name;
+    e.anchorUs   = t_traceAnchorUs;
+    e.startTicks = t0 - t_traceAnchorTicks;
+    e.ticks      = ticks;
+    e.tid        = (uint8_t)tid;
+    e.seq.store(pos + 1, std::memory_order_release);
+}
+
+/** Times the enclosing scope. */
+class TraceScope {
+public:
+    explicit TraceScope(const char *name) : m_name(name), m_t0(_traceEnter()) {}
+    ~TraceScope() { _traceLeave(m_name, m_t0); }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+private:
+    const char *m_name;
+    uint32_t    m_t0;
+};
+
+#define _TRACE_CAT2(a, b)  a##b
+#define _TRACE_CAT(a, b)   _TRACE_CAT2(a, b)
+#define TRACE_SCOPE(name)  TraceScope _TRACE_CAT(_traceScope, __LINE__)(name)
+
+// ── UI passes ─────────────────────────────────────────────────────────────────
+
+/** Start of a UI pass: its spans are summed for the worst-frame breakdown. */
+static inline void traceFrameBegin(void) {
+    memset(&s_traceCur, 0, sizeof(s_traceCur));
+    t_traceFrame   = true;
+    s_traceFrameT0 = _traceEnter();
+}
+
+static inline void traceFrameEnd(void) {
+    uint32_t ticks = traceTicks() - s_traceFrameT0;
+    t_traceFrame = false;
+    _traceLeave("ui pass", s_traceFrameT0);
+    s_traceCur.total = ticks;
+    if (ticks > s_traceWorst.total) s_traceWorst = s_traceCur;
+}
+
+// ── Chrome trace export ───────────────────────────────────────────────────────
+
+typedef void (*TraceWriteFn)(const char *s, size_t n, void *ctx);
+
+/**
+ * Write the ring, oldest span first, as Chrome trace JSON through write.
+ * Recording is paused meanwhile.
+ * @return number of spans written
+ */
+static inline uint32_t traceWriteChrome(TraceWriteFn write, void *ctx) {
+    s_tracePaused.store(true);
+    char buf[160];
+    int n = snprintf(buf, sizeof(buf), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    write(buf, (size_t)n, ctx);
+    const char *sep = "";
+    uint8_t threads = s_traceThreadCount.load();
+    for (uint8_t t = 0; t < threads && t < TRACE_MAX_THREADS; t++) {
+        n = snprintf(buf, sizeof(buf),
+                     "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                     "\"args\":{\"name\":\"%s\"}}", sep, (unsigned)t,
+                     s_traceThreadNames[t] ? s_traceThreadNames[t] : "thread");
+        write(buf, (size_t)n, ctx);
+        sep = ",\n";
+    }
+
+    uint32_t head  = s_traceHead.load();
+    uint32_t first = head > TRACE_RING_LEN ? head - TRACE_RING_LEN : 0;
+    double   perUs = traceTicksPerUs();
+    uint32_t written = 0;
+    for (uint32_t pos = first; pos != head; pos++) {
+        const TraceEvent &e = s_traceRing[pos & (TRACE_RING_LEN - 1)];
+        if (e.seq.load(std::memory_order_acquire) != pos + 1) continue;   // still being written
+        // double: µs since boot outgrow a float's precision
+        double ts = e.anchorUs + e.startTicks / perUs;
+        n = snprintf(buf, sizeof(buf),
+                     "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                     "\"ts\":%.3f,\"dur\":%.3f}",
+                     sep, e.name, (unsigned)e.tid, ts, e.ticks / perUs);
+        write(buf, (size_t)n, ctx);
+        sep = ",\n";
+        written++;
+    }
+    write("\n]}\n", 4, ctx);
+    s_tracePaused.store(false);
+    return written;
+}
+
+#else  // !TRACE_ENABLED
+
+#define TRACE_SCOPE(name)  ((void)0)
+
+typedef void (*TraceWriteFn)(const char *s, size_t n, void *ctx);
+
+static inline void     traceThreadName(const char *) {}
+static inline void     traceFrameBegin(void) {}
+static inline void     traceFrameEnd(void) {}
+static inline uint32_t traceWriteChrome(TraceWriteFn, void *) { return 0; }
+
+#endif  // TRACE_ENABLED
@@ -0,0 +1,116 @@
+/**
+ * trace_overlay.h
+ * Frame rate, thread load and the worst UI pass, shown on the display.
+ *
+ * Fed by trace.h: once a second traceOverlayUpdate() rewrites a small label
+ * on the top layer, above every screen, e.g.
+ *
+ *   58 fps  ui 31%  can 4%  log 0%
+ *   worst 21.4 ms
+ *   lv_timer_handler 17.9
+ *   _displayFlush 9.2
+ *   updateAnalogBoostScreen 2.6
+ *
+ *   fps     frames LVGL rendered (LV_EVENT_RENDER_READY)
+ *   load    share of the second each named thread spent in outermost spans
+ *   worst   the longest UI pass and, largest first, the spans summed within
+ *           it (nested spans are counted in their parent too)
+ *
+ * Hidden until traceOverlayShow(true); the numbers are gathered either way.
+ * Compiles to nothing with TRACE_ENABLED 0.  UI thread only.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include "trace.h"
+
+#if TRACE_ENABLED
+
+#define TRACE_OVERLAY_TOP   3     // spans listed for the worst pass
+
+static lv_obj_t *s_traceLabel  = nullptr;
+static uint32_t  s_traceFrames = 0;         // LVGL renders in the current window
+static uint32_t  s_traceWindowMs;
+
+static void _traceRenderCb(lv_event_t *e) {
+    (void)e;
+    s_traceFrames++;
+}
+
+/** Create the (hidden) overlay on disp's top layer and start counting frames. */
+static void traceOverlayInstall(lv_display_t *disp) {
+    lv_display_add_event_cb(disp, _traceRenderCb, LV_EVENT_RENDER_READY, nullptr);
+    s_traceLabel = lv_label_create(lv_display_get_layer_top(disp));
+    lv_obj_set_style_text_font(s_traceLabel, &lv_font_unscii_8, 0);
+    lv_obj_set_style_text_color(s_traceLabel, lv_color_make(0x00, 0xFF, 0x80), 0);
+    lv_obj_set_style_text_align(s_traceLabel, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_bg_color(s_traceLabel, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(s_traceLabel, LV_OPA_70, 0);
+    lv_obj_set_style_pad_all(s_traceLabel, 3, 0);
+    lv_obj_align(s_traceLabel, LV_ALIGN_BOTTOM_MID, 0, -60);   // inside the round panel
+    lv_label_set_text(s_traceLabel, "");
+    lv_obj_add_flag(s_traceLabel, LV_OBJ_FLAG_HIDDEN);
+    s_traceWindowMs = lv_tick_get();
+}
+
+static void traceOverlayShow(bool show) {
+    if (!s_traceLabel) return;
+    if (show) lv_obj_remove_flag(s_traceLabel, LV_OBJ_FLAG_HIDDEN);
+    else      lv_obj_add_flag(s_traceLabel, LV_OBJ_FLAG_HIDDEN);
+}
+
+static bool traceOverlayShown(void) {
+    return s_traceLabel && !lv_obj_has_flag(s_traceLabel, LV_OBJ_FLAG_HIDDEN);
+}
+
+/**
+ * Once a second: refresh the overlay text and start a new window.  UI
+ * thread, between UI passes.
+ */
+static void traceOverlayUpdate(void) {
+    uint32_t elapsed = lv_tick_elaps(s_traceWindowMs);
+    if (!s_traceLabel || elapsed < 1000) return;
+    s_traceWindowMs = lv_tick_get();
+
+    char   text[200];
+    size_t n = 0;
+    float  windowTicks = (float)elapsed * 1000.0f * traceTicksPerUs();
+    n += snprintf(text + n, sizeof(text) - n, "%lu fps",
+                  (unsigned long)(s_traceFrames * 1000u / elapsed));
+    s_traceFrames = 0;
+    uint8_t threads = s_traceThreadCount.load();
+    for (uint8_t t = 0; t < threads && t < TRACE_MAX_THREADS && n < sizeof(text); t++) {
+        uint32_t busy = s_traceBusy[t].exchange(0, std::memory_order_relaxed);
+        n += snprintf(text + n, sizeof(text) - n, "  %s %.0f%%",
+                      s_traceThreadNames[t] ? s_traceThreadNames[t] : "?",
+                      100.0f * busy / windowTicks);
+    }
+
+    // Worst pass, its largest spans first
+    TraceFrame &w = s_traceWorst;
+    float perMs = 1000.0f * traceTicksPerUs();
+    if (n < sizeof(text)) {
+        n += snprintf(text + n, sizeof(text) - n, "\nworst %.1f ms", w.total / perMs);
+    }
+    for (int k = 0; k < TRACE_OVERLAY_TOP && n < sizeof(text); k++) {
+        int best = -1;
+        for (int i = 0; i < w.count; i++) {
+            if (w.ticks[i] && (best < 0 || w.ticks[i] > w.ticks[best])) best = i;
+        }
+        if (best < 0) break;
+        n += snprintf(text + n, sizeof(text) - n, "\n%s %.1f", w.names[best], w.ticks[best] / perMs);
+        w.ticks[best] = 0;
+    }
+    memset(&s_traceWorst, 0, sizeof(s_traceWorst));
+    if (traceOverlayShown()) lv_label_set_text(s_traceLabel, text);
+}
+
+#else  // !TRACE_ENABLED
+
+static inline void traceOverlayInstall(lv_display_t *) {}
+static inline void traceOverlayShow(bool) {}
+static inline bool traceOverlayShown(void) { return false; }
+static inline void traceOverlayUpdate(void) {}
+
+#endif  // TRACE_ENABLED
@@ -0,0 +1,206 @@
+/**
+ * ui_runtime.h
+ * Scheduling of the UI thread – the only thread that calls into LVGL.
+ *
+ * The CAN task decodes frames and publishes sensor records on its own core;
+ * when a publish changes a channel's value it calls uiRuntimePost(), which
+ * stamps the change, ORs the channel into a shared SensorMask and posts a
+ * single wake bit to the UI thread's TaskSignal.  The UI thread takes the
+ * whole mask when it wakes, so the channel count is not bound by the width
+ * of a task notification.  It never polls or sleeps a fixed delay: each
+ * uiRuntimeStep() runs the per-screen update if one is due, then
+ * lv_timer_handler(), and returns how long the thread may block in
+ * TaskSignal::wait() – until the next LVGL timer, the next due update, or a
+ * new signal, whichever comes first.
+ *
+ * A screen update is due when
+ *   - a channel the active screen displays changed, and that channel has not
+ *     triggered an update within its own UI_CHANNEL_PERIOD_MS cap (about one
+ *     frame for boost and lambda, a second for coolant),
+ *   - the active screen changed, or
+ *   - UI_UPDATE_PERIOD_MS passed on a screen that changes with time alone
+ *     (the clock), or
+ *   - UI_ANIM_FRAME_MS passed and the previous update reported a value still
+ *     moving toward its latest sample (sensor_interp.h).  Once everything
+ *     has settled the screen is left alone until the next change.
+ * An update redraws every widget of the screen from the latest record, so
+ * all pending channels are consumed with it; the caps only limit how often
+ * a channel can trigger one.  Changes to channels the screen does not show
+ * are dropped without waking LVGL.
+ *
+ * The time from uiRuntimePost() to the update that shows the change is
+ * collected into a histogram for uiRuntimeLatency().  Both the firmware's UI
+ * task and the simulator's main loop are built on it.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include <atomic>
+#include <string.h>
+#include "config.h"
+#include "can_handler.h"
+#include "task_signal.h"
+#include "trace.h"
+
+// Signal bits
+#define UI_SIG_CHANGED   (1u << 0)   // UiRuntime::changed has channels
+
+#define UI_LATENCY_BIN_US  500   // histogram resolution
+#define UI_LATENCY_BINS    128   // last bin collects everything beyond 63.5 ms
+
+/**
+ * Refresh the widgets of the given screen from the latest data.
+ * @return true while a widget is still animating toward its latest value
+ */
+typedef bool (*UiUpdateFn)(int screen);
+
+static const uint16_t kUiChannelPeriodMs[] = UI_CHANNEL_PERIOD_MS;
+static_assert(sizeof(kUiChannelPeriodMs) / sizeof(kUiChannelPeriodMs[0]) == SENSOR_DISPLAY_COUNT,
+              "UI_CHANNEL_PERIOD_MS needs one entry per displayed channel");
+
+struct UiRuntime {
+    TaskSignal signal;                        // posted by the CAN task
+    std::atomic<SensorMask> changed{0};       // posted channels, taken by the UI thread
+    std::atomic<uint32_t> postUs[SENSOR_DISPLAY_COUNT] = {};  // first unshown change (0 = none)
+    SensorMask pending      = 0;              // changed channels not yet shown
+    uint32_t   lastUpdateMs = 0;
+    uint32_t   chUpdateMs[SENSOR_DISPLAY_COUNT] = {};  // last update triggered per channel
+    int        lastScreen   = -1;             // screen of the last update
+    bool       animating    = false;          // last update left a value moving
+    uint32_t   wakeups      = 0;              // since the last uiRuntimeStats()
+    uint32_t   updates      = 0;
+    uint32_t   latency[UI_LATENCY_BINS] = {}; // since the last uiRuntimeLatency()
+    uint32_t   latencyMaxUs = 0;
+};
+
+static UiRuntime s_uiRuntime;
+
+/**
+ * Report changed channels to the UI thread.  Called by the decoding thread
+ * after a publish; only the first change since the channel was last shown
+ * is stamped, so the latency covers the full wait.
+ */
+static void uiRuntimePost(UiRuntime &rt, SensorMask channels) {
+    if (!channels) return;
+    uint32_t now = micros() | 1;   // 0 means "no change pending"
+    for (SensorMask m = channels; m; m &= m - 1) {
+        uint32_t none = 0;
+        rt.postUs[__builtin_ctzll(m)].compare_exchange_strong(none, now, std::memory_order_relaxed);
+    }
+    rt.changed.fetch_or(channels, std::memory_order_release);
+    rt.signal.post(UI_SIG_CHANGED);
+}
+
+/** Clear the change stamps of channels; record their latency if shown. */
+static void _uiRuntimeConsume(UiRuntime &rt, SensorMask channels, bool shown) {
+    uint32_t now = micros();
+    for (SensorMask m = channels; m; m &= m - 1) {
+        uint32_t t = rt.postUs[__builtin_ctzll(m)].exchange(0, std::memory_order_relaxed);
+        if (!t || !shown) continue;
+        uint32_t us = now - t;
+        uint32_t bin = us / UI_LATENCY_BIN_US;
+        rt.latency[bin < UI_LATENCY_BINS ? bin : UI_LATENCY_BINS - 1]++;
+        if (us > rt.latencyMaxUs) rt.latencyMaxUs = us;
+    }
+}
+
+/**
+ * One pass of the UI thread.
+ *
+ * @param bits        signal bits returned by the previous wait
+ * @param screen      index of the active screen
+ * @param channels    the channels the screen displays
+ * @param timeDriven  the screen changes with time alone, so update it every
+ *                    UI_UPDATE_PERIOD_MS even without new sensor data
+ * @param maxSleepMs  upper bound on the returned wait (e.g. for input polling)
+ * @return ms the thread may block waiting for the next signal
+ */
+static uint32_t uiRuntimeStep(UiRuntime &rt, uint32_t bits, int screen, SensorMask channels,
+                              bool timeDriven, UiUpdateFn update, uint32_t maxSleepMs) {
+    traceFrameBegin();
+    rt.wakeups++;
+    if (bits & UI_SIG_CHANGED) rt.pending |= rt.changed.exchange(0, std::memory_order_acquire);
+    SensorMask hidden = rt.pending & ~channels;
+    if (hidden) {
+        _uiRuntimeConsume(rt, hidden, false);
+        rt.pending &= ~hidden;
+    }
+
+    // Pending channels whose cap has expired; otherwise the earliest expiry
+    uint32_t now       = lv_tick_get();
+    bool     due       = screen != rt.lastScreen;
+    uint32_t nextDueMs = UINT32_MAX;
+    for (SensorMask m = rt.pending; m; m &= m - 1) {
+        int ch = __builtin_ctzll(m);
+        uint32_t since = now - rt.chUpdateMs[ch];
+        if (since >= kUiChannelPeriodMs[ch]) due = true;
+        else if (kUiChannelPeriodMs[ch] - since < nextDueMs) nextDueMs = kUiChannelPeriodMs[ch] - since;
+    }
+    uint32_t since = now - rt.lastUpdateMs;
+    if (timeDriven && since >= UI_UPDATE_PERIOD_MS) due = true;
+    if (rt.animating && since >= UI_ANIM_FRAME_MS)  due = true;
+
+    if (due) {
+        rt.animating = update(screen);
+        _uiRuntimeConsume(rt, rt.pending, true);
+        for (SensorMask m = rt.pending; m; m &= m - 1) rt.chUpdateMs[__builtin_ctzll(m)] = now;
+        rt.pending      = 0;
+        rt.lastUpdateMs = now;
+        rt.lastScreen   = screen;
+        rt.updates++;
+        nextDueMs = UINT32_MAX;
+        since     = 0;
+    }
+
+    uint32_t wait;
+    {
+        TRACE_SCOPE("lv_timer_handler");
+        wait = lv_timer_handler();               // LV_NO_TIMER_READY is clamped too
+    }
+    traceFrameEnd();
+    if (wait > maxSleepMs) wait = maxSleepMs;
+    if (nextDueMs < wait) wait = nextDueMs;
+    if (timeDriven && UI_UPDATE_PERIOD_MS - since < wait) wait = UI_UPDATE_PERIOD_MS - since;
+    if (rt.animating && UI_ANIM_FRAME_MS - since < wait)  wait = UI_ANIM_FRAME_MS - since;
+    return wait;
+}
+
+/** UI thread wakeups and screen updates per second since the previous call. */
+static void uiRuntimeStats(UiRuntime &rt, uint32_t periodMs, uint32_t &wakeupsPerSec,
+                           uint32_t &updatesPerSec) {
+    wakeupsPerSec = periodMs ? rt.wakeups * 1000u / periodMs : 0;
+    updatesPerSec = periodMs ? rt.updates * 1000u / periodMs : 0;
+    rt.wakeups = 0;
+    rt.updates = 0;
+}
+
+/** Change-to-update latency since the previous uiRuntimeLatency(). */
+struct UiLatencyReport {
+    uint32_t count;                  // changes shown
+    uint32_t p50Us, p90Us, p99Us;    // upper edge of the percentile's bin
+    uint32_t maxUs;
+};
+
+/** Summarise and reset the latency histogram. */
+static UiLatencyReport uiRuntimeLatency(UiRuntime &rt) {
+    UiLatencyReport r = {};
+    for (uint32_t i = 0; i < UI_LATENCY_BINS; i++) r.count += rt.latency[i];
+    r.maxUs = rt.latencyMaxUs;
+    if (r.count) {
+        const uint32_t want[3] = { (r.count * 50 + 99) / 100, (r.count * 90 + 99) / 100,
+                                   (r.count * 99 + 99) / 100 };
+        uint32_t *out[3] = { &r.p50Us, &r.p90Us, &r.p99Us };
+        uint32_t seen = 0, k = 0;
+        for (uint32_t i = 0; i < UI_LATENCY_BINS && k < 3; i++) {
+            seen += rt.latency[i];
+            while (k < 3 && seen >= want[k]) {
+                *out[k++] = LV_MIN((i + 1) * UI_LATENCY_BIN_US, r.maxUs);
+            }
+        }
+    }
+    memset(rt.latency, 0, sizeof(rt.latency));
+    rt.latencyMaxUs = 0;
+    return r;
+}
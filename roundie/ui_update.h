@@ -0,0 +1,231 @@
+/**
+ * ui_update.h
+ * Change-driven widget updates.
+ *
+ * Each Ui* wrapper remembers what the widget currently shows, quantized to
+ * what the display can actually resolve, and only calls into LVGL when that
+ * changes.  Unchanged updates are a compare and a return: no style refresh,
+ * no invalidated area, no redraw.
+ *
+ *   UiArc     – arc indicator, quantized to whole degrees of sweep
+ *   UiArcMark – short arc segment marking a value (peak hold), whole degrees
+ *   UiLabel   – fixed-point numeric text, or a constant string
+ *   UiNeedle  – dial_hand.h needle, quantized to whole scale units
+ *   uiSetState() – toggles a widget state (e.g. LV_STATE_USER_1 for the lean
+ *                  warning) whose styles were set up once at creation
+ *
+ * Invalidated pixels are counted through the display's
+ * LV_EVENT_INVALIDATE_AREA event (uiStatsInstall()), so the saving can be
+ * read back as pixels per second.  s_uiDirtyCheck = false bypasses every
+ * cache, for A/B comparison on the same trace.
+ */
+
+#pragma once
+
+#include <lvgl.h>
+#include <stdio.h>
+#include <math.h>
+
+#if LVGL_VERSION_MAJOR >= 9
+#include "dial_hand.h"
+#endif
+
+// ── Global switch ─────────────────────────────────────────────────────────────
+static bool s_uiDirtyCheck = true;   // false → push every update to LVGL
+
+// ── Arc ───────────────────────────────────────────────────────────────────────
+
+/** Arc widget plus the range and indicator angle last drawn. */
+struct UiArc {
+    lv_obj_t *obj;
+    int32_t   sweepDeg;   // background sweep, e.g. 240 for bg_angles 150→30
+    int32_t   min, max;   // range last applied
+    int32_t   deg;        // indicator end, in whole degrees from the start
+};
+
+static void uiArcInit(UiArc &a, lv_obj_t *arc, int32_t sweepDeg) {
+    a.obj      = arc;
+    a.sweepDeg = sweepDeg;
+    a.min      = lv_arc_get_min_value(arc);
+    a.max      = lv_arc_get_max_value(arc);
+    a.deg      = -1;      // force the first update through
+}
+
+/**
+ * Show value on a min..max scale.  LVGL draws the indicator in whole
+ * degrees, so values that land on the same degree are skipped.
+ */
+static void uiArcSet(UiArc &a, int32_t min, int32_t max, int32_t value) {
+    if (value < min) value = min;
+    if (value > max) value = max;
+    int32_t deg = (int32_t)lv_map(value, min, max, 0, a.sweepDeg);
+
+    bool rangeChanged = (min != a.min || max != a.max);
+    if (s_uiDirtyCheck && !rangeChanged && deg == a.deg) return;
+
+    if (rangeChanged || !s_uiDirtyCheck) {
+        lv_arc_set_range(a.obj, min, max);
+        a.min = min;
+        a.max = max;
+    }
+    lv_arc_set_value(a.obj, value);
+    a.deg = deg;
+}
+
+/**
+ * Marker on an arc's scale: an indicator-only arc of widthDeg over the same
+ * background angles, moved with lv_arc_set_angles() so only the old and new
+ * segment are redrawn.  Hidden until the first uiArcMarkSet().
+ */
+struct UiArcMark {
+    lv_obj_t *obj;
+    int32_t   startDeg;   // LVGL angle of the scale's zero (bg start angle)
+    int32_t   sweepDeg;
+    int32_t   widthDeg;
+    int32_t   deg;        // marker end, in whole degrees from the start (-1 = hidden)
+};
+
+static void uiArcMarkInit(UiArcMark &m, lv_obj_t *arc, int32_t startDeg, int32_t sweepDeg,
+                          int32_t widthDeg) {
+    m.obj      = arc;
+    m.startDeg = startDeg;
+    m.sweepDeg = sweepDeg;
+    m.widthDeg = widthDeg;
+    m.deg      = -1;
+    lv_obj_add_flag(arc, LV_OBJ_FLAG_HIDDEN);
+}
+
+/** Put the marker at value on a min..max scale; skipped if on the same degree. */
+static void uiArcMarkSet(UiArcMark &m, int32_t min, int32_t max, int32_t value) {
+    if (value < min) value = min;
+    if (value > max) value = max;
+    int32_t deg = (int32_t)lv_map(value, min, max, 0, m.sweepDeg);
+    if (deg < m.widthDeg) deg = m.widthDeg;
+    if (s_uiDirtyCheck && deg == m.deg) return;
+
+    if (m.deg < 0) lv_obj_clear_flag(m.obj, LV_OBJ_FLAG_HIDDEN);
+    int32_t end = m.startDeg + deg;
+    lv_arc_set_angles(m.obj, (end - m.widthDeg) % 360, end % 360);
+    m.deg = deg;
+}
+
+// ── Label ─────────────────────────────────────────────────────────────────────
+
+/** Label plus the value (or constant string) it currently shows. */
+struct UiLabel {
+    lv_obj_t   *obj;
+    int32_t     tenths;   // fixed-point value shown by uiLabelSetTenths()
+    const char *text;     // string shown by uiLabelSetStatic()
+    char        buf[12];  // backing store for formatted text
+};
+
+static void uiLabelInit(UiLabel &l, lv_obj_t *label) {
+    l.obj    = label;
+    l.tenths = INT32_MIN;
+    l.text   = nullptr;
+    l.buf[0] = '\0';
+}
+
+/** Show v with one decimal, re-formatting only when the shown digit changes. */
+static void uiLabelSetTenths(UiLabel &l, float v) {
+    int32_t tenths = (int32_t)lroundf(v * 10.0f);
+    if (s_uiDirtyCheck && tenths == l.tenths) return;
+    l.tenths = tenths;
+    l.text   = nullptr;
+
+    uint32_t mag = tenths < 0 ? (uint32_t)-tenths : (uint32_t)tenths;
+    snprintf(l.buf, sizeof(l.buf), "%s%lu.%lu", tenths < 0 ? "-" : "",
+             (unsigned long)(mag / 10), (unsigned long)(mag % 10));
+    lv_label_set_text_static(l.obj, l.buf);
+}
+
+/** Show a string literal; pointer identity decides whether it changed. */
+static void uiLabelSetStatic(UiLabel &l, const char *text) {
+    if (s_uiDirtyCheck && text == l.text) return;
+    l.text   = text;
+    l.tenths = INT32_MIN;
+    lv_label_set_text_static(l.obj, text);
+}
+
+// ── Needle ────────────────────────────────────────────────────────────────────
+
+#if LVGL_VERSION_MAJOR >= 9
+/** Needle drawn as a dial_hand.h hand, plus the value it points at. */
+struct UiNeedle {
+    DialHandSet *set;
+    int          hand;               // index in set
+    int32_t      min, max;           // value range
+    int32_t      startDeg, sweepDeg; // angle of min and sweep to max (0° = 3 o'clock, clockwise)
+    int32_t      value;
+};
+
+static void uiNeedleInit(UiNeedle &n, DialHandSet &set, int hand,
+                         int32_t min, int32_t max, int32_t startDeg, int32_t sweepDeg) {
+    n.set      = &set;
+    n.hand     = hand;
+    n.min      = min;
+    n.max      = max;
+    n.startDeg = startDeg;
+    n.sweepDeg = sweepDeg;
+    n.value    = INT32_MIN;
+}
+
+/**
+ * Point the needle at value, clamped to the range; skipped if unchanged.
+ * The hand itself only invalidates its old and new footprints, and nothing
+ * when the new angle rounds to the same pixels.
+ */
+static void uiNeedleSet(UiNeedle &n, int32_t value) {
+    if (value < n.min) value = n.min;
+    if (value > n.max) value = n.max;
+    if (s_uiDirtyCheck && value == n.value) return;
+    n.value = value;
+
+    float deg = n.startDeg + (float)(value - n.min) * n.sweepDeg / (float)(n.max - n.min);
+    dialHandSetAngle(*n.set, n.hand, deg);
+}
+#endif
+
+// ── Widget state ──────────────────────────────────────────────────────────────
+
+/** Add or clear a state bit; a no-op when it is already as requested. */
+static void uiSetState(lv_obj_t *obj, lv_state_t state, bool on) {
+    if (s_uiDirtyCheck && lv_obj_has_state(obj, state) == on) return;
+    if (on) lv_obj_add_state(obj, state);
+    else    lv_obj_remove_state(obj, state);
+}
+
+// ── Invalidation accounting ───────────────────────────────────────────────────
+
+static uint64_t s_uiInvalidPx     = 0;   // pixels invalidated since the last report
+static uint32_t s_uiInvalidSinceMs = 0;
+
+static void _uiInvalidateCb(lv_event_t *e) {
+    lv_display_t *disp = (lv_display_t *)lv_event_get_current_target(e);
+    const lv_area_t *a = (const lv_area_t *)lv_event_get_param(e);
+    lv_area_t scr = { 0, 0,
+                      lv_display_get_horizontal_resolution(disp) - 1,
+                      lv_display_get_vertical_resolution(disp) - 1 };
+    lv_area_t clipped;
+    if (_lv_area_intersect(&clipped, a, &scr)) {
+        s_uiInvalidPx += lv_area_get_size(&clipped);
+    }
+}
+
+/** Start counting invalidated pixels on disp. */
+static void uiStatsInstall(lv_display_t *disp) {
+    lv_display_add_event_cb(disp, _uiInvalidateCb, LV_EVENT_INVALIDATE_AREA, nullptr);
+    s_uiInvalidSinceMs = lv_tick_get();
+}
+
+/**
+ * Invalidated pixels per second since the previous call; resets the window.
+ * Counts invalidation requests, so overlapping areas are counted twice.
+ */
+static uint32_t uiStatsInvalidatedPxPerSec(void) {
+    uint32_t elapsed = lv_tick_elaps(s_uiInvalidSinceMs);
+    uint32_t rate = elapsed ? (uint32_t)(s_uiInvalidPx * 1000u / elapsed) : 0;
+    s_uiInvalidPx      = 0;
+    s_uiInvalidSinceMs = lv_tick_get();
+    return rate;
+}
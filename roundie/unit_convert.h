@@ -1,34 +1,116 @@
 /**
  * unit_convert.h
- * Inline unit-conversion helpers used throughout the gauge screens.
+ * Typed physical quantities, display units and precomputed gauge mappings.
+ *
+ * Decoded channels arrive in the units the ECU sends: kPa, °C, lambda and
+ * rpm.  Wrapping them as Pressure, Temperature, Mixture or EngineSpeed
+ * stops a psi figure from reaching an arc that expects kPa – the mix-up no
+ * longer compiles.
+ * Every display unit converts with one constexpr multiply-add:
+ *
+ *   display = base × scale + offset
+ *
+ * A GaugeMap takes this one step further.  It folds a unit and a widget's
+ * integer resolution (e.g. lambda × 1000 on an arc) into a single mul/add,
+ * and keeps the widget's range, tick spacing and unit label with it.
+ * Screens hold a constexpr table with one map per UnitSystem.  When
+ * g_isMetric changes they switch tables once and re-apply the ranges; the
+ * per-frame path is then branch-free arithmetic.
  */
 
 #pragma once
 
-/**
- * Convert kilopascals to pounds-per-square-inch.
- * @param kpa  pressure in kPa
- * @return     pressure in psi
- */
-inline float kPaToPsi(float kpa) {
-    return kpa * 0.145038f;
+#include <stdint.h>
+
+// ── Quantities ────────────────────────────────────────────────────────────────
+
+/** A value of dimension Tag, held in that dimension's base unit. */
+template <typename Tag>
+struct Quantity {
+    float base;
+    constexpr explicit Quantity(float b = 0.0f) : base(b) {}
+};
+
+struct PressureTag;      // base unit kPa
+struct TemperatureTag;   // base unit °C
+struct MixtureTag;       // base unit lambda
+struct SpeedTag;         // base unit rpm
+
+typedef Quantity<PressureTag>    Pressure;
+typedef Quantity<TemperatureTag> Temperature;
+typedef Quantity<MixtureTag>     Mixture;
+typedef Quantity<SpeedTag>       EngineSpeed;
+
+/** A display unit of dimension Tag: display = base × scale + offset. */
+template <typename Tag>
+struct Unit {
+    const char *label;
+    float       scale;
+    float       offset;
+
+    constexpr float from(Quantity<Tag> q) const { return q.base * scale + offset; }
+    constexpr Quantity<Tag> to(float display) const {
+        return Quantity<Tag>((display - offset) / scale);
+    }
+};
+
+constexpr Unit<PressureTag>    kUnitKPa        = { "kPa",    1.0f,      0.0f  };
+constexpr Unit<PressureTag>    kUnitBar        = { "bar",    0.01f,     0.0f  };
+constexpr Unit<PressureTag>    kUnitPsi        = { "psi",    0.145038f, 0.0f  };
+constexpr Unit<TemperatureTag> kUnitCelsius    = { "C",      1.0f,      0.0f  };
+constexpr Unit<TemperatureTag> kUnitFahrenheit = { "F",      1.8f,      32.0f };
+constexpr Unit<MixtureTag>     kUnitLambda     = { "lambda", 1.0f,      0.0f  };
+constexpr Unit<MixtureTag>     kUnitAFR        = { "AFR",    14.7f,     0.0f  };   // gasoline stoichiometry
+constexpr Unit<SpeedTag>       kUnitRpm        = { "rpm",    1.0f,      0.0f  };
+constexpr Unit<SpeedTag>       kUnitKRpm       = { "x1000",  0.001f,    0.0f  };   // tachometer numerals
+
+// ── Unit systems ──────────────────────────────────────────────────────────────
+
+/** The unit systems selectable on the setup screen. */
+enum UnitSystem : uint8_t {
+    UNITS_METRIC = 0,     // kPa / bar, °C, lambda
+    UNITS_IMPERIAL,       // psi, °F, AFR
+    UNIT_SYSTEM_COUNT
+};
+
+static inline UnitSystem unitSystem(bool isMetric) {
+    return isMetric ? UNITS_METRIC : UNITS_IMPERIAL;
 }
 
+// ── Gauge mappings ────────────────────────────────────────────────────────────
+
 /**
- * Convert degrees Celsius to degrees Fahrenheit.
- * @param c  temperature in °C
- * @return   temperature in °F
+ * How a widget shows one quantity in one unit system.  Widget values are
+ * display units × res, as integers, so arcs and needles keep sub-unit
+ * precision.
  */
-inline float celsiusToFahrenheit(float c) {
-    return (c * 1.8f) + 32.0f;
+template <typename Tag>
+struct GaugeMap {
+    const char *label;       // unit label text
+    int32_t     lo, hi;      // widget range
+    int32_t     tickStep;    // widget units between minor ticks (0 = none)
+    int32_t     majorEvery;  // minor ticks per major tick
+    float       mul, add;    // widget value = base × mul + add
+
+    /** Widget value of q, unrounded and unclamped. */
+    constexpr float at(Quantity<Tag> q) const { return q.base * mul + add; }
+
+    /** Number of minor ticks from lo to hi inclusive. */
+    constexpr int32_t ticks() const { return tickStep ? (hi - lo) / tickStep + 1 : 0; }
+};
+
+constexpr int32_t _unitRound(float x) {
+    return (int32_t)(x < 0.0f ? x - 0.5f : x + 0.5f);
 }
 
 /**
- * Convert lambda (stoichiometric ratio) to Air-Fuel Ratio.
- * Uses gasoline stoichiometric ratio of 14.7:1.
- * @param lambda  dimensionless lambda value
- * @return        AFR value
+ * Map for a widget spanning lo..hi in unit u, at res widget steps per
+ * display unit, with minor ticks every tick display units.
  */
-inline float lambdaToAFR(float lambda) {
-    return lambda * 14.7f;
+template <typename Tag>
+constexpr GaugeMap<Tag> gaugeMap(const Unit<Tag> &u, float lo, float hi, int32_t res,
+                                 float tick = 0.0f, int32_t majorEvery = 1) {
+    return GaugeMap<Tag>{ u.label, _unitRound(lo * res), _unitRound(hi * res),
+                          _unitRound(tick * res), majorEvery,
+                          u.scale * res, u.offset * res };
 }
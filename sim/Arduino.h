@@ -5,6 +5,7 @@
  * can_handler.h includes <Arduino.h> for basic integer types.  On the
  * simulator these types come from the standard C library; this stub just
  * re-exports them so the include succeeds without an Arduino toolchain.
+ * millis()/micros() are backed by std::chrono::steady_clock.
  */
 
 #pragma once
@@ -12,3 +13,20 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+
+#ifdef __cplusplus
+#include <chrono>
+
+inline std::chrono::steady_clock::duration _simUptime(void) {
+    static const std::chrono::steady_clock::time_point s_t0 = std::chrono::steady_clock::now();
+    return std::chrono::steady_clock::now() - s_t0;
+}
+
+inline uint32_t micros(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(_simUptime()).count();
+}
+
+inline uint32_t millis(void) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(_simUptime()).count();
+}
+#endif
@@ -0,0 +1,184 @@
+/**
+ * sim/bench_can_backend.cpp
+ * The two CAN backends (roundie/can_backend.h) on the same traffic, through
+ * their host versions (sim/can_backend_host.h): the MCP2515 with its six
+ * acceptance filters and burst SPI reads, and the native TWAI controller
+ * with its two filters and the driver's receive queue.
+ *
+ * Traffic is a candump/ASC log (sim/can_log.h) or, without one, a synthetic
+ * bus of the decoder's ids, other standard ids and extended frames.  Frames
+ * arrive in bursts of 1..burst before the CAN task gets to the controller,
+ * as when it is held up by decoding or a higher-priority task; the MCP2515
+ * holds two frames, the TWAI queue CAN_TWAI_RX_QUEUE_LEN.
+ *
+ * Per backend: frames delivered, how many of them the decoder does not
+ * want (what the filters let through), frames lost to full buffers, and
+ * the per-frame receive cost – SPI transactions, bytes and bus time at
+ * CAN_SPI_CLOCK, which the CAN task spends blocked in transferBytes() on
+ * the device.  model_ns/frame is the host time spent in the read path and
+ * the hardware models; it is not the device's CPU cost and does not
+ * compare the two backends.
+ *
+ * Fails if a backend delivers a frame out of bus order for its id, or one
+ * its filters reject, or loses a frame without counting it.  Frames of
+ * different ids may swap: the MCP2515 is read RXB0 first, and RXB1 can hold
+ * the older frame.
+ *
+ * Usage:  bench_can_backend [<log> | <frames>] [burst]    (200000 frames, burst 3)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "config.h"
+#include "can_log.h"
+#include "can_backend_host.h"
+
+SensorRecord          g_sensorWork = SENSOR_RECORD_INIT;
+SeqLock<SensorRecord> g_sensors(g_sensorWork);
+
+static uint32_t s_failures = 0;
+
+static void _fail(const char *backend, const char *what) {
+    if (s_failures++ < 10) printf("FAIL %s: %s\n", backend, what);
+}
+
+static std::vector<struct can_frame> _synthetic(size_t count) {
+    std::mt19937 rng(11);
+    std::vector<struct can_frame> frames(count);
+    for (struct can_frame &f : frames) {
+        uint32_t kind = rng() % 100;
+        if (kind < 40)      f.can_id = kCanMessages[rng() % CAN_MESSAGE_COUNT].id;
+        else if (kind < 95) f.can_id = rng() & CAN_SFF_MASK;
+        else                f.can_id = (rng() & CAN_EFF_MASK) | CAN_EFF_FLAG;
+        f.can_dlc = (uint8_t)(rng() % 9);
+        for (uint8_t &b : f.data) b = (uint8_t)rng();
+    }
+    return frames;
+}
+
+/** True for a frame of a message the decoder's filters ask for (CanMessage::wanted). */
+static bool _wanted(uint32_t id) {
+    int m = canMessageIndex(id);
+    return m >= 0 && kCanMessages[m].wanted;
+}
+
+static bool _sameFrame(const struct can_frame &a, const struct can_frame &b) {
+    return a.can_id == b.can_id && a.can_dlc == b.can_dlc &&
+           memcmp(a.data, b.data, a.can_dlc) == 0;
+}
+
+struct RunResult {
+    uint64_t delivered = 0, unwanted = 0, lost = 0;
+    double   modelNs = 0;   // host time in the read path and models
+};
+
+/**
+ * bus through backend b in bursts; plan is the filter plan b installed, to
+ * check what it delivers.  lost() reads its overflow count afterwards.
+ */
+template <typename Backend, typename LostFn>
+static RunResult _run(Backend &b, const CanFilterPlan &plan, const std::vector<struct can_frame> &bus,
+                      uint32_t burst, LostFn lost) {
+    RunResult r;
+    b.begin();
+    std::mt19937 rng(5);
+    std::vector<struct can_frame> out;
+    out.reserve(bus.size());
+    size_t i = 0;
+    while (i < bus.size()) {
+        size_t arrive = 1 + rng() % burst;
+        for (size_t k = 0; k < arrive && i < bus.size(); k++, i++) b.busFrame(bus[i]);
+        if (!b.pending()) continue;
+
+        auto t0 = std::chrono::steady_clock::now();
+        struct can_frame frames[2];
+        while (uint8_t n = b.read(frames)) out.insert(out.end(), frames, frames + n);
+        r.modelNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        b.pollErrors();   // as the CAN task does after each pass; clears what holds INT low
+    }
+    r.lost = lost();
+
+    // In bus order per id, each admitted by the plan; admitted = delivered + lost
+    uint64_t admittedStd = 0, deliveredStd = 0;
+    std::map<uint32_t, std::vector<size_t>> byId;   // bus positions of each id
+    for (size_t k = 0; k < bus.size(); k++) {
+        const struct can_frame &f = bus[k];
+        byId[f.can_id].push_back(k);
+        if (!(f.can_id & CAN_EFF_FLAG) && canFilterAccepts(plan, f.can_id & CAN_SFF_MASK)) admittedStd++;
+    }
+    std::map<uint32_t, size_t> next;                // per id: first bus position not yet passed
+    for (const struct can_frame &f : out) {
+        const std::vector<size_t> &at = byId[f.can_id];
+        size_t &j = next[f.can_id];
+        while (j < at.size() && !_sameFrame(bus[at[j]], f)) j++;
+        if (j == at.size()) { _fail(b.name(), "frame delivered out of order"); break; }
+        j++;
+        if (!(f.can_id & CAN_EFF_FLAG)) {
+            deliveredStd++;
+            if (!canFilterAccepts(plan, f.can_id & CAN_SFF_MASK)) _fail(b.name(), "rejected id delivered");
+        }
+        if (!_wanted(f.can_id)) r.unwanted++;
+    }
+    if (deliveredStd > admittedStd || deliveredStd + r.lost < admittedStd) {
+        _fail(b.name(), "frames lost without being counted");
+    }
+    r.delivered = out.size();
+    return r;
+}
+
+static void _report(const char *name, const CanFilterPlan &plan, const RunResult &r,
+                    uint64_t transactions, uint64_t bytes) {
+    double n = r.delivered ? (double)r.delivered : 1.0;
+    printf("%-7s filters admit %4u ids: delivered=%llu unwanted=%llu lost=%llu "
+           "spi_transactions/frame=%.2f spi_bytes/frame=%.1f spi_us/frame=%.2f model_ns/frame=%.0f\n",
+           name, (unsigned)plan.accepted, (unsigned long long)r.delivered,
+           (unsigned long long)r.unwanted, (unsigned long long)r.lost,
+           transactions / n, bytes / n, bytes * 8.0 * 1e6 / CAN_SPI_CLOCK / n, r.modelNs / n);
+}
+
+int main(int argc, char **argv) {
+    std::vector<struct can_frame> bus;
+    const char *source = "synthetic";
+    if (argc > 1 && atol(argv[1]) <= 0) {
+        CanLogReader reader;
+        if (!reader.open(argv[1])) {
+            fprintf(stderr, "cannot open %s\n", argv[1]);
+            return 2;
+        }
+        CanLogFrame f;
+        while (reader.next(f)) bus.push_back(f.frame);
+        source = argv[1];
+    } else {
+        bus = _synthetic(argc > 1 ? (size_t)atol(argv[1]) : 200000);
+    }
+    uint32_t burst = argc > 2 ? (uint32_t)atoi(argv[2]) : 3;
+    if (burst < 1) burst = 1;
+
+    uint64_t wanted = 0;
+    for (const struct can_frame &f : bus) wanted += _wanted(f.can_id);
+    printf("bench_can_backend: %s, %zu frames on the bus (%llu for the decoder), bursts of 1-%u\n",
+           source, bus.size(), (unsigned long long)wanted, (unsigned)burst);
+
+    CanFilterPlan mcpPlan, twaiPlan;
+    if (canDecoderFilterPlan(mcpPlan) || canDecoderFilterPlanBanks(twaiPlan, 1, 1)) {
+        fprintf(stderr, "no filter plan for the decoder's ids\n");
+        return 2;
+    }
+
+    static CanHostMcp2515 mcp;
+    RunResult m = _run(mcp, mcpPlan, bus, burst, [&] { return mcp.chip().overflows(); });
+    _report(mcp.name(), mcpPlan, m, mcp.chip().transactions(), mcp.chip().bytes());
+
+    static CanHostTwai twai;
+    RunResult t = _run(twai, twaiPlan, bus, burst, [&] { return (uint64_t)twai.twai().missed(); });
+    _report(twai.name(), twaiPlan, t, 0, 0);
+
+    printf("%s\n", s_failures == 0 ? "PASS" : "FAIL");
+    return s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,268 @@
+/**
+ * sim/bench_can_filter.cpp
+ * The MCP2515 acceptance-filter planner (can_filter.h): correctness on
+ * random id sets, planning time, and over-acceptance on a recorded bus.
+ *
+ * Self-check, always run:
+ *   - every wanted id passes the planned filters, and the plan's accepted
+ *     count matches a scan of all 2048 standard ids;
+ *   - up to six ids are always filtered exactly;
+ *   - on small sets the plan is as good as an unpruned search over every
+ *     mask pair (bits the ids never differ on stay fixed in both);
+ *   - the same for TWAI dual-filter plans (one filter per mask), which
+ *     filter up to two ids exactly.
+ *
+ * With a log (candump -l or Vector ASC, sim/can_log.h) the plan is made for
+ * the decoder's wanted ids (CanMessage::wanted), the ids given on the
+ * command line, or the N busiest ids of the log (--top N), and every frame
+ * is run through it: frames admitted but not wanted are the SPI reads and
+ * decoder passes the filters failed to save.
+ *
+ * Usage:  bench_can_filter [<log> [--top N | id ...]]
+ * Exit status is non-zero if a check fails.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "config.h"
+#include "can_log.h"
+#include "../roundie/can_filter.h"
+#include "../roundie/can_signals.h"
+
+static uint32_t s_failures = 0;
+
+static void _fail(const char *what, const std::vector<uint32_t> &ids) {
+    if (s_failures++ < 10) {
+        printf("FAIL %s, ids:", what);
+        for (uint32_t id : ids) printf(" %03X", (unsigned)id);
+        printf("\n");
+    }
+}
+
+static uint32_t _scanAccepted(const CanFilterPlan &plan) {
+    uint32_t n = 0;
+    for (uint32_t id = 0; id <= CAN_FILTER_ID_MASK; id++) n += canFilterAccepts(plan, id);
+    return n;
+}
+
+/**
+ * Reference: every MASK0/MASK1 over the varying bits, every choice of up to
+ * filters0 RXB0 classes, RXB1 taking the rest in up to filters1, scored by
+ * scanning all ids.
+ */
+static uint32_t _bruteForceAccepted(const std::vector<uint32_t> &ids,
+                                    size_t filters0 = 2, size_t filters1 = 4) {
+    uint16_t varying = 0;
+    for (uint32_t id : ids) varying |= (uint16_t)(id ^ ids[0]);
+    std::vector<uint16_t> subs;
+    uint16_t sub = 0;
+    do { subs.push_back(sub); sub = (uint16_t)((sub - varying) & varying); } while (sub);
+
+    uint32_t best = CAN_FILTER_ID_MASK + 1;
+    for (uint16_t free0 : subs) {
+        uint16_t m0 = CAN_FILTER_ID_MASK & ~free0;
+        std::vector<uint16_t> classes;
+        for (uint32_t id : ids) {
+            if (std::find(classes.begin(), classes.end(), id & m0) == classes.end()) {
+                classes.push_back((uint16_t)(id & m0));
+            }
+        }
+        // a < 0: RXB0 unused
+        for (int a = -1; a < (int)classes.size(); a++) {
+            int lastB = filters0 > 1 ? (int)classes.size() : a + 1;
+            for (int b = a; b < lastB; b++) {
+                std::vector<uint32_t> rest;
+                for (uint32_t id : ids) {
+                    bool in0 = a >= 0 && ((id & m0) == classes[a] || (id & m0) == classes[b]);
+                    if (!in0) rest.push_back(id);
+                }
+                for (uint16_t free1 : subs) {
+                    uint16_t m1 = CAN_FILTER_ID_MASK & ~free1;
+                    std::vector<uint16_t> values1;
+                    for (uint32_t id : rest) {
+                        if (std::find(values1.begin(), values1.end(), id & m1) == values1.end()) {
+                            values1.push_back((uint16_t)(id & m1));
+                        }
+                    }
+                    if (values1.size() > filters1) continue;
+                    CanFilterPlan p;
+                    p.mask[0] = a >= 0 ? m0 : CAN_FILTER_ID_MASK;
+                    p.mask[1] = m1;
+                    p.filter[0] = a >= 0 ? classes[a] : (uint16_t)ids[0];
+                    p.filter[1] = a >= 0 ? classes[b] : (uint16_t)ids[0];
+                    for (int f = 0; f < 4; f++) {
+                        p.filter[2 + f] = values1.empty() ? (uint16_t)ids[0]
+                                        : values1[(size_t)f < values1.size() ? f : 0];
+                    }
+                    uint32_t n = _scanAccepted(p);
+                    if (n < best) best = n;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+/** count distinct ids: all within span ids of base, or anywhere if span is 0. */
+static std::vector<uint32_t> _randomIds(std::mt19937 &rng, size_t count, uint32_t base, uint32_t span) {
+    std::vector<uint32_t> ids;
+    while (ids.size() < count) {
+        uint32_t id = span ? base + rng() % span : rng() & CAN_FILTER_ID_MASK;
+        if (std::find(ids.begin(), ids.end(), id) == ids.end()) ids.push_back(id);
+    }
+    return ids;
+}
+
+static void _selfCheck(void) {
+    std::mt19937 rng(1);
+    struct Shape { const char *name; uint32_t base, span; };
+    static const Shape kShapes[] = {
+        { "cluster32",  0x3D0, 32   },   // one ECU's block of ids
+        { "haltech",    0x360, 160  },   // a Haltech V2 broadcast range
+        { "anywhere",   0,     0    },
+    };
+    for (const Shape &shape : kShapes) {
+        double totalUs = 0, worstUs = 0;
+        uint64_t unwanted = 0, twaiUnwanted = 0;
+        uint32_t plans = 0;
+        for (size_t count = 1; count <= CAN_FILTER_MAX_IDS; count++) {
+            if (shape.span && count > shape.span) break;
+            for (int rep = 0; rep < 4; rep++) {
+                std::vector<uint32_t> ids = _randomIds(rng, count, shape.base, shape.span);
+                CanFilterPlan plan;
+                auto t0 = std::chrono::steady_clock::now();
+                const char *err = canFilterPlan(plan, ids.data(), ids.size());
+                double us = std::chrono::duration<double, std::micro>(
+                    std::chrono::steady_clock::now() - t0).count();
+                totalUs += us;
+                worstUs  = std::max(worstUs, us);
+                plans++;
+                if (err) { _fail(err, ids); continue; }
+                unwanted += plan.unwanted;
+
+                for (uint32_t id : ids) {
+                    if (!canFilterAccepts(plan, id)) { _fail("wanted id rejected", ids); break; }
+                }
+                if (_scanAccepted(plan) != plan.accepted) _fail("accepted count wrong", ids);
+                if (count <= 6 && plan.unwanted != 0) _fail("six ids or fewer not exact", ids);
+
+                uint16_t varying = 0;
+                for (uint32_t id : ids) varying |= (uint16_t)(id ^ ids[0]);
+                if (count <= 10 && __builtin_popcount(varying) <= 5 && rep < 2 &&
+                    _bruteForceAccepted(ids) != plan.accepted) {
+                    _fail("not optimal", ids);
+                }
+
+                CanFilterPlan dual;
+                if (const char *e = canFilterPlanBanks(dual, ids.data(), ids.size(), 1, 1)) {
+                    _fail(e, ids);
+                    continue;
+                }
+                twaiUnwanted += dual.unwanted;
+                for (uint32_t id : ids) {
+                    if (!canFilterAccepts(dual, id)) { _fail("twai: wanted id rejected", ids); break; }
+                }
+                if (_scanAccepted(dual) != dual.accepted) _fail("twai: accepted count wrong", ids);
+                if (count <= 2 && dual.unwanted != 0) _fail("twai: two ids or fewer not exact", ids);
+                if (count <= 10 && __builtin_popcount(varying) <= 5 && rep < 2 &&
+                    _bruteForceAccepted(ids, 1, 1) != dual.accepted) {
+                    _fail("twai: not optimal", ids);
+                }
+            }
+        }
+        printf("self_check %-9s plans=%u mean_unwanted=%.1f plan_us_mean=%.1f plan_us_max=%.1f "
+               "twai_mean_unwanted=%.1f\n",
+               shape.name, (unsigned)plans, (double)unwanted / plans, totalUs / plans, worstUs,
+               (double)twaiUnwanted / plans);
+    }
+}
+
+// ── Recorded bus ──────────────────────────────────────────────────────────────
+
+struct IdCount { uint32_t id; uint64_t frames; };
+
+static int _replayLog(const char *path, int argc, char **argv) {
+    CanLogReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 2;
+    }
+    std::vector<IdCount> seen;
+    uint64_t total = 0, extended = 0;
+    CanLogFrame f;
+    while (reader.next(f)) {
+        total++;
+        if (f.frame.can_id & CAN_EFF_FLAG) { extended++; continue; }   // standard filters reject these
+        uint32_t id = f.frame.can_id & CAN_SFF_MASK;
+        auto it = std::find_if(seen.begin(), seen.end(), [&](const IdCount &c) { return c.id == id; });
+        if (it == seen.end()) seen.push_back({ id, 1 });
+        else                  it->frames++;
+    }
+
+    std::vector<uint32_t> wanted;
+    const char *source = "decoder";
+    if (argc > 0 && !strcmp(argv[0], "--top") && argc > 1) {
+        size_t n = (size_t)atoi(argv[1]);
+        std::sort(seen.begin(), seen.end(),
+                  [](const IdCount &a, const IdCount &b) { return a.frames > b.frames; });
+        for (size_t i = 0; i < n && i < seen.size(); i++) wanted.push_back(seen[i].id);
+        source = "busiest";
+    } else if (argc > 0) {
+        for (int i = 0; i < argc; i++) wanted.push_back((uint32_t)strtoul(argv[i], nullptr, 16));
+        source = "command line";
+    } else {
+        for (const CanMessage &m : kCanMessages) {
+            if (m.wanted) wanted.push_back(m.id);
+        }
+    }
+
+    CanFilterPlan plan;
+    const char *err = canFilterPlan(plan, wanted.data(), wanted.size());
+    if (err) {
+        fprintf(stderr, "no plan: %s\n", err);
+        return 2;
+    }
+
+    uint64_t wantedFrames = 0, admitted = 0;
+    uint32_t foreignIds = 0;
+    for (const IdCount &c : seen) {
+        bool want = std::find(wanted.begin(), wanted.end(), c.id) != wanted.end();
+        if (want) wantedFrames += c.frames;
+        if (canFilterAccepts(plan, c.id)) {
+            admitted += c.frames;
+            if (!want) foreignIds++;
+        }
+        if (want && !canFilterAccepts(plan, c.id)) _fail("wanted id rejected on the bus", wanted);
+    }
+    uint64_t standard = total - extended;
+
+    printf("log %s: frames=%llu standard=%llu distinct_ids=%zu\n", path,
+           (unsigned long long)total, (unsigned long long)standard, seen.size());
+    printf("wanted (%s): %zu ids, %llu frames\n", source, wanted.size(),
+           (unsigned long long)wantedFrames);
+    printf("plan: MASK0=%03X RXF0-1=%03X %03X  MASK1=%03X RXF2-5=%03X %03X %03X %03X\n",
+           plan.mask[0], plan.filter[0], plan.filter[1], plan.mask[1],
+           plan.filter[2], plan.filter[3], plan.filter[4], plan.filter[5]);
+    printf("plan admits %u ids, %u unwanted (%u of them on this bus)\n",
+           (unsigned)plan.accepted, (unsigned)plan.unwanted, (unsigned)foreignIds);
+    printf("admitted_frames=%llu unwanted_frames=%llu over_acceptance=%.2f%% "
+           "(accept-all: %.2f%%)\n",
+           (unsigned long long)admitted, (unsigned long long)(admitted - wantedFrames),
+           admitted ? 100.0 * (admitted - wantedFrames) / admitted : 0.0,
+           standard ? 100.0 * (standard - wantedFrames) / standard : 0.0);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    printf("bench_can_filter: up to %d ids per plan\n", CAN_FILTER_MAX_IDS);
+    _selfCheck();
+    int rc = argc > 1 ? _replayLog(argv[1], argc - 2, argv + 2) : 0;
+    printf("%s\n", s_failures == 0 ? "PASS" : "FAIL");
+    return rc ? rc : s_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+/**
+ * sim/bench_mcp2515_rx.cpp
+ * The MCP2515 receive path in SPI transactions and bytes: the driver
+ * library's readMessage() sequence against the burst path (mcp2515_rx.h),
+ * each reading the same traffic off its own register model
+ * (sim/mcp2515_model.h) with the decoder's acceptance filters.
+ *
+ * Traffic is a candump/ASC log (sim/can_log.h) or, without one, a synthetic
+ * bus: the decoder's ids, other standard ids, extended and remote frames.
+ * After one or two frames at random, a controller with INT asserted is
+ * emptied, so both receive buffers and rollover are exercised.  A buffer
+ * that is still full when a frame for it arrives overflows, as on the chip;
+ * the overflow and ERRIF flags that then hold INT are cleared after the
+ * read, as the firmware's error poll does, at the same cost for both paths.
+ *
+ * Both paths must deliver the same frames in the same order (id, flags,
+ * DLC and data).  Reported per frame: SPI transactions, bytes, and the time
+ * those bytes take at CAN_SPI_CLOCK – what the CAN task spends on the bus,
+ * not counting the per-transaction CS and driver overhead.
+ *
+ * Usage:  bench_mcp2515_rx [<log> | <frames>]     (default 200000 frames)
+ * Exit status is non-zero if the paths disagree.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "config.h"
+#include "can_log.h"
+#include "mcp2515_model.h"
+#include "../roundie/mcp2515_rx.h"
+#include "../roundie/can_signals.h"
+
+// ── Driver library path ───────────────────────────────────────────────────────
+// MCP2515::readMessage() as the autowp library does it, transaction for
+// transaction: READ STATUS, then for the first full buffer its five header
+// registers, RXBnCTRL, the data registers and a BIT MODIFY of CANINTF.
+
+static void _libRead(Mcp2515Model &chip, uint8_t a, uint8_t *out, size_t count) {
+    uint8_t tx[16] = { MCP_READ, a }, rx[16];
+    chip.transfer(tx, rx, count + 2);
+    memcpy(out, rx + 2, count);
+}
+
+/** @return false when neither buffer holds a frame (ERROR_NOMSG) */
+static bool _libReadMessage(Mcp2515Model &chip, struct can_frame &f) {
+    const uint8_t statusTx[2] = { MCP_READ_STATUS, 0 };
+    uint8_t statusRx[2];
+    chip.transfer(statusTx, statusRx, 2);
+    uint8_t status = statusRx[1];
+    uint8_t buffer;
+    if      (status & MCP_CANINTF_RX0IF) buffer = 0;
+    else if (status & MCP_CANINTF_RX1IF) buffer = 1;
+    else return false;
+
+    uint8_t base = buffer ? MCP_RXB1CTRL : MCP_RXB0CTRL;
+    uint8_t h[5], ctrl;
+    _libRead(chip, base + 1, h, 5);
+    uint32_t id = ((uint32_t)h[0] << 3) + (h[1] >> 5);
+    if (h[1] & 0x08) {
+        id = (id << 2) + (h[1] & 0x03);
+        id = (id << 8) + h[2];
+        id = (id << 8) + h[3];
+        id |= CAN_EFF_FLAG;
+    }
+    uint8_t dlc = h[4] & 0x0F;
+    _libRead(chip, base, &ctrl, 1);
+    if (ctrl & 0x08) id |= CAN_RTR_FLAG;
+    f.can_id  = id;
+    f.can_dlc = dlc;
+    _libRead(chip, base + 6, f.data, dlc);
+
+    const uint8_t clearTx[4] = { MCP_BITMOD, MCP_CANINTF,
+                                 (uint8_t)(buffer ? MCP_CANINTF_RX1IF : MCP_CANINTF_RX0IF), 0 };
+    uint8_t clearRx[4];
+    chip.transfer(clearTx, clearRx, 4);
+    return true;
+}
+
+// ── Burst path ────────────────────────────────────────────────────────────────
+
+static Mcp2515Model s_burstChip;
+
+static void _burstSpi(const uint8_t *tx, uint8_t *rx, size_t n, void *ctx) {
+    (void)ctx;
+    s_burstChip.transfer(tx, rx, n);
+}
+
+/** Overflow flags and ERRIF, once a read has left INT asserted with both buffers empty. */
+static void _clearErrors(Mcp2515Model &chip) {
+    if (!chip.interrupt()) return;
+    const uint8_t eflgTx[4] = { MCP_BITMOD, MCP_EFLG, MCP_EFLG_RX0OVR | MCP_EFLG_RX1OVR, 0 };
+    const uint8_t intfTx[4] = { MCP_BITMOD, MCP_CANINTF, MCP_CANINTF_ERRIF | MCP_CANINTF_MERRF, 0 };
+    uint8_t rx[4];
+    chip.transfer(eflgTx, rx, 4);
+    chip.transfer(intfTx, rx, 4);
+}
+
+// ── Traffic ───────────────────────────────────────────────────────────────────
+
+static std::vector<struct can_frame> _synthetic(size_t count) {
+    std::mt19937 rng(7);
+    std::vector<struct can_frame> frames(count);
+    const size_t nDecoder = sizeof(kCanMessages) / sizeof(kCanMessages[0]);
+    for (struct can_frame &f : frames) {
+        uint32_t kind = rng() % 100;
+        if (kind < 70)      f.can_id = kCanMessages[rng() % nDecoder].id;
+        else if (kind < 92) f.can_id = rng() & CAN_SFF_MASK;
+        else if (kind < 98) f.can_id = (rng() & CAN_EFF_MASK) | CAN_EFF_FLAG;
+        else                f.can_id = (rng() & CAN_SFF_MASK) | CAN_RTR_FLAG;
+        f.can_dlc = (uint8_t)(rng() % 9);
+        for (uint8_t &b : f.data) b = (uint8_t)rng();
+    }
+    return frames;
+}
+
+static bool _sameFrame(const struct can_frame &a, const struct can_frame &b) {
+    return a.can_id == b.can_id && a.can_dlc == b.can_dlc &&
+           memcmp(a.data, b.data, a.can_dlc) == 0;
+}
+
+static void _report(const char *name, uint64_t frames, uint64_t transactions, uint64_t bytes) {
+    double n = frames ? (double)frames : 1.0;
+    printf("%-7s frames=%llu transactions/frame=%.2f bytes/frame=%.1f spi_us/frame=%.2f\n",
+           name, (unsigned long long)frames, transactions / n, bytes / n,
+           bytes * 8.0 * 1e6 / CAN_SPI_CLOCK / n);
+}
+
+int main(int argc, char **argv) {
+    std::vector<struct can_frame> bus;
+    const char *source = "synthetic";
+    if (argc > 1 && atol(argv[1]) <= 0) {
+        CanLogReader reader;
+        if (!reader.open(argv[1])) {
+            fprintf(stderr, "cannot open %s\n", argv[1]);
+            return 2;
+        }
+        CanLogFrame f;
+        while (reader.next(f)) bus.push_back(f.frame);
+        source = argv[1];
+    } else {
+        bus = _synthetic(argc > 1 ? (size_t)atol(argv[1]) : 200000);
+    }
+
+    // The decoder's filters, as canDecoderFilterPlan() makes them
+    std::vector<uint32_t> ids;
+    for (const CanMessage &m : kCanMessages) {
+        if (m.wanted) ids.push_back(m.id);
+    }
+    CanFilterPlan plan;
+    const char *err = canFilterPlan(plan, ids.data(), ids.size());
+    Mcp2515Model libChip;
+    mcp2515ModelBringUp(libChip, err ? nullptr : &plan);
+    mcp2515ModelBringUp(s_burstChip, err ? nullptr : &plan);
+    Mcp2515Rx rx = { _burstSpi, nullptr, {} };
+
+    printf("bench_mcp2515_rx: %s, %zu frames on the bus, SPI at %.1f MHz\n",
+           source, bus.size(), CAN_SPI_CLOCK / 1e6);
+
+    std::mt19937 rng(3);
+    uint64_t libFrames = 0, burstFrames = 0, mismatches = 0;
+    std::vector<struct can_frame> libOut, burstOut;
+    size_t i = 0;
+    while (i < bus.size()) {
+        // One or two frames arrive before the controller is serviced
+        size_t arrive = 1 + rng() % 2;
+        for (size_t k = 0; k < arrive && i < bus.size(); k++, i++) {
+            libChip.receive(bus[i]);
+            s_burstChip.receive(bus[i]);
+        }
+
+        libOut.clear();
+        burstOut.clear();
+        struct can_frame f;
+        if (libChip.interrupt()) {
+            while (_libReadMessage(libChip, f)) libOut.push_back(f);
+            _clearErrors(libChip);
+        }
+        struct can_frame frames[2];
+        if (s_burstChip.interrupt()) {
+            while (uint8_t n = mcp2515ReadFrames(rx, frames)) {
+                burstOut.insert(burstOut.end(), frames, frames + n);
+            }
+            _clearErrors(s_burstChip);
+        }
+        libFrames   += libOut.size();
+        burstFrames += burstOut.size();
+
+        bool same = libOut.size() == burstOut.size();
+        for (size_t k = 0; same && k < libOut.size(); k++) same = _sameFrame(libOut[k], burstOut[k]);
+        if (!same && mismatches++ < 10) {
+            printf("MISMATCH after bus frame %zu: library read %zu frames, burst %zu\n",
+                   i, libOut.size(), burstOut.size());
+        }
+    }
+
+    printf("filters: %s, admitted %llu of %zu frames, overflowed %llu\n",
+           err ? err : "decoder plan", (unsigned long long)libFrames, bus.size(),
+           (unsigned long long)libChip.overflows());
+    _report("library", libFrames, libChip.transactions(), libChip.bytes());
+    _report("burst", burstFrames, s_burstChip.transactions(), s_burstChip.bytes());
+    printf("%s\n", mismatches == 0 ? "PASS" : "FAIL");
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+/**
+ * sim/bench_readout.cpp
+ * Microbenchmark: the multi-arc screen's center boost readout drawn three
+ * ways, on a headless LVGL display with a pixel-counting flush:
+ *
+ *   label_printf  lv_label_set_text() of snprintf("%.1f") on every update –
+ *                 the original readout
+ *   label_cached  UiLabel (ui_update.h): integer formatting, skipped when
+ *                 the shown tenth is unchanged, lv_label_set_text_static()
+ *   digit_atlas   DigitReadout (digit_readout.h): glyph indices by integer
+ *                 division, only changed cells invalidated, cells copied
+ *                 from the pre-rasterized 44×72 digit atlas
+ *
+ * Every path gets the same stream of boost values (tenths of a kPa, a slow
+ * sweep plus sensor noise), one value per 33 ms frame.  One JSON line per
+ * path reports
+ *   set_ns               time in the update call (formatting + invalidation)
+ *   render_us_mean/max   lv_timer_handler() time per frame
+ *   px_per_update        pixels flushed per update
+ *   heap_delta           LVGL heap in use after the run minus before
+ * The label uses the 16 px font the screen had, the atlas digits are
+ * 72 px tall, so the pixel counts compare cost per update, not per glyph.
+ *
+ * Before timing, digitReadoutSet() is checked against snprintf for a range
+ * of values; the exit status is non-zero on any mismatch.
+ *
+ * Usage:  bench_readout [updates]
+ */
+
+#include <lvgl.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "config.h"
+#include "../roundie/ui_update.h"
+#include "../roundie/digit_readout.h"
+
+#define BENCH_BUF_LINES  40
+#define BENCH_FRAME_MS   33
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t s_flushPx = 0;
+static uint16_t s_drawBuf[DISPLAY_WIDTH * BENCH_BUF_LINES];
+
+static void _benchFlush(lv_display_t *disp, const lv_area_t *area, uint8_t *px) {
+    (void)px;
+    s_flushPx += lv_area_get_size(area);
+    lv_display_flush_ready(disp);
+}
+
+static size_t _heapUsed(void) {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+/** Boost in tenths of a kPa for update i: 100–250 kPa sweep plus noise. */
+static int32_t _boostTenths(uint32_t i) {
+    static uint32_t rng = 12345;
+    rng = rng * 1664525u + 1013904223u;
+    float sweep = 1750.0f + 750.0f * sinf((float)i * 0.01f);
+    return (int32_t)lroundf(sweep) + (int32_t)(rng >> 29) - 4;
+}
+
+// ── Correctness ───────────────────────────────────────────────────────────────
+
+/** Text a readout of cells cells with one decimal shows for value. */
+static void _readoutText(const DigitReadout &r, char *out) {
+    size_t n = 0;
+    for (int c = 0; c < r.cells; c++) {
+        if (c == r.cells - r.decimals) out[n++] = '.';
+        uint8_t g = r.glyph[c];
+        if (g != DIGIT_BLANK) out[n++] = g == DIGIT_GLYPH_MINUS ? '-' : (char)('0' + g);
+    }
+    out[n] = '\0';
+}
+
+static int _checkReadout(DigitReadout &r) {
+    int bad = 0;
+    for (int32_t v = -999; v <= 9999; v += 7) {
+        digitReadoutSet(r, v);
+        char want[16], got[16];
+        snprintf(want, sizeof(want), "%s%ld.%ld", v < 0 ? "-" : "",
+                 (long)(labs(v) / 10), (long)(labs(v) % 10));
+        _readoutText(r, got);
+        if (strcmp(want, got) != 0) {
+            if (bad++ < 5) fprintf(stderr, "readout %ld: want %s, got %s\n", (long)v, want, got);
+        }
+    }
+    digitReadoutSet(r, 10000);                             // does not fit in 4 cells
+    for (int c = 0; c < r.cells; c++) bad += r.glyph[c] != DIGIT_GLYPH_MINUS;
+    return bad;
+}
+
+// ── Bench ─────────────────────────────────────────────────────────────────────
+
+enum BenchPath { PATH_LABEL_PRINTF, PATH_LABEL_CACHED, PATH_DIGIT_ATLAS };
+
+static void _runPath(BenchPath path, const DigitAtlas &atlas, uint32_t updates) {
+    static const char *const kNames[] = { "label_printf", "label_cached", "digit_atlas" };
+    lv_obj_t *scr = lv_obj_create(nullptr);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    lv_screen_load(scr);
+
+    lv_obj_t    *label = nullptr;
+    UiLabel      cached;
+    DigitReadout readout;
+    char         text[16];
+    if (path == PATH_DIGIT_ATLAS) {
+        lv_obj_t *o = digitReadoutCreate(readout, scr, atlas, 4, 1);
+        lv_obj_align(o, LV_ALIGN_CENTER, 0, -24);
+        lv_obj_update_layout(o);
+    } else {
+        label = lv_label_create(scr);
+        lv_obj_set_style_text_color(label, lv_color_white(), 0);
+        lv_obj_set_style_text_font(label, &lv_font_unscii_16, 0);
+        lv_obj_align(label, LV_ALIGN_CENTER, 0, -14);
+        uiLabelInit(cached, label);
+    }
+    lv_tick_inc(BENCH_FRAME_MS);
+    lv_timer_handler();                                    // first full frame, not counted
+
+    size_t   heap0 = _heapUsed();
+    uint64_t px0   = s_flushPx;
+    double   setNs = 0.0, renderUs = 0.0, renderMax = 0.0;
+    for (uint32_t i = 0; i < updates; i++) {
+        int32_t tenths = _boostTenths(i);
+        Clock::time_point t0 = Clock::now();
+        switch (path) {
+            case PATH_LABEL_PRINTF:
+                snprintf(text, sizeof(text), "%.1f", tenths / 10.0f);
+                lv_label_set_text(label, text);
+                break;
+            case PATH_LABEL_CACHED:
+                uiLabelSetTenths(cached, tenths / 10.0f);
+                break;
+            case PATH_DIGIT_ATLAS:
+                digitReadoutSet(readout, tenths);
+                break;
+        }
+        Clock::time_point t1 = Clock::now();
+        lv_tick_inc(BENCH_FRAME_MS);
+        lv_timer_handler();
+        Clock::time_point t2 = Clock::now();
+
+        setNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+        double us = std::chrono::duration<double, std::micro>(t2 - t1).count();
+        renderUs += us;
+        if (us > renderMax) renderMax = us;
+    }
+    printf("{\"path\":\"%s\",\"updates\":%u,\"set_ns\":%.1f,\"render_us_mean\":%.1f,"
+           "\"render_us_max\":%.1f,\"px_per_update\":%.0f,\"heap_delta\":%ld}\n",
+           kNames[path], (unsigned)updates, setNs / updates, renderUs / updates, renderMax,
+           (double)(s_flushPx - px0) / updates, (long)_heapUsed() - (long)heap0);
+
+    lv_obj_t *blank = lv_obj_create(nullptr);
+    lv_screen_load(blank);
+    lv_obj_delete(scr);
+}
+
+int main(int argc, char **argv) {
+    uint32_t updates = argc > 1 ? (uint32_t)atoi(argv[1]) : 3000;
+    if (updates == 0) updates = 3000;
+
+    lv_init();
+    lv_display_t *disp = lv_display_create(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    lv_display_set_flush_cb(disp, _benchFlush);
+    lv_display_set_buffers(disp, s_drawBuf, nullptr, sizeof(s_drawBuf),
+                           LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+    DigitAtlas atlas;
+    Clock::time_point t0 = Clock::now();
+    if (!digitAtlasCreate(atlas, lv_screen_active(), 44, 72, 9, lv_color_white(), lv_color_black())) {
+        fprintf(stderr, "bench_readout: no memory for the digit atlas\n");
+        return 1;
+    }
+    double atlasUs = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+    fprintf(stderr, "bench_readout: atlas of %d glyphs rasterized in %.0f us\n",
+            DIGIT_GLYPHS, atlasUs);
+
+    DigitReadout check;
+    digitReadoutCreate(check, lv_screen_active(), atlas, 4, 1);
+    int bad = _checkReadout(check);
+    lv_obj_delete(check.obj);
+    if (bad) {
+        fprintf(stderr, "bench_readout: %d readout mismatches\n", bad);
+        return 1;
+    }
+
+    _runPath(PATH_LABEL_PRINTF, atlas, updates);
+    _runPath(PATH_LABEL_CACHED, atlas, updates);
+    _runPath(PATH_DIGIT_ATLAS,  atlas, updates);
+    return 0;
+}
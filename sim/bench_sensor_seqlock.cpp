@@ -0,0 +1,104 @@
+/**
+ * sim/bench_sensor_seqlock.cpp
+ * Threaded stress run for sensor publication (roundie/seqlock.h).
+ *
+ * One writer thread stands in for the CAN decoder and publishes
+ * SensorRecords back to back through g_sensors.  Every channel of record v
+ * holds a value derived from v, so a record mixing two publications is
+ * detectable.  Several reader threads (UI, logger, alerts) read snapshots as
+ * fast as they can and check each one for tearing and for the version ever
+ * going backwards.
+ *
+ * Usage:  bench_sensor_seqlock [seconds] [readers]
+ * Exit status is non-zero on any torn or out-of-order read.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "config.h"
+#include "../roundie/can_handler.h"
+
+SensorRecord          g_sensorWork = SENSOR_RECORD_INIT;
+SeqLock<SensorRecord> g_sensors(g_sensorWork);
+
+static std::atomic<bool> s_stop{false};
+
+struct ReaderStats {
+    uint64_t reads     = 0;
+    uint64_t retries   = 0;
+    uint64_t torn      = 0;
+    uint64_t backwards = 0;
+};
+
+// Channel i of version v holds v * (i + 1), truncated to stay exact in float
+static float _expected(uint32_t version, int ch) {
+    return (float)((version & 0xFFFF) * (uint32_t)(ch + 1));
+}
+
+static void _writer(void) {
+    while (!s_stop.load(std::memory_order_relaxed)) {
+        uint32_t v = g_sensorWork.version + 1;
+        for (int i = 0; i < SENSOR_CHANNEL_COUNT; i++) {
+            g_sensorWork.ch[i] = _expected(v, i);
+        }
+        publishSensors(micros());
+    }
+}
+
+static void _reader(ReaderStats *st) {
+    uint32_t lastVersion = 0;
+    while (!s_stop.load(std::memory_order_relaxed)) {
+        uint32_t retries = 0;
+        SensorRecord r = g_sensors.read(&retries);
+        st->reads++;
+        st->retries += retries;
+        if (r.version < lastVersion) st->backwards++;
+        lastVersion = r.version;
+        if (r.version == 0) continue;   // initial defaults
+        for (int i = 0; i < SENSOR_CHANNEL_COUNT; i++) {
+            if (r.ch[i] != _expected(r.version, i)) { st->torn++; break; }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+    int    readers = argc > 2 ? atoi(argv[2]) : 3;
+    if (readers < 1) readers = 1;
+
+    printf("bench_sensor_seqlock: %.1f s, 1 writer, %d readers, record=%zu bytes\n",
+           seconds, readers, sizeof(SensorRecord));
+
+    std::vector<ReaderStats> stats(readers);
+    std::vector<std::thread> threads;
+    threads.emplace_back(_writer);
+    for (int i = 0; i < readers; i++) threads.emplace_back(_reader, &stats[i]);
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    s_stop.store(true);
+    for (std::thread &t : threads) t.join();
+
+    ReaderStats total;
+    for (const ReaderStats &s : stats) {
+        total.reads     += s.reads;
+        total.retries   += s.retries;
+        total.torn      += s.torn;
+        total.backwards += s.backwards;
+    }
+    uint32_t writes = g_sensors.writeCount();
+    bool ok = total.torn == 0 && total.backwards == 0;
+
+    printf("writes=%u (%.2f M/s) reads=%llu (%.2f M/s)\n",
+           (unsigned)writes, writes / seconds / 1e6,
+           (unsigned long long)total.reads, total.reads / seconds / 1e6);
+    printf("retries_per_read=%.4f torn=%llu backwards=%llu\n",
+           total.reads ? (double)total.retries / total.reads : 0.0,
+           (unsigned long long)total.torn, (unsigned long long)total.backwards);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+/**
+ * sim/can.h
+ * Minimal stand-in for the can.h shipped with the autowp mcp2515 library.
+ *
+ * Only struct can_frame and the id flag constants are needed by the shared
+ * headers (can_queue.h, can_handler.h); the SPI driver itself is not built
+ * on the simulator – the receive path (mcp2515_rx.h) talks to the register
+ * model in sim/mcp2515_model.h instead.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t canid_t;
+
+#define CAN_EFF_FLAG 0x80000000UL   // extended frame format (29-bit id)
+#define CAN_RTR_FLAG 0x40000000UL   // remote transmission request
+#define CAN_ERR_FLAG 0x20000000UL   // error message frame
+
+#define CAN_SFF_MASK 0x000007FFUL   // standard frame format (11-bit id)
+#define CAN_EFF_MASK 0x1FFFFFFFUL   // extended frame format (29-bit id)
+
+#define CAN_MAX_DLEN 8
+
+struct can_frame {
+    canid_t can_id;   // 32-bit id + EFF/RTR/ERR flags
+    uint8_t can_dlc;  // payload length in bytes (0 .. CAN_MAX_DLEN)
+    alignas(8) uint8_t data[CAN_MAX_DLEN];
+};
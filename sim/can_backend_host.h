@@ -0,0 +1,157 @@
+/**
+ * sim/can_backend_host.h
+ * Host versions of the CAN backends (roundie/can_backend.h) over models of
+ * the hardware, with the members the CAN task uses plus two for the host:
+ * busFrame() puts a frame on the bus, pending() is what wakes the task –
+ * for the MCP2515 an INT falling edge, as its FALLING ISR sees them.
+ *
+ *   CanHostMcp2515   the MCP2515 register model (mcp2515_model.h), set up
+ *                    with the decoder's filters as the driver library does
+ *                    and read through the burst path (mcp2515_rx.h)
+ *   CanHostTwai      the TWAI model (twai_model.h) with the dual filters
+ *                    can_twai.h installs, read off the driver's queue
+ *
+ * There is no wait(): the simulator's CAN thread paces itself on the
+ * replay.  CanBackend is the one CAN_BACKEND selects; the benches use both.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <atomic>
+
+#include "config.h"
+#include "mcp2515_model.h"
+#include "twai_model.h"
+#include "../roundie/can_handler.h"
+#include "../roundie/can_health.h"
+#include "../roundie/mcp2515_rx.h"
+
+class CanHostMcp2515 {
+public:
+    const char *name(void) const { return "mcp2515"; }
+
+    void begin(void) {
+        CanFilterPlan plan;
+        mcp2515ModelBringUp(m_chip, canDecoderFilterPlan(plan) ? nullptr : &plan);
+    }
+
+    void     busFrame(const struct can_frame &f) { m_chip.receive(f); }
+    uint32_t takeIrqUs(void) { return 0; }
+
+    /** An INT falling edge since the last call. */
+    bool pending(void) {
+        uint64_t edges = m_chip.edges();
+        if (edges == m_edges) return false;
+        m_edges = edges;
+        return true;
+    }
+
+    /** As can_mcp2515.h: an INT still asserted with both buffers empty is an error flag. */
+    uint8_t read(struct can_frame out[2]) {
+        uint8_t n = mcp2515ReadFrames(m_rx, out);
+        if (n == 0 && m_chip.interrupt()) m_errorPending = true;
+        return n;
+    }
+
+    /**
+     * EFLG into can_health.h, clearing the overflow flags, ERRIF and MERRF
+     * as can_mcp2515.h has the library do.
+     */
+    void pollErrors(void) {
+        uint32_t now = millis();
+        if (now - m_lastPollMs < CAN_HEALTH_POLL_MS && !m_errorPending) return;
+        m_lastPollMs   = now;
+        m_errorPending = false;
+        uint8_t eflg = m_chip.reg(MCP_EFLG);
+        if (eflg & (MCP_EFLG_RX0OVR | MCP_EFLG_RX1OVR)) _bitModify(MCP_EFLG, MCP_EFLG_RX0OVR | MCP_EFLG_RX1OVR);
+        uint8_t intf = m_chip.reg(MCP_CANINTF);
+        if (intf & MCP_CANINTF_ERRIF) _bitModify(MCP_CANINTF, MCP_CANINTF_ERRIF);
+        if (intf & MCP_CANINTF_MERRF) _bitModify(MCP_CANINTF, MCP_CANINTF_MERRF);
+        canHealthController(eflg, 0, 0);
+    }
+
+    char *format(char *buf, size_t size) {
+        return mcp2515RxFormat(mcp2515RxReport(m_rx), buf, size);
+    }
+
+    const Mcp2515Model &chip(void) const { return m_chip; }
+
+private:
+    Mcp2515Model m_chip;
+    Mcp2515Rx    m_rx = { _spi, this, {} };
+    uint64_t     m_edges = 0;
+    uint32_t     m_lastPollMs = 0;
+    bool         m_errorPending = false;
+
+    /** Clear bits in register a with one BIT MODIFY. */
+    void _bitModify(uint8_t a, uint8_t bits) {
+        const uint8_t tx[4] = { MCP_BITMOD, a, bits, 0 };
+        uint8_t rx[4];
+        m_chip.transfer(tx, rx, sizeof(tx));
+    }
+
+    static void _spi(const uint8_t *tx, uint8_t *rx, size_t n, void *ctx) {
+        ((CanHostMcp2515 *)ctx)->m_chip.transfer(tx, rx, n);
+    }
+};
+
+class CanHostTwai {
+public:
+    const char *name(void) const { return "twai"; }
+
+    void begin(void) {
+        CanFilterPlan plan;
+        if (canDecoderFilterPlanBanks(plan, 1, 1)) return;   // accept everything
+        uint32_t code, mask;
+        canFilterTwaiDual(plan, code, mask);
+        m_twai.configure(code, mask, false);
+    }
+
+    void     busFrame(const struct can_frame &f) { m_twai.receive(f); }
+    bool     pending(void) const { return m_twai.queued() > 0; }
+    uint32_t takeIrqUs(void) { return 0; }
+
+    uint8_t read(struct can_frame out[2]) {
+        uint32_t queued = m_twai.queued();
+        if (queued > m_peak.load(std::memory_order_relaxed)) {
+            m_peak.store(queued, std::memory_order_relaxed);
+        }
+        uint8_t n = 0;
+        while (n < 2 && m_twai.read(out[n])) n++;
+        m_frames.fetch_add(n, std::memory_order_relaxed);
+        return n;
+    }
+
+    /** Frames missed on a full driver queue as RX0OVR, as can_twai.h reports them. */
+    void pollErrors(void) {
+        uint32_t now = millis();
+        if (now - m_lastPollMs < CAN_HEALTH_POLL_MS) return;
+        m_lastPollMs = now;
+        uint8_t eflg = m_twai.missed() != m_lastMissed ? CAN_EFLG_RX0OVR : 0;
+        m_lastMissed = m_twai.missed();
+        canHealthController(eflg, 0, 0);
+    }
+
+    /** As can_twai.h, with the queue's peak taken at each read. */
+    char *format(char *buf, size_t size) {
+        snprintf(buf, size, "%lu frames, driver queue peak %lu/%u, no SPI",
+                 (unsigned long)m_frames.exchange(0), (unsigned long)m_peak.exchange(0),
+                 (unsigned)CAN_TWAI_RX_QUEUE_LEN);
+        return buf;
+    }
+
+    const TwaiModel &twai(void) const { return m_twai; }
+
+private:
+    TwaiModel m_twai;
+    uint32_t  m_lastPollMs = 0, m_lastMissed = 0;
+    // Counted by the CAN thread, reset by format() on the UI thread
+    std::atomic<uint32_t> m_frames{0}, m_peak{0};
+};
+
+#if CAN_BACKEND == CAN_BACKEND_TWAI
+typedef CanHostTwai CanBackend;
+#else
+typedef CanHostMcp2515 CanBackend;
+#endif
@@ -0,0 +1,331 @@
+/**
+ * sim/can_log.h
+ * Streaming reader and real-time replay of recorded CAN traffic.
+ *
+ * Supported formats (detected from the first meaningful line):
+ *   candump -l    (1436509052.249713) can0 3D0#0011223344556677
+ *   Vector ASC       0.012345 1  3D0             Rx   d 8 00 11 22 33 44 55 66 77
+ *
+ * The file is read one line at a time through a fixed stdio buffer, so a
+ * multi-hour log never needs more memory than one line.  CAN FD, error and
+ * event lines are skipped; extended ids get CAN_EFF_FLAG and remote frames
+ * CAN_RTR_FLAG, as in SocketCAN.
+ *
+ * CanLogReplay paces a reader against a clock: frames are released when
+ * (frame time − first frame time) / speed has elapsed, so speed 1 honours the
+ * original timing, speed N runs N× faster, and speed 0 means as fast as the
+ * sink accepts them.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <can.h>
+
+/** Monotonic 64-bit µs clock for pacing (micros() wraps after ~71 minutes). */
+inline uint64_t canLogClockUs(void) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** One frame read from a log, with its recorded timestamp. */
+struct CanLogFrame {
+    uint64_t         tsUs;    // log timestamp in µs (absolute or from log start)
+    struct can_frame frame;
+};
+
+class CanLogReader {
+public:
+    enum Format { FORMAT_UNKNOWN, FORMAT_CANDUMP, FORMAT_ASC };
+
+    CanLogReader() = default;
+    ~CanLogReader() { close(); }
+    CanLogReader(const CanLogReader &) = delete;
+    CanLogReader &operator=(const CanLogReader &) = delete;
+
+    bool open(const char *path) {
+        close();
+        m_file = fopen(path, "rb");
+        if (!m_file) return false;
+        setvbuf(m_file, m_ioBuf, _IOFBF, sizeof(m_ioBuf));
+        return true;
+    }
+
+    void close(void) {
+        if (m_file) fclose(m_file);
+        m_file    = nullptr;
+        m_format  = FORMAT_UNKNOWN;
+        m_ascHex  = true;
+        m_ascRel  = false;
+        m_ascLastUs = 0;
+        m_lineNo  = 0;
+        m_skipped = 0;
+    }
+
+    /** Start again from the first line (for looping playback). */
+    bool rewind(void) {
+        if (!m_file) return false;
+        ::rewind(m_file);
+        m_ascLastUs = 0;
+        return true;
+    }
+
+    /**
+     * Read the next data frame.
+     * @return false at end of file (or if no file is open)
+     */
+    bool next(CanLogFrame &out) {
+        if (!m_file) return false;
+        char line[256];
+        while (fgets(line, sizeof(line), m_file)) {
+            m_lineNo++;
+            // Over-long line: drain the remainder, it is not a classic frame
+            if (!strchr(line, '\n') && !feof(m_file)) {
+                int c;
+                while ((c = fgetc(m_file)) != EOF && c != '\n') {}
+                m_skipped++;
+                continue;
+            }
+            if (m_format == FORMAT_UNKNOWN) _detect(line);
+            bool ok = false;
+            if (m_format == FORMAT_CANDUMP)  ok = _parseCandump(line, out);
+            else if (m_format == FORMAT_ASC) ok = _parseAsc(line, out);
+            if (ok) return true;
+            if (!_isBlank(line)) m_skipped++;
+        }
+        return false;
+    }
+
+    Format   format()  const { return m_format; }
+    /** Lines read so far, across rewinds. */
+    uint32_t lineNo()  const { return m_lineNo; }
+    /** Non-blank lines that were not classic CAN data frames. */
+    uint32_t skipped() const { return m_skipped; }
+
+private:
+    static bool _isBlank(const char *s) {
+        while (*s && isspace((unsigned char)*s)) s++;
+        return *s == '\0';
+    }
+
+    static int _hexNibble(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    /** Seconds with up to 6 decimals ("123.456789") → µs, without float rounding. */
+    static bool _parseSeconds(const char *&p, uint64_t &us) {
+        char *end;
+        unsigned long long sec = strtoull(p, &end, 10);
+        if (end == p) return false;
+        uint64_t frac = 0;
+        int digits = 0;
+        if (*end == '.') {
+            end++;
+            while (isdigit((unsigned char)*end)) {
+                if (digits < 6) { frac = frac * 10 + (uint64_t)(*end - '0'); digits++; }
+                end++;
+            }
+        }
+        while (digits++ < 6) frac *= 10;
+        us = (uint64_t)sec * 1000000ull + frac;
+        p = end;
+        return true;
+    }
+
+    void _detect(const char *line) {
+        const char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '(') { m_format = FORMAT_CANDUMP; return; }
+        if (isdigit((unsigned char)*p) ||
+            !strncmp(p, "date", 4) || !strncmp(p, "base", 4) ||
+            !strncmp(p, "Begin", 5) || !strncmp(p, "internal", 8) ||
+            !strncmp(p, "no internal", 11)) {
+            m_format = FORMAT_ASC;
+        }
+    }
+
+    // (1436509052.249713) can0 3D0#0011223344556677
+    bool _parseCandump(const char *line, CanLogFrame &out) {
+        const char *p = strchr(line, '(');
+        if (!p) return false;
+        p++;
+        if (!_parseSeconds(p, out.tsUs) || *p != ')') return false;
+        p++;
+        while (isspace((unsigned char)*p)) p++;
+        while (*p && !isspace((unsigned char)*p)) p++;   // interface name
+        while (isspace((unsigned char)*p)) p++;
+
+        const char *hash = strchr(p, '#');
+        if (!hash) return false;
+        if (hash[1] == '#') return false;                 // CAN FD
+        size_t idLen = (size_t)(hash - p);
+        char *end;
+        unsigned long id = strtoul(p, &end, 16);
+        if (end != hash) return false;
+
+        memset(&out.frame, 0, sizeof(out.frame));
+        out.frame.can_id = (canid_t)id;
+        if (idLen > 3) out.frame.can_id |= CAN_EFF_FLAG;
+
+        const char *d = hash + 1;
+        if (*d == 'R' || *d == 'r') {
+            out.frame.can_id |= CAN_RTR_FLAG;
+            if (isdigit((unsigned char)d[1])) out.frame.can_dlc = (uint8_t)(d[1] - '0');
+            return true;
+        }
+        uint8_t n = 0;
+        for (;;) {
+            if (*d == '.') { d++; continue; }
+            int hi = _hexNibble(d[0]);
+            if (hi < 0) break;
+            int lo = _hexNibble(d[1]);
+            if (lo < 0 || n >= CAN_MAX_DLEN) return false;
+            out.frame.data[n++] = (uint8_t)(hi << 4 | lo);
+            d += 2;
+        }
+        out.frame.can_dlc = n;
+        return true;
+    }
+
+    //    0.012345 1  3D0             Rx   d 8 00 11 22 33 44 55 66 77
+    bool _parseAsc(const char *line, CanLogFrame &out) {
+        const char *p = line;
+        while (isspace((unsigned char)*p)) p++;
+        if (!strncmp(p, "base", 4)) {
+            m_ascHex = strstr(p, " hex") != nullptr;
+            m_ascRel = strstr(p, "relative") != nullptr;
+            return false;
+        }
+        uint64_t ts;
+        if (!_parseSeconds(p, ts)) return false;
+        if (m_ascRel) { m_ascLastUs += ts; ts = m_ascLastUs; }
+
+        char *end;
+        strtoul(p, &end, 10);                 // channel; "CANFD" etc. fail here
+        if (end == p) return false;
+        p = end;
+        while (isspace((unsigned char)*p)) p++;
+
+        unsigned long id = strtoul(p, &end, m_ascHex ? 16 : 10);
+        if (end == p) return false;           // ErrorFrame, statistics, ...
+        bool ext = (*end == 'x' || *end == 'X');
+        if (ext) end++;
+        if (!isspace((unsigned char)*end)) return false;
+        p = end;
+
+        while (isspace((unsigned char)*p)) p++;
+        if (strncmp(p, "Rx", 2) && strncmp(p, "Tx", 2)) return false;
+        p += 2;
+        while (isspace((unsigned char)*p)) p++;
+
+        memset(&out.frame, 0, sizeof(out.frame));
+        out.tsUs = ts;
+        out.frame.can_id = (canid_t)id | (ext ? CAN_EFF_FLAG : 0);
+
+        char kind = *p++;
+        unsigned long dlc = strtoul(p, &end, 16);
+        if (end == p || dlc > CAN_MAX_DLEN) return false;
+        p = end;
+        out.frame.can_dlc = (uint8_t)dlc;
+        if (kind == 'r' || kind == 'R') {
+            out.frame.can_id |= CAN_RTR_FLAG;
+            return true;
+        }
+        if (kind != 'd' && kind != 'D') return false;
+        for (unsigned long i = 0; i < dlc; i++) {
+            unsigned long b = strtoul(p, &end, 16);
+            if (end == p || b > 0xFF) return false;
+            out.frame.data[i] = (uint8_t)b;
+            p = end;
+        }
+        return true;
+    }
+
+    FILE    *m_file      = nullptr;
+    Format   m_format    = FORMAT_UNKNOWN;
+    bool     m_ascHex    = true;     // "base hex" (default) vs "base dec"
+    bool     m_ascRel    = false;    // "timestamps relative"
+    uint64_t m_ascLastUs = 0;
+    uint32_t m_lineNo    = 0;
+    uint32_t m_skipped   = 0;
+    char     m_ioBuf[64 * 1024];
+};
+
+/**
+ * Paced playback of a CanLogReader.
+ *
+ *   CanLogReplay rp(reader, 1.0);
+ *   rp.start(nowUs);
+ *   while (rp.pump(nowUs(), sink)) { sleep until rp.nextDueUs() }
+ *
+ * sink is any callable bool(const CanLogFrame &); returning false stops the
+ * current pump() call and retries the same frame next time (back-pressure
+ * for as-fast-as-possible playback).
+ */
+class CanLogReplay {
+public:
+    /** @param speed  1 = original timing, N = N× faster, 0 = as fast as possible */
+    CanLogReplay(CanLogReader &reader, double speed, bool loop = false)
+        : m_reader(reader), m_speed(speed), m_loop(loop) {}
+
+    void start(uint64_t nowUs) {
+        m_startUs = nowUs;
+        m_have = m_reader.next(m_pending);
+        if (m_have) m_logT0 = m_pending.tsUs;
+        m_loopOffsetUs = 0;
+    }
+
+    /**
+     * Deliver every frame that is due at nowUs.
+     * @return false once the log is exhausted (and not looping)
+     */
+    template <typename Sink>
+    bool pump(uint64_t nowUs, Sink &&sink) {
+        while (m_have) {
+            if (m_speed > 0.0 && nextDueUs() > nowUs) return true;
+            if (!sink(m_pending)) return true;
+            m_delivered++;
+            uint64_t lastTs = m_pending.tsUs;
+            m_have = m_reader.next(m_pending);
+            if (!m_have && m_loop && m_reader.rewind()) {
+                // Continue the timeline one frame period after the last frame
+                m_have = m_reader.next(m_pending);
+                if (m_have) m_loopOffsetUs += lastTs - m_logT0 + 1000;
+                m_loops++;
+            }
+        }
+        return false;
+    }
+
+    /** Clock time at which the pending frame is due. */
+    uint64_t nextDueUs(void) const {
+        if (!m_have || m_speed <= 0.0) return m_startUs;
+        uint64_t logOffset = m_pending.tsUs - m_logT0 + m_loopOffsetUs;
+        return m_startUs + (uint64_t)(logOffset / m_speed);
+    }
+
+    bool     done()      const { return !m_have; }
+    uint64_t delivered() const { return m_delivered; }
+    uint32_t loops()     const { return m_loops; }
+
+private:
+    CanLogReader &m_reader;
+    double        m_speed;
+    bool          m_loop;
+    CanLogFrame   m_pending = {};
+    bool          m_have    = false;
+    uint64_t      m_startUs = 0;
+    uint64_t      m_logT0   = 0;
+    uint64_t      m_loopOffsetUs = 0;
+    uint64_t      m_delivered = 0;
+    uint32_t      m_loops   = 0;
+};
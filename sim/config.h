@@ -13,10 +13,34 @@
 // ── Display ──────────────────────────────────────────────────────────────────
 #define DISPLAY_WIDTH   466
 #define DISPLAY_HEIGHT  466
+#define ROUND_VIEWPORT  1     // skip the invisible corners of the round panel (round_viewport.h)
+
+// ── Display rendering (render_strategy.h) ────────────────────────────────────
+#define RENDER_STRATEGY     1     // 0 partial/SRAM, 1 partial/PSRAM, 2 direct/PSRAM
+#define RENDER_BUF_LINES    46    // rows per partial draw buffer (466 / 10)
+#define RENDER_CALIBRATE    0     // 1 = time every strategy at boot, keep the fastest
+#define RENDER_CAL_FRAMES   8     // full redraws timed per screen and strategy
 
 // ── LVGL tick interval ───────────────────────────────────────────────────────
 #define LV_TICK_PERIOD_MS   5
 
+// ── UI thread (ui_runtime.h) ─────────────────────────────────────────────────
+#define UI_UPDATE_PERIOD_MS 100   // refresh of time-driven screens (clock)
+#define UI_ANIM_FRAME_MS    33    // screen refresh while a value is still moving
+
+// ── UI redraw statistics ─────────────────────────────────────────────────────
+#define UI_STATS_PERIOD_MS  5000  // invalidated-pixel rate report interval
+
+// ── Hot-path tracing (trace.h) ───────────────────────────────────────────────
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED       0     // 1 = record trace spans (or build with -DTRACE_ENABLED=1)
+#endif
+#define TRACE_RING_LEN      2048  // spans kept, oldest overwritten (power of two)
+#define TRACE_OVERLAY       0     // 1 = show the perf overlay from boot (trace_overlay.h)
+
+// ── Clock ────────────────────────────────────────────────────────────────────
+#define CLOCK_SWEEP_PERIOD_MS  33  // smooth second-hand step (0 = tick once per second)
+
 // ── Gesture / long-press timing ──────────────────────────────────────────────
 #define LONG_PRESS_MS       3000
 
@@ -24,14 +48,65 @@
 #define NVS_NAMESPACE       "roundie"
 #define NVS_KEY_IS_METRIC   "isMetric"
 
+// ── Screen manager (screen_manager.h) ────────────────────────────────────────
+#define SCREEN_HEAP_BUDGET   (96 * 1024)  // bytes of resident screens before eviction
+#define SCREEN_PREWARM       1     // build swipe neighbours of the active screen when idle
+#define SCREEN_EVICT_HOLD_MS 5000  // screens shown this recently are never deleted
+
 // ── Screen indices ───────────────────────────────────────────────────────────
 #define SCREEN_CLOCK        0
 #define SCREEN_MULTIARC     1
 #define SCREEN_BOOSTGAUGE   2
-#define SCREEN_SETUP        3
-#define SCREEN_COUNT        3
+#define SCREEN_LAYOUT       3
+#define SCREEN_SETUP        4
+#define SCREEN_COUNT        4
 
 // ── Haltech CAN V2 message IDs (needed by can_handler.h parseCAN) ─────────────
 #define CAN_ID_LAMBDA_BOOST_FUELPRES    0x3D0
 #define CAN_ID_RPM                      0x3D1
 #define CAN_ID_COOLANT_OILPRES          0x3D2
+
+// ── CAN backend (see roundie/config.h, sim/can_backend_host.h) ───────────────
+#define CAN_BACKEND_MCP2515 0
+#define CAN_BACKEND_TWAI    1
+#ifndef CAN_BACKEND
+#define CAN_BACKEND         CAN_BACKEND_MCP2515   // or build with -DCAN_BACKEND=1
+#endif
+
+// ── MCP2515 SPI (mcp2515_rx.h, sim/mcp2515_model.h) ──────────────────────────
+#define CAN_SPI_CLOCK   10000000   // Hz; the MCP2515's maximum
+
+// ── TWAI driver (sim/twai_model.h) ───────────────────────────────────────────
+#define CAN_TWAI_RX_QUEUE_LEN  32   // frames the driver's ISR buffers for the CAN task
+
+// ── CAN RX queue (see roundie/config.h) ──────────────────────────────────────
+#define CAN_RX_QUEUE_LEN    256
+#define CAN_DRAIN_BATCH     16
+
+// ── CAN bus health and decode budget (can_health.h) ──────────────────────────
+#define CAN_HEALTH_MAX_IDS  16    // IDs counted separately, the rest as "other"
+#define CAN_HEALTH_POLL_MS  100   // MCP2515 error flag (EFLG) poll interval
+#define CAN_LATENCY_BIN_US  25    // RX latency histogram resolution
+#define CAN_LATENCY_BINS    80    // last bin collects everything beyond 2 ms
+#if CAN_BACKEND == CAN_BACKEND_TWAI
+#define CAN_HW_RX_BUFFERS   CAN_TWAI_RX_QUEUE_LEN   // frames the controller holds while the task decodes
+#else
+#define CAN_HW_RX_BUFFERS   2
+#endif
+#define CAN_DRAIN_DUTY      0.5f  // share of their fill time a pass may spend decoding
+
+// ── Sensor filtering and interpolation (sensor_filter.h, sensor_interp.h) ───
+// The per-channel filters, smallest animated steps, statistics ranges and
+// UI refresh caps (SENSOR_FILTERS, SENSOR_INTERP_MIN_STEP,
+// SENSOR_STATS_RANGE, UI_CHANNEL_PERIOD_MS) are generated into
+// can_signals.h from the @tune lines of tools/haltech_v2.sig, so they
+// always have one entry per channel.
+
+// ── Data logger (data_logger.h) ──────────────────────────────────────────────
+#define DATA_LOG            1                  // 0 = compile the logger out
+#define LOG_BLOCK_ROWS      256                // rows per encoded block
+#define LOG_BLOCK_MAX_MS    1000               // seal a block at least this often
+#define LOG_RING_BYTES      (256 * 1024)       // encoded blocks awaiting the writer (PSRAM)
+#define LOG_WRITE_BATCH     (32 * 1024)        // bytes per fwrite()
+#define LOG_FLUSH_MS        2000               // write a partial batch after this long
+#define LOG_MAX_FILE_BYTES  (384u * 1024)      // then recording goes on in a new file
@@ -1,21 +1,299 @@
 #include <lvgl.h>
 #include <SDL.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
 
 #include "config.h"
+#include "can_log.h"
+#include "can_backend_host.h"
+#include "../roundie/can_queue.h"
+#include "../roundie/ui_update.h"
+#include "../roundie/round_viewport.h"
+#include "../roundie/ui_runtime.h"
 #include "../roundie/screen_clock.h"
 #include "../roundie/screen_multiarc.h"
 #include "../roundie/screen_boostgauge.h"
+#include "../roundie/screen_layout.h"
+#include "../roundie/screen_channels.h"
 #include "../roundie/screen_setup.h"
+#include "../roundie/screen_manager.h"
+#include "../roundie/boot_profile.h"
+#include "../roundie/trace_overlay.h"
 
-extern lv_obj_t* g_screens[4];
+extern lv_obj_t* g_screens[SCREEN_SETUP + 1];
+extern int g_currentScreen;
+
+/**
+ * The SDL driver owns the flush callback, so the simulator only accounts for
+ * what the device's trimmed flush would send (round_viewport.h).
+ */
+static void _rvFlushStartCb(lv_event_t *e) {
+    lv_display_t *disp = (lv_display_t *)lv_event_get_current_target(e);
+    roundViewportFlush(disp, (const lv_area_t *)lv_event_get_param(e), nullptr, false, nullptr);
+}
+
+// Screens are built on first use, as on the device (screen_manager.h)
+static const ScreenDef kScreens[] = {
+    { "clock",    createClockScreen,       releaseClockScreen       },
+    { "multiarc", createMultiArcScreen,    releaseMultiArcScreen    },
+    { "boost",    createAnalogBoostScreen, releaseAnalogBoostScreen },
+    { "layout",   createLayoutScreen,      releaseLayoutScreen      },
+    { "setup",    createSetupScreen,       releaseSetupScreen       },
+};
+static ScreenManager s_screenMgr;
 
 static void switchToScreen(int idx) {
     if (idx < 0 || idx > SCREEN_SETUP) return;
-    if (!g_screens[idx]) return;
-    lv_scr_load(g_screens[idx]);
+    lv_obj_t *scr = screenManagerGet(s_screenMgr, idx);
+    if (!scr) return;
+    g_currentScreen = idx;
+    lv_scr_load(scr);
+}
+
+// ── CAN thread ────────────────────────────────────────────────────────────────
+// Plays the part of the firmware's CAN task (_canTask() in roundie.ino): the
+// log replay and the synthetic cruise feed put frames on a modelled CAN
+// controller (can_backend_host.h: the MCP2515 or TWAI, per CAN_BACKEND),
+// which is read into s_canQueue as on the device; the queue is drained
+// through drainCANQueue() and changed channels are posted to the UI thread
+// (the main thread, which alone calls into LVGL).
+static CanFrameQueue<CAN_RX_QUEUE_LEN> s_canQueue;
+static std::atomic<bool> s_canStop{false};
+static std::atomic<bool> s_cruise{false};
+static CanBackend        s_can;
+
+#define SIM_CRUISE_PERIOD_US  20000   // 0x3D0 at 50 Hz
+#define SIM_CAN_IDLE_US       1000    // longest sleep between CAN thread passes
+#define SIM_INPUT_POLL_MS     5       // longest UI wait, so SDL input stays responsive
+
+/**
+ * One frame on the bus: offered to the modelled controller, then, if that
+ * raised its interrupt, everything it holds is read into s_canQueue, as
+ * _canTask() does.
+ */
+static void _busFrame(const struct can_frame &f) {
+    s_can.busFrame(f);
+    if (!s_can.pending()) return;
+    struct can_frame frames[2];
+    CanRxFrame rx;
+    while (uint8_t n = s_can.read(frames)) {
+        rx.tsUs = micros();
+        for (uint8_t i = 0; i < n; i++) {
+            rx.frame = frames[i];
+            s_canQueue.push(rx);
+        }
+    }
+}
+
+/**
+ * Synthetic steady-cruise traffic: 0x3D0 at 50 Hz with boost, lambda and
+ * fuel pressure jittering by a few LSBs around fixed values – enough to
+ * change the raw data every frame without a visible change on screen.
+ */
+static void _feedCruiseFrame(void) {
+    static uint32_t rng = 1;
+    rng = rng * 1103515245u + 12345u;
+    int jitter = (int)((rng >> 16) % 9) - 4;            // -4 .. +4 LSB
+
+    uint16_t lambda = (uint16_t)(1000 + jitter);         // λ 0.996 .. 1.004
+    int16_t  boost  = (int16_t)(1000 + jitter);          // 99.6 .. 100.4 kPa
+    int16_t  fuel   = (int16_t)(3000 + 2 * jitter);      // ~300 kPa
+    CanRxFrame rx;
+    rx.frame.can_id  = CAN_ID_LAMBDA_BOOST_FUELPRES;
+    rx.frame.can_dlc = 8;
+    const uint8_t d[8] = {
+        (uint8_t)lambda, (uint8_t)(lambda >> 8),
+        (uint8_t)boost,  (uint8_t)((uint16_t)boost >> 8),
+        (uint8_t)fuel,   (uint8_t)((uint16_t)fuel >> 8), 0, 0
+    };
+    memcpy(rx.frame.data, d, sizeof(d));
+    _busFrame(rx.frame);
+}
+
+/** replaying = false: no log, the thread only serves the cruise feed. */
+static void _canThread(CanLogReader *reader, bool replaying, double speed, bool loop) {
+    traceThreadName("can");
+    CanLogReplay replay(*reader, speed, loop);
+    // Acceptance filters and start, as _canBringUp() does
+    s_can.begin();
+    auto sink = [speed](const CanLogFrame &f) {
+        // As fast as possible: wait for room instead of dropping
+        if (speed <= 0.0 && s_canQueue.size() >= s_canQueue.capacity()) return false;
+        _busFrame(f.frame);
+        return true;
+    };
+    if (replaying) replay.start(canLogClockUs());
+
+    uint64_t nextCruiseUs = canLogClockUs();
+    uint32_t lastDropped  = 0;
+    CanDrainBudget budget;
+    while (!s_canStop.load(std::memory_order_relaxed)) {
+        uint64_t now = canLogClockUs();
+        if (replaying && !replay.pump(now, sink)) {
+            replaying = false;
+            printf("[SIM] replay finished: %llu frames, %u lines skipped\n",
+                   (unsigned long long)replay.delivered(), (unsigned)reader->skipped());
+        }
+        if (s_cruise.load(std::memory_order_relaxed) && now >= nextCruiseUs) {
+            nextCruiseUs = now + SIM_CRUISE_PERIOD_US;
+            _feedCruiseFrame();
+        }
+
+        // Decode budget as on the device (can_health.h)
+        uint32_t t0 = micros();
+        size_t   n  = drainCANQueue(s_canQueue, canDrainBudget(budget, s_canQueue.pushed(), t0,
+                                                               s_canQueue.capacity()));
+        canDrainCost(budget, n, micros() - t0);
+        uiRuntimePost(s_uiRuntime, takeSensorChanges());
+        s_can.pollErrors();
+
+        uint32_t dropped = s_canQueue.dropped();
+        if (dropped != lastDropped) {
+            lastDropped = dropped;
+            printf("[CAN] RX queue overflow: dropped=%u hwm=%u/%u\n", (unsigned)dropped,
+                   (unsigned)s_canQueue.highWater(), (unsigned)s_canQueue.capacity());
+        }
+
+        if (s_canQueue.size() > 0) continue;   // over budget: decode the rest first
+        // Sleep until the next replayed frame is due, at most SIM_CAN_IDLE_US
+        now = canLogClockUs();
+        uint64_t due = now + SIM_CAN_IDLE_US;
+        if (replaying) {
+            if (speed <= 0.0) { std::this_thread::yield(); continue; }
+            due = LV_MIN(due, replay.nextDueUs());
+        }
+        if (due > now) std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+    }
+}
+
+// ── Log writer thread ─────────────────────────────────────────────────────────
+// The firmware's _logTask(): writes the data log (data_logger.h) to a local
+// file instead of LittleFS.  The decoder side runs inside the CAN thread.
+static std::atomic<bool> s_logStop{false};
+
+static void _logThread(void) {
+    s_dataLog.signal.bindCurrentTask();
+    traceThreadName("log");
+    while (!s_logStop.load()) dataLogWriterStep();
+}
+
+/** Whole file into out.  @return false if it cannot be read */
+static bool _readFile(const char *path, std::vector<uint8_t> &out) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t chunk[1024];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) out.insert(out.end(), chunk, chunk + n);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+static void _usage(const char *argv0) {
+    printf("usage: %s [--replay <candump.log|trace.asc>] [--speed <N>|max] [--loop] "
+           "[--log <file.rlog>] [--layout <file.rgl>] [--trace <file.json>]\n", argv0);
+}
+
+static void _fileWrite(const char *s, size_t n, void *ctx) {
+    fwrite(s, 1, n, (FILE *)ctx);
+}
+
+/** The trace ring as Chrome trace JSON into path (trace.h). */
+static void _writeTrace(const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        printf("[SIM] cannot create %s\n", path);
+        return;
+    }
+    uint32_t n = traceWriteChrome(_fileWrite, f);
+    fclose(f);
+    printf("[SIM] %u trace spans written to %s\n", (unsigned)n, path);
+}
+
+/** Same per-screen refresh as _updateScreen() in roundie.ino. */
+static bool _updateActiveScreen(int screen) {
+    switch (screen) {
+        case SCREEN_CLOCK: {
+            time_t t = time(nullptr);
+            struct tm *lt = localtime(&t);
+            updateClockScreen(lt->tm_hour, lt->tm_min, lt->tm_sec);
+            break;
+        }
+        case SCREEN_MULTIARC:   return updateMultiArcScreen();
+        case SCREEN_BOOSTGAUGE: return updateAnalogBoostScreen();
+        case SCREEN_LAYOUT:     return updateLayoutScreen();
+        default: break;
+    }
+    return false;
 }
 
-int main() {
+int main(int argc, char **argv) {
+    const char *replayPath = nullptr;
+    double replaySpeed = 1.0;
+    bool   replayLoop  = false;
+    const char *logPath = nullptr;
+    const char *layoutPath = nullptr;
+    const char *tracePath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--replay") && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (!strcmp(argv[i], "--speed") && i + 1 < argc) {
+            i++;
+            replaySpeed = strcmp(argv[i], "max") == 0 ? 0.0 : atof(argv[i]);
+        } else if (!strcmp(argv[i], "--loop")) {
+            replayLoop = true;
+        } else if (!strcmp(argv[i], "--log") && i + 1 < argc) {
+            logPath = argv[++i];
+        } else if (!strcmp(argv[i], "--layout") && i + 1 < argc) {
+            layoutPath = argv[++i];
+        } else if (!strcmp(argv[i], "--trace") && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            _usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (tracePath && !TRACE_ENABLED) {
+        fprintf(stderr, "--trace needs a build with -DTRACE_ENABLED=1\n");
+        return 2;
+    }
+    traceThreadName("ui");
+
+    CanLogReader replayReader;
+    if (replayPath && !replayReader.open(replayPath)) {
+        fprintf(stderr, "cannot open %s\n", replayPath);
+        return 2;
+    }
+
+    if (logPath && !dataLogBegin(logPath)) {
+        fprintf(stderr, "cannot create %s\n", logPath);
+        return 2;
+    }
+
+    // The layout screen's layout: the file, or the built-in one (screen_layout.h)
+    if (layoutPath) {
+        std::vector<uint8_t> blob;
+        if (!_readFile(layoutPath, blob)) {
+            fprintf(stderr, "cannot read %s\n", layoutPath);
+            return 2;
+        }
+        if (const char *err = layoutScreenLoad(blob.data(), blob.size())) {
+            fprintf(stderr, "%s: %s\n", layoutPath, err);
+            return 2;
+        }
+        printf("[SIM] layout %s, %u widgets\n", layoutPath, (unsigned)s_layout.hdr.count);
+    } else {
+        layoutScreenLoad(nullptr, 0);
+    }
+
+    int h = bootBegin("sdl + lvgl");
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) != 0) return 1;
 
     lv_init();
@@ -26,16 +304,44 @@ int main() {
 
     lv_display_t* disp = lv_sdl_window_create(DISPLAY_WIDTH, DISPLAY_HEIGHT);
     lv_sdl_window_set_title(disp, "roundie LVGL9 simulator");
+    roundViewportInstall(disp);   // first, so later handlers see clipped areas
+    lv_display_add_event_cb(disp, _rvFlushStartCb, LV_EVENT_FLUSH_START, nullptr);
+    uiStatsInstall(disp);
+    traceOverlayInstall(disp);
+    traceOverlayShow(TRACE_OVERLAY);
+    bootEnd(h);
 
-    g_screens[SCREEN_CLOCK]      = createClockScreen();
-    g_screens[SCREEN_MULTIARC]   = createMultiArcScreen();
-    g_screens[SCREEN_BOOSTGAUGE] = createAnalogBoostScreen();
-    g_screens[SCREEN_SETUP]      = createSetupScreen();
-
+    screenManagerInit(s_screenMgr, kScreens, SCREEN_SETUP + 1, g_screens,
+                      SCREEN_HEAP_BUDGET, nullptr);
+    h = bootBegin("clock screen");
     switchToScreen(SCREEN_CLOCK);
+    bootEnd(h);
+    lv_refr_now(disp);
+    bootMark("first frame");
+    bootProfileSetupDone();
+    char line[112];
+    for (int i = 0; i < bootProfileCount(); i++) {
+        printf("[BOOT] %s\n", bootProfileLine(i, line, sizeof(line)));
+    }
+
+    if (replayPath) {
+        char pace[32];
+        if (replaySpeed > 0.0) snprintf(pace, sizeof(pace), "%gx", replaySpeed);
+        else                   snprintf(pace, sizeof(pace), "max speed");
+        printf("[SIM] replaying %s at %s%s\n", replayPath, pace,
+               replayLoop ? ", looping" : "");
+    }
+    std::thread logWriter;
+    if (logPath) {
+        printf("[SIM] logging to %s\n", logPath);
+        logWriter = std::thread(_logThread);
+    }
+    std::thread can(_canThread, &replayReader, replayPath != nullptr, replaySpeed, replayLoop);
 
     bool running = true;
     uint32_t last = SDL_GetTicks();
+    uint32_t lastStatsMs = last;
+    uint32_t bits = 0;
 
     while (running) {
         SDL_Event e;
@@ -47,7 +353,35 @@ int main() {
                     case SDLK_1: switchToScreen(SCREEN_CLOCK); break;
                     case SDLK_2: switchToScreen(SCREEN_MULTIARC); break;
                     case SDLK_3: switchToScreen(SCREEN_BOOSTGAUGE); break;
-                    case SDLK_4: switchToScreen(SCREEN_SETUP); break;
+                    case SDLK_4: switchToScreen(SCREEN_LAYOUT); break;
+                    case SDLK_5: switchToScreen(SCREEN_SETUP); break;
+                    case SDLK_c: {
+                        bool cruise = !s_cruise.load();
+                        s_cruise.store(cruise);
+                        printf("[SIM] steady-cruise feed %s\n", cruise ? "on" : "off");
+                        break;
+                    }
+                    case SDLK_d:
+                        s_uiDirtyCheck = !s_uiDirtyCheck;
+                        printf("[SIM] dirty checking %s\n", s_uiDirtyCheck ? "on" : "off");
+                        break;
+                    case SDLK_p:
+                        sensorStatsRequestReset();
+                        printf("[SIM] session statistics and peak hold reset\n");
+                        break;
+#if TRACE_ENABLED
+                    case SDLK_o:
+                        traceOverlayShow(!traceOverlayShown());
+                        break;
+                    case SDLK_t:
+                        _writeTrace(tracePath ? tracePath : "trace.json");
+                        break;
+#endif
+                    case SDLK_r:
+                        s_roundViewport = !s_roundViewport;
+                        lv_obj_invalidate(lv_screen_active());
+                        printf("[SIM] round viewport %s\n", s_roundViewport ? "on" : "off");
+                        break;
                     default: break;
                 }
             }
@@ -57,9 +391,59 @@ int main() {
         lv_tick_inc(now - last);
         last = now;
 
-        lv_timer_handler();
-        SDL_Delay(5);
+        int screen = g_currentScreen;
+        uint32_t waitMs = uiRuntimeStep(s_uiRuntime, bits, screen, screenChannels(screen),
+                                        screen == SCREEN_CLOCK, _updateActiveScreen,
+                                        SIM_INPUT_POLL_MS);
+        // Nothing due before the next input poll: build or delete a screen
+        if (waitMs >= SIM_INPUT_POLL_MS && screenManagerIdle(s_screenMgr)) waitMs = 0;
+        traceOverlayUpdate();
+        if (now - lastStatsMs >= UI_STATS_PERIOD_MS) {
+            lastStatsMs = now;
+            printf("[UI] invalidated %u px/s\n", (unsigned)uiStatsInvalidatedPxPerSec());
+            uint32_t rvPx;
+            int32_t  rvBytes;
+            roundViewportReport(rvPx, rvBytes);
+            printf("[UI] round viewport saved %u px and %d QSPI bytes per frame\n",
+                   (unsigned)rvPx, (int)rvBytes);
+            uint32_t wakeups, updates;
+            uiRuntimeStats(s_uiRuntime, UI_STATS_PERIOD_MS, wakeups, updates);
+            printf("[UI] thread woke %u/s, %u screen updates/s\n",
+                   (unsigned)wakeups, (unsigned)updates);
+            UiLatencyReport lat = uiRuntimeLatency(s_uiRuntime);
+            printf("[UI] decode→update latency: n=%u p50<%u p90<%u p99<%u max=%u us\n",
+                   (unsigned)lat.count, (unsigned)lat.p50Us, (unsigned)lat.p90Us,
+                   (unsigned)lat.p99Us, (unsigned)lat.maxUs);
+            char summary[512];
+            printf("[SCR] %s\n", screenManagerFormat(s_screenMgr, summary, sizeof(summary)));
+            printf("[CANH] %s\n", canHealthFormat(canHealthReport(UI_STATS_PERIOD_MS,
+                                                                   s_canQueue.dropped()),
+                                                   summary, sizeof(summary)));
+            printf("[CANB] %s: %s\n", s_can.name(), s_can.format(summary, sizeof(summary)));
+            printf("[STATS] %s\n", sensorStatsFormat(readSensorStats(), SENSOR_DISPLAY_MASK,
+                                                     summary, sizeof(summary)));
+            if (logPath) {
+                DataLogReport log = dataLogReport(UI_STATS_PERIOD_MS);
+                printf("[LOG] %u rows/s, %.1f B/row, %u B/s written at %u kB/s, "
+                       "dropped %u blocks; max encode %u us (CAN thread), max write %u us\n",
+                       (unsigned)log.rowsPerSec, log.bytesPerRow, (unsigned)log.bytesPerSec,
+                       (unsigned)log.writeKBps, (unsigned)log.droppedBlocks,
+                       (unsigned)log.encodeUsMax, (unsigned)log.writeUsMax);
+            }
+        }
+
+        bits = s_uiRuntime.signal.wait(waitMs);
+    }
+
+    s_canStop.store(true);
+    can.join();
+    if (logPath) {
+        s_logStop.store(true);
+        s_dataLog.signal.post(1);
+        logWriter.join();
+        dataLogEnd();                 // decoder stopped: seal and write the rest
     }
+    if (tracePath) _writeTrace(tracePath);
 
     SDL_Quit();
     return 0;
@@ -0,0 +1,307 @@
+/**
+ * sim/mcp2515_model.h
+ * Register-level model of the MCP2515 receive side, driven over "SPI".
+ *
+ * Mcp2515Model::transfer() takes one transaction (CS low for the whole
+ * buffer) and answers it as the chip would:
+ *
+ *   RESET  READ  WRITE  BIT MODIFY  READ STATUS  RX STATUS
+ *   READ RX BUFFER (clears RXnIF when the transaction ends)
+ *   LOAD TX BUFFER (stored; nothing is transmitted)
+ *
+ * receive() puts a frame "on the bus": outside configuration mode it is
+ * matched against RXM0/RXF0–1 for RXB0 and RXM1/RXF2–5 for RXB1 (or taken
+ * unfiltered when RXBnCTRL.RXM is 11), rolled over from RXB0 into RXB1 when
+ * BUKT is set, loaded into the buffer's registers and flagged in CANINTF –
+ * or counted as an overflow in EFLG, raising ERRIF, when the buffer is
+ * still full.  interrupt() is the INT pin (active while CANINTF & CANINTE);
+ * edges() counts its falling edges, which is all the firmware's FALLING ISR
+ * sees: while ERRIF or MERRF is set and enabled, INT stays low and a new
+ * frame makes no edge.
+ *
+ * Every transaction and byte is counted, so a receive path can be costed
+ * per frame without hardware.  Only what reception touches is modelled: no
+ * bit timing, transmission or error counters.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <can.h>
+#include "../roundie/can_filter.h"
+
+// Registers
+#define MCP_CANSTAT    0x0E
+#define MCP_CANCTRL    0x0F
+#define MCP_RXM0SIDH   0x20
+#define MCP_RXM1SIDH   0x24
+#define MCP_CANINTE    0x2B
+#define MCP_CANINTF    0x2C
+#define MCP_EFLG       0x2D
+#define MCP_TXB0CTRL   0x30
+#define MCP_RXB0CTRL   0x60
+#define MCP_RXB1CTRL   0x70
+
+static constexpr uint8_t kMcpRxfSidh[6] = { 0x00, 0x04, 0x08, 0x10, 0x14, 0x18 };   // RXF0..5
+
+// Instructions
+#define MCP_WRITE          0x02
+#define MCP_READ           0x03
+#define MCP_BITMOD         0x05
+#define MCP_LOAD_TX0       0x40
+#define MCP_READ_RX0       0x90
+#define MCP_READ_STATUS    0xA0
+#define MCP_RX_STATUS      0xB0
+#define MCP_RESET          0xC0
+
+#define MCP_CANINTF_RX0IF  0x01
+#define MCP_CANINTF_RX1IF  0x02
+#define MCP_CANINTF_ERRIF  0x20
+#define MCP_CANINTF_MERRF  0x80
+#define MCP_EFLG_RX0OVR    0x40
+#define MCP_EFLG_RX1OVR    0x80
+#define MCP_RXB0CTRL_BUKT  0x04
+#define MCP_RXBCTRL_RXM    0x60
+#define MCP_MODE_CONFIG    0x80
+
+class Mcp2515Model {
+public:
+    Mcp2515Model() { reset(); }
+
+    /** Power-on / RESET state: configuration mode, every filter open. */
+    void reset(void) {
+        memset(m_reg, 0, sizeof(m_reg));
+        m_reg[MCP_CANCTRL] = 0x87;
+        m_reg[MCP_CANSTAT] = MCP_MODE_CONFIG;
+        m_int = false;
+    }
+
+    /** One SPI transaction: n bytes out of tx while n bytes come back in rx. */
+    void transfer(const uint8_t *tx, uint8_t *rx, size_t n) {
+        m_transactions++;
+        m_bytes += n;
+        memset(rx, 0xFF, n);
+        if (n == 0) return;
+        uint8_t op = tx[0];
+        if (op == MCP_RESET) {
+            reset();
+        } else if (op == MCP_READ && n >= 2) {
+            for (size_t i = 2; i < n; i++) rx[i] = m_reg[(tx[1] + i - 2) & 0x7F];
+        } else if (op == MCP_WRITE && n >= 2) {
+            for (size_t i = 2; i < n; i++) _write((uint8_t)((tx[1] + i - 2) & 0x7F), tx[i]);
+        } else if (op == MCP_BITMOD && n >= 4) {
+            uint8_t a = tx[1] & 0x7F;
+            _write(a, (uint8_t)((m_reg[a] & ~tx[2]) | (tx[3] & tx[2])));
+        } else if ((op & 0xF8) == MCP_LOAD_TX0 && (op & 0x07) <= 5) {
+            // TXBnSIDH or TXBnD0 of buffer n
+            uint8_t a = (uint8_t)(MCP_TXB0CTRL + 0x10 * ((op & 0x07) >> 1) + ((op & 1) ? 6 : 1));
+            for (size_t i = 1; i < n; i++) m_reg[(a + i - 1) & 0x7F] = tx[i];
+        } else if ((op & 0xF9) == MCP_READ_RX0) {
+            // RXBnSIDH or RXBnD0; the flag clears when CS goes high
+            uint8_t buffer = (op >> 2) & 1;
+            uint8_t base   = buffer ? MCP_RXB1CTRL : MCP_RXB0CTRL;
+            uint8_t a      = (uint8_t)(base + ((op & 0x02) ? 6 : 1));
+            for (size_t i = 1; i < n; i++) rx[i] = m_reg[(a + i - 1) & 0x7F];
+            m_reg[MCP_CANINTF] &= (uint8_t)~(buffer ? MCP_CANINTF_RX1IF : MCP_CANINTF_RX0IF);
+        } else if (op == MCP_READ_STATUS) {
+            uint8_t intf = m_reg[MCP_CANINTF];
+            uint8_t status = (intf & 0x03)
+                           | ((m_reg[MCP_TXB0CTRL] & 0x08) >> 1) | ((intf & 0x04) << 1)
+                           | ((m_reg[MCP_TXB0CTRL + 0x10] & 0x08) << 1) | ((intf & 0x08) << 2)
+                           | ((m_reg[MCP_TXB0CTRL + 0x20] & 0x08) << 3) | ((intf & 0x10) << 3);
+            for (size_t i = 1; i < n; i++) rx[i] = status;
+        } else if (op == MCP_RX_STATUS) {
+            for (size_t i = 1; i < n; i++) rx[i] = _rxStatus();
+        }
+        _updateInt();
+    }
+
+    /**
+     * A frame on the bus (SocketCAN id).
+     * @return true if a receive buffer took it
+     */
+    bool receive(const struct can_frame &f) {
+        bool taken = _receive(f);
+        _updateInt();
+        return taken;
+    }
+
+    /** The INT pin, asserted (low on the chip) while this is true. */
+    bool interrupt(void) const {
+        return (m_reg[MCP_CANINTF] & m_reg[MCP_CANINTE]) != 0;
+    }
+
+    uint8_t  reg(uint8_t a) const { return m_reg[a & 0x7F]; }
+    uint64_t edges(void) const { return m_edges; }
+    uint64_t transactions(void) const { return m_transactions; }
+    uint64_t bytes(void) const { return m_bytes; }
+    uint64_t overflows(void) const { return m_overflows; }
+    void     resetCounters(void) { m_transactions = m_bytes = m_overflows = 0; }
+
+private:
+    uint8_t  m_reg[128];
+    uint8_t  m_lastType = 0, m_lastFilter = 0;   // of the last frame loaded, for RX STATUS
+    bool     m_int = false;                      // INT asserted after the last operation
+    uint64_t m_edges = 0, m_transactions = 0, m_bytes = 0, m_overflows = 0;
+
+    void _updateInt(void) {
+        bool now = interrupt();
+        if (now && !m_int) m_edges++;
+        m_int = now;
+    }
+
+    /** An overflow: the EFLG bit, and ERRIF for the error interrupt. */
+    void _overflow(uint8_t eflgBit) {
+        m_reg[MCP_EFLG]    |= eflgBit;
+        m_reg[MCP_CANINTF] |= MCP_CANINTF_ERRIF;
+        m_overflows++;
+    }
+
+    bool _receive(const struct can_frame &f) {
+        if ((m_reg[MCP_CANSTAT] & 0xE0) == MCP_MODE_CONFIG) return false;
+        int hit0 = _match(0, f), hit1 = hit0 < 0 ? _match(1, f) : -1;
+        if (hit0 >= 0) {
+            if (!(m_reg[MCP_CANINTF] & MCP_CANINTF_RX0IF)) {
+                _load(0, f, (uint8_t)hit0);
+                return true;
+            }
+            if (!(m_reg[MCP_RXB0CTRL] & MCP_RXB0CTRL_BUKT)) {
+                _overflow(MCP_EFLG_RX0OVR);
+                return false;
+            }
+            hit1 = hit0;   // rolls over into RXB1, whatever RXB1's filters say
+        }
+        if (hit1 < 0) return false;
+        if (m_reg[MCP_CANINTF] & MCP_CANINTF_RX1IF) {
+            _overflow(MCP_EFLG_RX1OVR);
+            return false;
+        }
+        _load(1, f, (uint8_t)hit1);
+        return true;
+    }
+
+    void _write(uint8_t a, uint8_t v) {
+        if ((a & 0x0F) == MCP_CANSTAT || a == 0x1C || a == 0x1D) return;   // read-only
+        if ((a & 0x0F) == MCP_CANCTRL) {
+            // Mode changes take effect at once; CANCTRL/CANSTAT repeat every row
+            for (uint8_t row = 0; row < 8; row++) {
+                m_reg[row * 0x10 + MCP_CANCTRL] = v;
+                m_reg[row * 0x10 + MCP_CANSTAT] = (uint8_t)((m_reg[MCP_CANSTAT] & 0x1F) | (v & 0xE0));
+            }
+            return;
+        }
+        m_reg[a] = v;
+    }
+
+    /** 29-bit id, or 11-bit id plus the first two data bytes, from SIDH.. */
+    uint32_t _reg29(uint8_t a) const {
+        return ((uint32_t)m_reg[a] << 21) | ((uint32_t)(m_reg[a + 1] & 0xE0) << 13)
+             | ((uint32_t)(m_reg[a + 1] & 0x03) << 16) | ((uint32_t)m_reg[a + 2] << 8)
+             | m_reg[a + 3];
+    }
+
+    /** Filter number (0–5) buffer's filters accept f with, or -1. */
+    int _match(uint8_t buffer, const struct can_frame &f) const {
+        uint8_t ctrl = m_reg[buffer ? MCP_RXB1CTRL : MCP_RXB0CTRL];
+        if ((ctrl & MCP_RXBCTRL_RXM) == MCP_RXBCTRL_RXM) return buffer ? 2 : 0;   // filters off
+
+        bool     ext = (f.can_id & CAN_EFF_FLAG) != 0;
+        uint32_t key;
+        if (ext) {
+            key = f.can_id & CAN_EFF_MASK;
+        } else {
+            // Standard frames: SID, then the first two data bytes under EID8/EID0
+            key = ((f.can_id & CAN_SFF_MASK) << 18)
+                | ((uint32_t)(f.can_dlc > 0 ? f.data[0] : 0) << 8)
+                | (f.can_dlc > 1 ? f.data[1] : 0);
+        }
+        uint32_t mask = _reg29(buffer ? MCP_RXM1SIDH : MCP_RXM0SIDH);
+        int first = buffer ? 2 : 0, last = buffer ? 6 : 2;
+        for (int i = first; i < last; i++) {
+            uint8_t a = kMcpRxfSidh[i];
+            bool exide = (m_reg[a + 1] & 0x08) != 0;
+            if (exide != ext) continue;
+            if (((key ^ _reg29(a)) & mask) == 0) return i;
+        }
+        return -1;
+    }
+
+    void _load(uint8_t buffer, const struct can_frame &f, uint8_t filter) {
+        uint8_t base = buffer ? MCP_RXB1CTRL : MCP_RXB0CTRL;
+        uint8_t *r = &m_reg[base + 1];
+        bool ext = (f.can_id & CAN_EFF_FLAG) != 0, rtr = (f.can_id & CAN_RTR_FLAG) != 0;
+        if (ext) {
+            uint32_t id = f.can_id & CAN_EFF_MASK;
+            r[0] = (uint8_t)(id >> 21);
+            r[1] = (uint8_t)(((id >> 13) & 0xE0) | 0x08 | ((id >> 16) & 0x03));
+            r[2] = (uint8_t)(id >> 8);
+            r[3] = (uint8_t)id;
+            r[4] = (uint8_t)((rtr ? 0x40 : 0) | (f.can_dlc & 0x0F));
+        } else {
+            uint32_t id = f.can_id & CAN_SFF_MASK;
+            r[0] = (uint8_t)(id >> 3);
+            r[1] = (uint8_t)(((id & 0x07) << 5) | (rtr ? 0x10 : 0));
+            r[2] = r[3] = 0;
+            r[4] = (uint8_t)(f.can_dlc & 0x0F);
+        }
+        memcpy(r + 5, f.data, 8);
+        // RXBnCTRL: FILHIT, and RXRTR for remote frames
+        uint8_t &ctrl = m_reg[base];
+        if (buffer == 0) ctrl = (uint8_t)((ctrl & 0xF4) | (filter & 1) | (rtr ? 0x08 : 0));
+        else             ctrl = (uint8_t)((ctrl & 0xF0) | (filter & 7) | (rtr ? 0x08 : 0));
+        m_lastType = (uint8_t)((ext ? 0x10 : 0) | (rtr ? 0x08 : 0));
+        m_lastFilter = buffer == 1 && filter < 2 ? (uint8_t)(6 + filter) : filter;   // 6/7: rolled over
+        m_reg[MCP_CANINTF] |= buffer ? MCP_CANINTF_RX1IF : MCP_CANINTF_RX0IF;
+    }
+
+    /** RX STATUS: full buffers in bits 7:6, type and filter of the last frame loaded. */
+    uint8_t _rxStatus(void) const {
+        uint8_t intf = m_reg[MCP_CANINTF];
+        uint8_t full = (uint8_t)(((intf & MCP_CANINTF_RX0IF) ? 0x40 : 0) |
+                                 ((intf & MCP_CANINTF_RX1IF) ? 0x80 : 0));
+        return full ? (uint8_t)(full | m_lastType | m_lastFilter) : 0;
+    }
+};
+
+/** Write count registers from a over SPI, as the driver library does. */
+static inline void _mcp2515ModelWrite(Mcp2515Model &chip, uint8_t a, const uint8_t *v, size_t count) {
+    uint8_t tx[16] = { MCP_WRITE, a }, rx[16];
+    memcpy(tx + 2, v, count);
+    chip.transfer(tx, rx, count + 2);
+}
+
+/**
+ * What CanMcp2515Backend::begin() has the driver library do, register by
+ * register: reset, acceptance filters from plan (nullptr: every standard
+ * frame), the RX, error and message-error interrupts the library's reset()
+ * enables, RXB0 rollover, normal mode.  The counters are cleared after.
+ */
+static inline void mcp2515ModelBringUp(Mcp2515Model &chip, const CanFilterPlan *plan) {
+    const uint8_t reset = MCP_RESET;
+    uint8_t dummy;
+    chip.transfer(&reset, &dummy, 1);
+
+    auto stdId = [](uint16_t id, uint8_t *r) {
+        r[0] = (uint8_t)(id >> 3);
+        r[1] = (uint8_t)((id & 0x07) << 5);
+        r[2] = r[3] = 0;
+    };
+    uint8_t r[4];
+    for (uint8_t m = 0; m < 2; m++) {
+        stdId(plan ? plan->mask[m] : 0, r);
+        _mcp2515ModelWrite(chip, m ? MCP_RXM1SIDH : MCP_RXM0SIDH, r, 4);
+    }
+    for (uint8_t f = 0; f < 6; f++) {
+        stdId(plan ? plan->filter[f] : 0, r);
+        _mcp2515ModelWrite(chip, kMcpRxfSidh[f], r, 4);
+    }
+    const uint8_t inte = MCP_CANINTF_RX0IF | MCP_CANINTF_RX1IF | MCP_CANINTF_ERRIF | MCP_CANINTF_MERRF;
+    _mcp2515ModelWrite(chip, MCP_CANINTE, &inte, 1);
+    const uint8_t rxb0 = MCP_RXB0CTRL_BUKT;
+    _mcp2515ModelWrite(chip, MCP_RXB0CTRL, &rxb0, 1);
+    const uint8_t normal = 0x00;
+    _mcp2515ModelWrite(chip, MCP_CANCTRL, &normal, 1);
+    chip.resetCounters();
+}
@@ -0,0 +1,376 @@
+/**
+ * sim/roundie_bench.cpp
+ * Headless render benchmark for the five screens.
+ *
+ * LVGL renders into the same partial buffers the firmware uses, but the
+ * flush callback only counts bytes – no SDL window, no real time.  Time is a
+ * virtual tick clock advanced by one frame period per iteration, so a run is
+ * repeatable and as fast as the host allows.
+ *
+ * Each screen is loaded and driven for a fixed number of virtual seconds:
+ *   clock       – hands advance with the virtual clock
+ *   multiarc    – boost/lambda/fuel sweeps fed through parseCAN() at 50 Hz
+ *   boostgauge  – same sweeps
+ *   layout      – rpm / coolant / oil pressure sweeps (0x3D1, 0x3D2) on
+ *                 the built-in gauge layout (gauge_layout.h)
+ *   setup       – unit selection toggled once per second
+ * with the per-screen update functions called at 10 Hz, as the UI task does.
+ *
+ * One JSON object per screen is written to stdout:
+ *   create_us            time to build the screen's widgets
+ *   objects              LVGL objects in the screen tree (screen included)
+ *   heap_bytes           LVGL heap used by the screen's widgets
+ *   heap_max_used        LVGL heap high-water mark after the run
+ *   frames / rendered    frames run / frames that flushed any pixels
+ *   render_us_mean/p99/max  lv_timer_handler() time over rendered frames
+ *   invalidated_px_per_s invalidation requests (ui_update.h accounting)
+ *   flush_bytes / flush_bytes_per_s  pixel bytes sent to the (dummy) panel
+ *   rv_saved_px_per_frame / rv_saved_bytes_per_frame
+ *                        render pixels and QSPI bytes saved per frame by the
+ *                        round viewport (round_viewport.h)
+ *
+ *   strategy / lines     draw-buffer configuration (render_strategy.h)
+ *
+ * --calibrate first times full redraws of every screen under each render
+ * strategy candidate, exactly as the firmware does with RENDER_CALIBRATE,
+ * prints one JSON object per candidate and runs the screens with the
+ * fastest.  Host RAM stands in for both SRAM and PSRAM, so it compares the
+ * render paths, not the memories.
+ *
+ * --log <file> records the CAN feed with the data logger (data_logger.h)
+ * and runs its writer inline, once per frame, as if logger, decoder and
+ * renderer shared one core – the pessimistic case.  One extra JSON object
+ * per screen reports it:
+ *   log_rows_per_s / log_bytes_per_row  rows logged, encoded size per row
+ *   log_bytes_per_s      file bytes written per (virtual) second
+ *   log_write_kbps       file system speed while inside fwrite()
+ *   log_dropped_blocks   blocks lost to a full ring
+ *   log_encode_us_max    longest block encode (decoder path)
+ *   log_added_us_max     worst time one frame spent in the logger
+ *
+ * Usage:  roundie_bench [seconds_per_screen] [fps] [--no-round]
+ *                       [--strategy partial-sram|partial-psram|direct-psram]
+ *                       [--lines N] [--calibrate] [--log <file.rlog>]
+ */
+
+#include <lvgl.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "config.h"
+#include "../roundie/ui_update.h"
+#include "../roundie/round_viewport.h"
+#include "../roundie/render_strategy.h"
+#include "../roundie/screen_clock.h"
+#include "../roundie/screen_multiarc.h"
+#include "../roundie/screen_boostgauge.h"
+#include "../roundie/screen_layout.h"
+#include "../roundie/screen_setup.h"
+
+extern lv_obj_t *g_screens[SCREEN_SETUP + 1];
+extern int g_currentScreen;
+
+#define BENCH_BYTES_PER_PX  (LV_COLOR_DEPTH / 8)
+#define BENCH_CAL_FRAMES    20   // full redraws per screen and strategy with --calibrate
+
+using Clock = std::chrono::steady_clock;
+
+// ── Dummy display ─────────────────────────────────────────────────────────────
+
+static uint64_t s_flushBytes = 0;
+static bool     s_benchLog   = false;
+
+static void _benchWrite(const lv_area_t *area, const uint8_t *px) {
+    (void)px;
+    s_flushBytes += (uint64_t)lv_area_get_size(area) * BENCH_BYTES_PER_PX;
+}
+
+static void _benchFlush(lv_display_t *disp, const lv_area_t *area, uint8_t *px) {
+    roundViewportFlush(disp, area, px, renderIsFullFrame(), _benchWrite);
+    lv_display_flush_ready(disp);
+}
+
+static size_t _heapUsed(void) {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+static uint32_t _countObjects(const lv_obj_t *obj) {
+    uint32_t n = 1;
+    uint32_t children = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < children; i++) n += _countObjects(lv_obj_get_child(obj, (int32_t)i));
+    return n;
+}
+
+// ── Scripted inputs ───────────────────────────────────────────────────────────
+
+/** Sensor sweeps at virtual time tMs, encoded as 0x3D0, 0x3D1 and 0x3D2 frames. */
+static void _feedSweep(uint32_t tMs) {
+    float t = tMs / 1000.0f;
+    float phase = fmodf(t, 4.0f) / 4.0f;                       // 4 s period
+    float boostKpa = 300.0f * (phase < 0.5f ? 2.0f * phase : 2.0f - 2.0f * phase);
+    float lambda   = 1.0f + 0.2f * sinf(t * 2.0f * (float)M_PI / 3.0f);
+    float fuelKpa  = 300.0f + 50.0f * sinf(t * 2.0f * (float)M_PI / 5.0f);
+
+    uint16_t l = (uint16_t)lroundf(lambda * 1000.0f);
+    int16_t  b = (int16_t)lroundf(boostKpa * 10.0f);
+    int16_t  f = (int16_t)lroundf(fuelKpa * 10.0f);
+    uint8_t d[8] = {
+        (uint8_t)l, (uint8_t)(l >> 8),
+        (uint8_t)b, (uint8_t)((uint16_t)b >> 8),
+        (uint8_t)f, (uint8_t)((uint16_t)f >> 8), 0, 0
+    };
+    parseCAN(CAN_ID_LAMBDA_BOOST_FUELPRES, 8, d);
+
+    // rpm 800–7200 over 6 s, coolant 80–100 °C, oil pressure following rpm
+    float rpm     = 4000.0f - 3200.0f * cosf(t * 2.0f * (float)M_PI / 6.0f);
+    float coolant = 90.0f + 10.0f * sinf(t * 2.0f * (float)M_PI / 20.0f);
+    float oilKpa  = 100.0f + rpm * 0.06f;
+    uint16_t r = (uint16_t)lroundf(rpm);
+    int16_t  c = (int16_t)lroundf(coolant * 10.0f);
+    int16_t  o = (int16_t)lroundf(oilKpa * 10.0f);
+    const uint8_t dr[2] = { (uint8_t)r, (uint8_t)(r >> 8) };
+    const uint8_t dc[4] = { (uint8_t)c, (uint8_t)((uint16_t)c >> 8),
+                            (uint8_t)o, (uint8_t)((uint16_t)o >> 8) };
+    parseCAN(CAN_ID_RPM, 2, dr);
+    parseCAN(CAN_ID_COOLANT_OILPRES, 4, dc);
+}
+
+static void _updateScreen(int idx, uint32_t tMs) {
+    switch (idx) {
+        case SCREEN_CLOCK: {
+            uint32_t s = 10 * 3600 + 8 * 60 + tMs / 1000;         // from 10:08:00
+            updateClockScreen((s / 3600) % 24, (s / 60) % 60, s % 60);
+            break;
+        }
+        case SCREEN_MULTIARC:   updateMultiArcScreen();    break;
+        case SCREEN_BOOSTGAUGE: updateAnalogBoostScreen(); break;
+        case SCREEN_LAYOUT:     updateLayoutScreen();      break;
+        case SCREEN_SETUP:
+            if (tMs % 1000 == 0) {
+                if (g_isMetric) _onMericanTapped(nullptr);
+                else            _onMetricTapped(nullptr);
+            }
+            break;
+    }
+}
+
+// ── Bench ─────────────────────────────────────────────────────────────────────
+
+struct ScreenResult {
+    const char *name;
+    double      createUs;
+    size_t      heapBytes;
+};
+
+static void _runScreen(int idx, const ScreenResult &info, double seconds, uint32_t frameMs) {
+    g_currentScreen = idx;
+    lv_screen_load(g_screens[idx]);
+    uiStatsInvalidatedPxPerSec();     // restart the invalidation window
+    uint32_t rvPx;
+    int32_t  rvBytes;
+    roundViewportReport(rvPx, rvBytes);
+    s_flushBytes = 0;
+
+    const uint32_t frames = (uint32_t)(seconds * 1000.0 / frameMs);
+    std::vector<double> renderUs;
+    renderUs.reserve(frames);
+    uint32_t tMs = 0, lastFeedMs = 0, lastUpdateMs = 0;
+    double   logAddedUsMax = 0.0;
+    if (s_benchLog) dataLogReport(0);
+
+    for (uint32_t i = 0; i < frames; i++) {
+        // Advance the virtual clock one frame, delivering the 50 Hz CAN feed
+        // and 10 Hz UI updates that fall inside it
+        uint32_t frameEnd = tMs + frameMs;
+        double   logUs = 0.0;
+        for (; tMs < frameEnd; tMs++) {
+            if (tMs - lastFeedMs >= 20) {
+                lastFeedMs = tMs;
+                Clock::time_point f0 = Clock::now();
+                _feedSweep(tMs);
+                if (s_benchLog) logUs += std::chrono::duration<double, std::micro>(Clock::now() - f0).count();
+            }
+            if (tMs - lastUpdateMs >= 100) { lastUpdateMs = tMs; _updateScreen(idx, tMs); }
+        }
+        if (s_benchLog) {
+            Clock::time_point p0 = Clock::now();
+            dataLogPump(false);
+            logUs += std::chrono::duration<double, std::micro>(Clock::now() - p0).count();
+            logAddedUsMax = std::max(logAddedUsMax, logUs);
+        }
+        lv_tick_inc(frameMs);
+
+        uint64_t before = s_flushBytes;
+        Clock::time_point t0 = Clock::now();
+        lv_timer_handler();
+        Clock::time_point t1 = Clock::now();
+        if (s_flushBytes != before) {
+            renderUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        }
+    }
+    uint64_t flushTotal = s_flushBytes;
+    uint32_t invalidPxPerSec = uiStatsInvalidatedPxPerSec();
+    roundViewportReport(rvPx, rvBytes);
+
+    double mean = 0.0, p99 = 0.0, worst = 0.0;
+    if (!renderUs.empty()) {
+        for (double us : renderUs) mean += us;
+        mean /= renderUs.size();
+        std::sort(renderUs.begin(), renderUs.end());
+        p99   = renderUs[(size_t)((renderUs.size() - 1) * 0.99)];
+        worst = renderUs.back();
+    }
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    printf("{\"screen\":\"%s\",\"strategy\":\"%s\",\"lines\":%u,"
+           "\"create_us\":%.1f,\"objects\":%u,\"heap_bytes\":%zu,\"heap_max_used\":%zu,"
+           "\"frames\":%u,\"rendered\":%zu,"
+           "\"render_us_mean\":%.1f,\"render_us_p99\":%.1f,\"render_us_max\":%.1f,"
+           "\"invalidated_px_per_s\":%u,"
+           "\"flush_bytes\":%llu,\"flush_bytes_per_s\":%.0f,"
+           "\"rv_saved_px_per_frame\":%u,\"rv_saved_bytes_per_frame\":%d}\n",
+           info.name, renderStrategyName(s_renderCfg.strategy), (unsigned)s_renderCfg.lines,
+           info.createUs, (unsigned)_countObjects(g_screens[idx]), info.heapBytes, (size_t)mon.max_used,
+           (unsigned)frames, renderUs.size(),
+           mean, p99, worst,
+           (unsigned)invalidPxPerSec,
+           (unsigned long long)flushTotal, flushTotal / seconds,
+           (unsigned)rvPx, (int)rvBytes);
+
+    if (s_benchLog) {
+        DataLogReport log = dataLogReport((uint32_t)(seconds * 1000.0));
+        printf("{\"log\":\"%s\",\"log_rows_per_s\":%u,\"log_bytes_per_row\":%.2f,"
+               "\"log_bytes_per_s\":%u,\"log_write_kbps\":%u,\"log_dropped_blocks\":%u,"
+               "\"log_encode_us_max\":%u,\"log_added_us_max\":%.1f}\n",
+               info.name, (unsigned)log.rowsPerSec, log.bytesPerRow, (unsigned)log.bytesPerSec,
+               (unsigned)log.writeKBps, (unsigned)log.droppedBlocks, (unsigned)log.encodeUsMax,
+               logAddedUsMax);
+    }
+}
+
+int main(int argc, char **argv) {
+    // Positional: seconds, fps; options anywhere
+    const char  *pos[2] = { nullptr, nullptr };
+    int          npos = 0;
+    bool         calibrate = false;
+    const char  *logPath = nullptr;
+    RenderConfig render = { RENDER_STRATEGY, RENDER_BUF_LINES };
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--no-round")) {
+            s_roundViewport = false;
+        } else if (!strcmp(argv[i], "--calibrate")) {
+            calibrate = true;
+        } else if (!strcmp(argv[i], "--log") && i + 1 < argc) {
+            logPath = argv[++i];
+        } else if (!strcmp(argv[i], "--lines") && i + 1 < argc) {
+            render.lines = (uint16_t)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--strategy") && i + 1 < argc) {
+            i++;
+            render.strategy = RENDER_STRATEGY_COUNT;
+            for (uint8_t st = 0; st < RENDER_STRATEGY_COUNT; st++) {
+                if (!strcmp(argv[i], renderStrategyName(st))) render.strategy = st;
+            }
+            if (render.strategy == RENDER_STRATEGY_COUNT) {
+                fprintf(stderr, "unknown strategy %s\n", argv[i]);
+                return 2;
+            }
+        } else if (npos < 2) {
+            pos[npos++] = argv[i];
+        }
+    }
+    double   seconds = pos[0] ? atof(pos[0]) : 10.0;
+    uint32_t fps     = pos[1] ? (uint32_t)atoi(pos[1]) : 30;
+    if (fps == 0) fps = 30;
+    const uint32_t frameMs = 1000 / fps;
+
+    lv_init();
+
+    lv_display_t *disp = lv_display_create(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    lv_display_set_flush_cb(disp, _benchFlush);
+    renderApply(disp, render);
+    lv_timer_set_period(lv_display_get_refr_timer(disp), frameMs);
+    roundViewportInstall(disp);   // first, so later handlers see clipped areas
+    uiStatsInstall(disp);
+
+    typedef lv_obj_t *(*CreateFn)(void);
+    typedef void      (*ReleaseFn)(void);
+    static const CreateFn creators[SCREEN_SETUP + 1] = {
+        createClockScreen, createMultiArcScreen, createAnalogBoostScreen, createLayoutScreen,
+        createSetupScreen
+    };
+    static const ReleaseFn releasers[SCREEN_SETUP + 1] = {
+        releaseClockScreen, releaseMultiArcScreen, releaseAnalogBoostScreen, releaseLayoutScreen,
+        releaseSetupScreen
+    };
+    ScreenResult info[SCREEN_SETUP + 1] = {
+        { "clock", 0, 0 }, { "multiarc", 0, 0 }, { "boostgauge", 0, 0 }, { "layout", 0, 0 },
+        { "setup", 0, 0 }
+    };
+    layoutScreenLoad(nullptr, 0);
+    for (int i = 0; i <= SCREEN_SETUP; i++) {
+        size_t heap0 = _heapUsed();
+        Clock::time_point t0 = Clock::now();
+        g_screens[i] = creators[i]();
+        Clock::time_point t1 = Clock::now();
+        info[i].createUs  = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        info[i].heapBytes = _heapUsed() - heap0;
+    }
+
+    if (calibrate) {
+        RenderCalResult cal[RENDER_CANDIDATE_COUNT];
+        RenderConfig best = renderCalibrate(disp, g_screens, SCREEN_SETUP + 1, BENCH_CAL_FRAMES, cal);
+        for (size_t i = 0; i < RENDER_CANDIDATE_COUNT; i++) {
+            printf("{\"calibrate\":\"%s\",\"lines\":%u,\"clock_us\":%u,\"multiarc_us\":%u,"
+                   "\"boostgauge_us\":%u,\"layout_us\":%u,\"setup_us\":%u,\"mean_us\":%u}\n",
+                   renderStrategyName(cal[i].used.strategy), (unsigned)cal[i].used.lines,
+                   (unsigned)cal[i].screenUs[SCREEN_CLOCK], (unsigned)cal[i].screenUs[SCREEN_MULTIARC],
+                   (unsigned)cal[i].screenUs[SCREEN_BOOSTGAUGE], (unsigned)cal[i].screenUs[SCREEN_LAYOUT],
+                   (unsigned)cal[i].screenUs[SCREEN_SETUP],
+                   (unsigned)cal[i].meanUs);
+        }
+        fprintf(stderr, "roundie_bench: fastest is %s, %u lines\n",
+                renderStrategyName(best.strategy), (unsigned)best.lines);
+    }
+
+    fprintf(stderr, "roundie_bench: %.1f s per screen at %u fps, %dx%d, %s with %u-line buffers, round viewport %s\n",
+            seconds, (unsigned)fps, DISPLAY_WIDTH, DISPLAY_HEIGHT,
+            renderStrategyName(s_renderCfg.strategy), (unsigned)s_renderCfg.lines,
+            s_roundViewport ? "on" : "off");
+    if (logPath) {
+        if (!dataLogBegin(logPath)) {
+            fprintf(stderr, "cannot create %s\n", logPath);
+            return 2;
+        }
+        s_benchLog = true;
+    }
+    for (int i = 0; i <= SCREEN_SETUP; i++) {
+        _runScreen(i, info[i], seconds, frameMs);
+    }
+    if (s_benchLog) dataLogEnd();
+
+    // Teardown and rebuild, as the screen manager does under its heap
+    // budget (screen_manager.h): a release that leaves anything behind
+    // shows up as heap growth.
+    lv_screen_load(lv_obj_create(nullptr));
+    for (int i = 0; i <= SCREEN_SETUP; i++) {
+        size_t heap0 = _heapUsed();
+        lv_obj_delete(g_screens[i]);
+        releasers[i]();
+        size_t freed = heap0 - _heapUsed();
+        Clock::time_point t0 = Clock::now();
+        g_screens[i] = creators[i]();
+        Clock::time_point t1 = Clock::now();
+        printf("{\"rebuild\":\"%s\",\"freed_bytes\":%zu,\"create_us\":%.1f,\"heap_growth\":%ld}\n",
+               info[i].name, freed, std::chrono::duration<double, std::micro>(t1 - t0).count(),
+               (long)_heapUsed() - (long)heap0);
+    }
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <lvgl.h>
 #include "config.h"
 #include "Preferences.h"
+#include "can_handler.h"
 
 // ── Unit system ───────────────────────────────────────────────────────────────
 bool g_isMetric = true;
@@ -9,15 +10,11 @@ bool g_isMetric = true;
 int g_currentScreen = SCREEN_CLOCK;
 int g_prevScreen    = SCREEN_CLOCK;
 
-lv_obj_t* g_screens[4] = {};
+lv_obj_t* g_screens[SCREEN_SETUP + 1] = {};
 
 // ── Sensor data (declared extern in can_handler.h) ────────────────────────────
-float    g_lambda       = 1.0f;
-float    g_boostKpa     = 0.0f;
-float    g_fuelPressKpa = 0.0f;
-uint16_t g_rpm          = 0;
-float    g_coolantC     = 20.0f;
-float    g_oilPressKpa  = 0.0f;
+SensorRecord          g_sensorWork = SENSOR_RECORD_INIT;
+SeqLock<SensorRecord> g_sensors(g_sensorWork);
 
 // ── NVS preferences stub ──────────────────────────────────────────────────────
 Preferences g_prefs;
\ No newline at end of file
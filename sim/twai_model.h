@@ -0,0 +1,101 @@
+/**
+ * sim/twai_model.h
+ * Model of the ESP32's TWAI controller and the ESP-IDF driver's receive
+ * side, as the CAN task sees them.
+ *
+ * configure() takes the driver's acceptance code and mask
+ * (twai_filter_config_t); receive() puts a frame "on the bus": it is
+ * matched by the hardware filter, as the SJA1000-style controller does in
+ * single- or dual-filter mode, and an accepted frame is queued for the
+ * task, as the driver's ISR does – or counted as missed when the queue of
+ * CAN_TWAI_RX_QUEUE_LEN is full (the driver's rx_missed_count).  read() is
+ * twai_receive() with no wait.
+ *
+ * The hardware FIFO is not modelled: the driver's ISR empties it long
+ * before it can overrun at any real frame rate.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <can.h>
+#include "config.h"
+
+class TwaiModel {
+public:
+    /** Acceptance filter as installed; the default accepts everything. */
+    void configure(uint32_t code, uint32_t mask, bool single) {
+        m_code = code;
+        m_mask = mask;
+        m_single = single;
+    }
+
+    /**
+     * A frame on the bus (SocketCAN id).
+     * @return true if it was queued for the task
+     */
+    bool receive(const struct can_frame &f) {
+        if (!_accepts(f)) return false;
+        if (m_count == CAN_TWAI_RX_QUEUE_LEN) {
+            m_missed++;
+            return false;
+        }
+        m_queue[(m_head + m_count) % CAN_TWAI_RX_QUEUE_LEN] = f;
+        m_count++;
+        return true;
+    }
+
+    /** twai_receive() with a zero timeout.  @return false when the queue is empty */
+    bool read(struct can_frame &f) {
+        if (m_count == 0) return false;
+        f = m_queue[m_head];
+        m_head = (m_head + 1) % CAN_TWAI_RX_QUEUE_LEN;
+        m_count--;
+        return true;
+    }
+
+    uint32_t queued(void) const { return m_count; }
+    uint32_t missed(void) const { return m_missed; }
+
+private:
+    uint32_t m_code = 0, m_mask = 0xFFFFFFFFu;
+    bool     m_single = true;
+    struct can_frame m_queue[CAN_TWAI_RX_QUEUE_LEN];
+    uint32_t m_head = 0, m_count = 0, m_missed = 0;
+
+    /** code/mask compare over the bits in region; mask bits set are "don't care". */
+    bool _match(uint32_t frameBits, uint32_t region) const {
+        return ((frameBits ^ m_code) & ~m_mask & region) == 0;
+    }
+
+    /**
+     * The acceptance registers laid over the frame's first bytes:
+     *   standard  ID10..0, RTR, data byte 0, data byte 1
+     *   extended  ID28..0, RTR
+     * Single-filter mode compares all 32 bits (standard frames skip the
+     * RTR-bit gap); dual-filter mode compares ID, RTR and data byte 0 in
+     * filter 1 (bits 31:16 and 3:0) and ID and RTR in filter 2 (bits 15:4)
+     * for standard frames, and ID28..13 in both halves for extended ones.
+     */
+    bool _accepts(const struct can_frame &f) const {
+        bool     ext = (f.can_id & CAN_EFF_FLAG) != 0;
+        uint32_t rtr = (f.can_id & CAN_RTR_FLAG) ? 1 : 0;
+        uint8_t  d0  = f.can_dlc > 0 ? f.data[0] : 0;
+        uint8_t  d1  = f.can_dlc > 1 ? f.data[1] : 0;
+        if (ext) {
+            uint32_t id = f.can_id & CAN_EFF_MASK;
+            if (m_single) return _match((id << 3) | (rtr << 2), 0xFFFFFFFCu);
+            uint32_t top = id >> 13;
+            return _match(top << 16, 0xFFFF0000u) || _match(top, 0x0000FFFFu);
+        }
+        uint32_t id = f.can_id & CAN_SFF_MASK;
+        if (m_single) {
+            return _match((id << 21) | (rtr << 20) | ((uint32_t)d0 << 8) | d1, 0xFFF0FFFFu);
+        }
+        uint32_t f1 = (id << 21) | (rtr << 20) | ((uint32_t)(d0 >> 4) << 16) | (d0 & 0x0Fu);
+        uint32_t f2 = (id << 5) | (rtr << 4);
+        return _match(f1, 0xFFFF000Fu) || _match(f2, 0x0000FFF0u);
+    }
+};
@@ -0,0 +1,453 @@
+#!/usr/bin/env python3
+"""
+dbc2header.py
+Generate roundie/can_signals.h – constexpr CAN signal descriptors plus an
+O(1) id → message dispatch table – from a DBC file or a simple signal table.
+
+Usage:
+    python3 tools/dbc2header.py tools/haltech_v2.sig -o roundie/can_signals.h
+    python3 tools/dbc2header.py vehicle.dbc --tune vehicle.tune -o roundie/can_signals.h
+
+Input formats
+  *.dbc   Standard Vector DBC.  BO_ / SG_ lines are read; everything else is
+          ignored.  Multiplexed signals are rejected.  Signal names become
+          channel names (CH_<NAME>).
+  other   Whitespace-separated signal table, one signal per line:
+              id name start len sign endian scale offset [default [unit]]
+          sign is u/s, endian is le/be; see tools/haltech_v2.sig.
+
+Channel tuning
+  Lines of the form
+      @tune name filter step lo..hi ui_ms
+  in the signal table (or, for a DBC, in the --tune file) set a channel's
+  filter (none, ema:<ms>, rate:<per s>, kalman:<q>,<r>), its smallest
+  animated step, its statistics histogram range and its shortest screen
+  refresh interval.  A channel with a line is displayed: the displayed
+  channels come first in SensorChannel order, SENSOR_DISPLAY_COUNT of them
+  (at most MAX_DISPLAY, the bits of a SensorMask), and only they reach the
+  UI thread's change mask.  SENSOR_FILTERS and SENSOR_STATS_RANGE get one
+  entry per channel, SENSOR_INTERP_MIN_STEP and UI_CHANNEL_PERIOD_MS one
+  per displayed channel.  A channel without a line is unfiltered and gets
+  the signal's full range.
+
+Logged channels
+  Lines of the form
+      @log name [name ...]
+  pick the data logger's columns (SENSOR_LOG_CHANNELS); without any, every
+  channel is logged.  Messages that carry a displayed or logged channel are
+  marked wanted in kCanMessages and only those get acceptance filters.
+  The rest are still decoded when they arrive, e.g. from a replay.
+
+Dispatch
+  If the message ids span a small range the header gets a dense lookup table
+  indexed by (id - base).  Otherwise a multiplicative perfect hash is searched
+  for: slot = (id * MULT) >> (32 - BITS), with the id verified on hit.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+DENSE_MAX_SPAN = 256
+MAX_SIGNALS = 255          # uint8_t channel / firstSignal, 0xFF marks "none"
+MAX_DISPLAY = 64           # displayed channels: bits of a SensorMask (can_handler.h)
+
+FILTER_KINDS = {"none": "SENSOR_FILTER_NONE", "ema": "SENSOR_FILTER_EMA",
+                "rate": "SENSOR_FILTER_RATE", "kalman": "SENSOR_FILTER_KALMAN"}
+
+
+class Signal:
+    def __init__(self, can_id, name, start, length, signed, big_endian,
+                 scale, offset, default=0.0, unit=""):
+        self.can_id = can_id
+        self.name = name
+        self.start = start
+        self.length = length
+        self.signed = signed
+        self.big_endian = big_endian
+        self.scale = scale
+        self.offset = offset
+        self.default = default
+        self.unit = unit
+
+    def phys_range(self):
+        """Physical values of the smallest and largest raw value."""
+        if self.signed:
+            lo, hi = -(1 << (self.length - 1)), (1 << (self.length - 1)) - 1
+        else:
+            lo, hi = 0, (1 << self.length) - 1
+        a, b = lo * self.scale + self.offset, hi * self.scale + self.offset
+        return float(f"{min(a, b):.7g}"), float(f"{max(a, b):.7g}")
+
+    def last_byte(self):
+        """Index of the highest payload byte the signal touches."""
+        if not self.big_endian:
+            return (self.start + self.length - 1) // 8
+        # Motorola: walk from the MSB down through the sawtooth numbering
+        byte = self.start // 8
+        bits_left = self.length - (self.start % 8 + 1)
+        while bits_left > 0:
+            byte += 1
+            bits_left -= 8
+        return byte
+
+
+def _channel_name(name):
+    return re.sub(r"[^A-Za-z0-9]+", "_", name).strip("_").upper()
+
+
+class Tune:
+    def __init__(self, kind, a, b, step, lo, hi, ui_ms):
+        self.kind = kind
+        self.a = a
+        self.b = b
+        self.step = step
+        self.lo = lo
+        self.hi = hi
+        self.ui_ms = ui_ms
+
+
+def _parse_tune(cols, where):
+    if len(cols) != 6:
+        sys.exit(f"{where}: expected @tune name filter step lo..hi ui_ms")
+    kind, _, args = cols[2].lower().partition(":")
+    params = [float(v) for v in args.split(",")] if args else []
+    need = {"none": 0, "ema": 1, "rate": 1, "kalman": 2}
+    if kind not in need or len(params) != need[kind]:
+        sys.exit(f"{where}: filter must be none, ema:<ms>, rate:<per s> or kalman:<q>,<r>")
+    rng = re.fullmatch(r"([-+0-9.eE]+)\.\.([-+0-9.eE]+)", cols[4])
+    if not rng or not float(rng.group(2)) > float(rng.group(1)):
+        sys.exit(f"{where}: range must be LO..HI with HI > LO")
+    ui_ms = int(cols[5])
+    if not 1 <= ui_ms <= 65535:
+        sys.exit(f"{where}: ui_ms outside 1-65535")
+    params += [0.0] * (2 - len(params))
+    return _channel_name(cols[1]), Tune(kind, params[0], params[1], float(cols[3]),
+                                        float(rng.group(1)), float(rng.group(2)), ui_ms)
+
+
+def parse_tunes(path):
+    """{channel name: Tune} from the @tune lines of path."""
+    tunes = {}
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            cols = line.split("#", 1)[0].split()
+            if not cols or cols[0] != "@tune":
+                continue
+            name, tune = _parse_tune(cols, f"{path}:{lineno}")
+            if name in tunes:
+                sys.exit(f"{path}:{lineno}: second @tune line for {name}")
+            tunes[name] = tune
+    return tunes
+
+
+def parse_logs(path):
+    """Channel names from the @log lines of path, or None if it has none."""
+    logs = None
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            cols = line.split("#", 1)[0].split()
+            if not cols or cols[0] != "@log":
+                continue
+            if len(cols) < 2:
+                sys.exit(f"{path}:{lineno}: expected @log name [name ...]")
+            if logs is None:
+                logs = set()
+            for name in map(_channel_name, cols[1:]):
+                if name in logs:
+                    sys.exit(f"{path}:{lineno}: {name} is already logged")
+                logs.add(name)
+    return logs
+
+
+def parse_sig(path):
+    signals = []
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line or line.startswith("@"):
+                continue
+            cols = line.split()
+            if len(cols) < 8:
+                sys.exit(f"{path}:{lineno}: expected at least 8 columns")
+            sign, endian = cols[4].lower(), cols[5].lower()
+            if sign not in ("u", "s") or endian not in ("le", "be"):
+                sys.exit(f"{path}:{lineno}: sign must be u/s and endian le/be")
+            signals.append(Signal(
+                can_id=int(cols[0], 0), name=cols[1],
+                start=int(cols[2]), length=int(cols[3]),
+                signed=(sign == "s"), big_endian=(endian == "be"),
+                scale=float(cols[6]), offset=float(cols[7]),
+                default=float(cols[8]) if len(cols) > 8 else 0.0,
+                unit=cols[9] if len(cols) > 9 else ""))
+    return signals
+
+
+_BO_RE = re.compile(r"^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)")
+_SG_RE = re.compile(
+    r"^SG_\s+(\w+)\s*(\S*)\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*"
+    r"\(\s*([-+0-9.eE]+)\s*,\s*([-+0-9.eE]+)\s*\)\s*"
+    r"\[[^\]]*\]\s*\"([^\"]*)\"")
+
+
+def parse_dbc(path):
+    signals = []
+    can_id = None
+    with open(path, encoding="latin-1") as f:
+        for lineno, raw in enumerate(f, 1):
+            line = raw.strip()
+            m = _BO_RE.match(line)
+            if m:
+                can_id = int(m.group(1)) & 0x1FFFFFFF
+                continue
+            m = _SG_RE.match(line)
+            if m:
+                if can_id is None:
+                    sys.exit(f"{path}:{lineno}: SG_ outside of a BO_ block")
+                if m.group(2):
+                    sys.exit(f"{path}:{lineno}: multiplexed signal "
+                             f"'{m.group(1)}' is not supported")
+                signals.append(Signal(
+                    can_id=can_id, name=m.group(1),
+                    start=int(m.group(3)), length=int(m.group(4)),
+                    signed=(m.group(6) == "-"), big_endian=(m.group(5) == "0"),
+                    scale=float(m.group(7)), offset=float(m.group(8)),
+                    unit=m.group(9)))
+    return signals
+
+
+def validate_tunes(signals, tunes, logs):
+    names = {_channel_name(s.name) for s in signals}
+    for name in tunes:
+        if name not in names:
+            sys.exit(f"@tune for unknown channel {name}")
+    for name in sorted(logs or ()):
+        if name not in names:
+            sys.exit(f"@log for unknown channel {name}")
+    if len(tunes) > MAX_DISPLAY:
+        sys.exit(f"{len(tunes)} @tune lines; at most {MAX_DISPLAY} displayed channels fit "
+                 "a SensorMask (can_handler.h)")
+
+
+def validate(signals):
+    if not signals:
+        sys.exit("no signals found")
+    seen = set()
+    for s in signals:
+        ch = _channel_name(s.name)
+        if ch in seen:
+            sys.exit(f"duplicate channel name {ch}")
+        seen.add(ch)
+        if not 1 <= s.length <= 32:
+            sys.exit(f"{s.name}: length {s.length} outside 1-32")
+        if s.last_byte() > 7 or s.start > 63:
+            sys.exit(f"{s.name}: signal does not fit in 8 bytes")
+        if s.big_endian:
+            shift = (7 - s.start // 8) * 8 + s.start % 8 - (s.length - 1)
+            if shift < 0:
+                sys.exit(f"{s.name}: Motorola signal runs past byte 7")
+    if len(signals) > MAX_SIGNALS:
+        sys.exit(f"{len(signals)} signals; at most {MAX_SIGNALS} fit the uint8_t indexes")
+
+
+def group_messages(signals):
+    """Return [(id, [signals])] sorted by id; signals keep file order."""
+    by_id = {}
+    for s in signals:
+        by_id.setdefault(s.can_id, []).append(s)
+    return sorted(by_id.items())
+
+
+def channel_order(signals, tunes):
+    """Signals in SensorChannel order: the displayed ones, then the rest,
+    each in message order."""
+    ordered = [s for _, sigs in group_messages(signals) for s in sigs]
+    shown = [s for s in ordered if _channel_name(s.name) in tunes]
+    return shown + [s for s in ordered if _channel_name(s.name) not in tunes]
+
+
+def find_perfect_hash(ids):
+    """Smallest table (power of two) with a collision-free multiplier."""
+    bits = max(1, (len(ids) - 1).bit_length())
+    for b in range(bits, bits + 6):
+        for mult in range(0x9E3779B1, 0x9E3779B1 + 200000, 2):
+            slots = {((i * mult) & 0xFFFFFFFF) >> (32 - b) for i in ids}
+            if len(slots) == len(ids):
+                return mult, b
+    sys.exit("no perfect hash found; split the id set")
+
+
+def _f(x):
+    s = repr(float(x))
+    if "e" not in s and "." not in s:
+        s += ".0"
+    return s + "f"
+
+
+def _rows(items, per_line=6, macro=True):
+    """Initializer entries, per_line to a line (continued, in a macro)."""
+    items = list(items)
+    end = ", \\\n" if macro else ",\n"
+    return "".join("    " + ", ".join(items[i:i + per_line]) + end
+                   for i in range(0, len(items), per_line))
+
+
+def emit(signals, tunes, logs, src, out):
+    msgs = group_messages(signals)
+    ordered = [s for _, sigs in msgs for s in sigs]
+    channels = channel_order(signals, tunes)
+    names = [_channel_name(s.name) for s in channels]
+    shown = [n for n in names if n in tunes]
+    logged = [n for n in names if logs is None or n in logs]
+    ids = [mid for mid, _ in msgs]
+    w = out.write
+
+    w("/**\n")
+    w(" * can_signals.h\n")
+    w(f" * GENERATED by tools/dbc2header.py from {src} – do not edit.\n")
+    w(" *\n")
+    w(" * Signal table:\n")
+    for s in ordered:
+        name = _channel_name(s.name)
+        flags = ("ui " if name in tunes else "   ") + ("log" if name in logged else "   ")
+        w(f" *   0x{s.can_id:03X}  {name:<18} {flags}  "
+          f"bits {s.start:>2}+{s.length:<2} {'s' if s.signed else 'u'} "
+          f"{'be' if s.big_endian else 'le'}  × {s.scale:g} + {s.offset:g}"
+          f"{'  ' + s.unit if s.unit else ''}\n")
+    w(" */\n\n")
+    w("#pragma once\n\n")
+    w("#include <stdint.h>\n")
+    w("#include \"can_signal.h\"\n\n")
+
+    w("// ── Decoded channels ─────────────────────────────────────────────────────────\n")
+    w("// Displayed channels (@tune lines) first: CH_x < SENSOR_DISPLAY_COUNT\n")
+    w("enum SensorChannel : uint8_t {\n")
+    for i, name in enumerate(names):
+        w(f"    CH_{name} = {i},\n")
+    w("    SENSOR_CHANNEL_COUNT\n")
+    w("};\n")
+    w(f"#define SENSOR_DISPLAY_COUNT {len(shown)}\n\n")
+    w("// Value of each channel before its first frame arrives\n")
+    w("#define SENSOR_CHANNEL_DEFAULTS { \\\n"
+      + _rows(_f(s.default) for s in channels) + "}\n\n")
+    w("// Channel names, e.g. for log file headers\n")
+    w("#define SENSOR_CHANNEL_NAMES { \\\n"
+      + _rows(f'"{n}"' for n in names) + "}\n\n")
+
+    w("// ── Logged channels (@log lines) ─────────────────────────────────────────────\n")
+    w("// Data log columns, in channel order (data_logger.h)\n")
+    w(f"#define SENSOR_LOG_COUNT {len(logged)}\n")
+    w("#define SENSOR_LOG_CHANNELS { \\\n"
+      + _rows(f"CH_{n}" for n in logged) + "}\n")
+    w("// Log column of each channel, 0xFF if it is not logged\n")
+    w("#define SENSOR_LOG_COLUMN { \\\n"
+      + _rows(f"{logged.index(n)}" if n in logged else "0xFF" for n in names) + "}\n\n")
+
+    w("// ── Per-channel tuning (@tune lines) ─────────────────────────────────────────\n")
+    tuned = []
+    for s in channels:
+        t = tunes.get(_channel_name(s.name))
+        if t is None:
+            lo, hi = s.phys_range()
+            t = Tune("none", 0.0, 0.0, abs(s.scale), lo, hi, 0)
+        tuned.append(t)
+    w("// Filter of each channel (sensor_filter.h): { kind, a, b }\n")
+    w("#define SENSOR_FILTERS { \\\n")
+    for t in tuned:
+        w(f"    {{ {FILTER_KINDS[t.kind]}, {_f(t.a)}, {_f(t.b)} }}, \\\n")
+    w("}\n")
+    w("// Histogram range { low, high } for session statistics (sensor_stats.h)\n")
+    w("#define SENSOR_STATS_RANGE { \\\n"
+      + _rows((f"{{ {_f(t.lo)}, {_f(t.hi)} }}" for t in tuned), 4) + "}\n")
+    w("// Smallest change animated instead of shown at once, per displayed channel\n")
+    w("// (sensor_interp.h)\n")
+    w("#define SENSOR_INTERP_MIN_STEP { "
+      + ", ".join(_f(tunes[n].step) for n in shown) + " }\n")
+    w("// Shortest interval between screen refreshes a displayed channel triggers, ms\n")
+    w("// (ui_runtime.h)\n")
+    w("#define UI_CHANNEL_PERIOD_MS { "
+      + ", ".join(str(tunes[n].ui_ms) for n in shown) + " }\n\n")
+
+    w("// ── Signal descriptors (grouped by message) ──────────────────────────────────\n")
+    w("static constexpr CanSignal kCanSignals[] = {\n")
+    for s in ordered:
+        w(f"    canSignal(0x{s.can_id:03X}, {s.start:>2}, {s.length:>2}, "
+          f"{'true ' if s.signed else 'false'}, "
+          f"{'true ' if s.big_endian else 'false'}, "
+          f"{_f(s.scale)}, {_f(s.offset)}, CH_{_channel_name(s.name)}),\n")
+    w("};\n\n")
+
+    w("// { id, minDlc, firstSignal, signalCount, wanted, decode }\n")
+    w("static constexpr CanMessage kCanMessages[] = {\n")
+    first = 0
+    for mid, sigs in msgs:
+        min_dlc = max(s.last_byte() for s in sigs) + 1
+        wanted = any(_channel_name(s.name) in tunes or _channel_name(s.name) in logged
+                     for s in sigs)
+        w(f"    {{ 0x{mid:03X}, {min_dlc}, {first:>2}, {len(sigs)}, {int(wanted)}, "
+          f"decodeCanSignals<kCanSignals, {first}, {len(sigs)}> }},\n")
+        first += len(sigs)
+    w("};\n")
+    w(f"#define CAN_MESSAGE_COUNT {len(msgs)}\n\n")
+
+    w("// ── id → message dispatch ────────────────────────────────────────────────────\n")
+    span = ids[-1] - ids[0] + 1
+    if span <= DENSE_MAX_SPAN:
+        table = [0xFF] * span
+        for i, mid in enumerate(ids):
+            table[mid - ids[0]] = i
+        w(f"#define CAN_DISPATCH_BASE 0x{ids[0]:03X}\n")
+        w(f"#define CAN_DISPATCH_SPAN {span}\n")
+        w("static constexpr uint8_t kCanDispatch[CAN_DISPATCH_SPAN] = {\n"
+          + _rows((f"0x{v:02X}" for v in table), 16, False) + "};\n\n")
+        w("/** Index into kCanMessages for a CAN id, or -1 if it is not decoded. */\n")
+        w("inline int canMessageIndex(uint32_t id) {\n")
+        w("    uint32_t slot = id - CAN_DISPATCH_BASE;\n")
+        w("    if (slot >= CAN_DISPATCH_SPAN) return -1;\n")
+        w("    uint8_t m = kCanDispatch[slot];\n")
+        w("    return m == 0xFF ? -1 : m;\n")
+        w("}\n")
+    else:
+        mult, bits = find_perfect_hash(ids)
+        table = [0xFF] * (1 << bits)
+        for i, mid in enumerate(ids):
+            table[((mid * mult) & 0xFFFFFFFF) >> (32 - bits)] = i
+        w(f"#define CAN_DISPATCH_MULT 0x{mult:08X}u\n")
+        w(f"#define CAN_DISPATCH_BITS {bits}\n")
+        w("static constexpr uint8_t kCanDispatch[1u << CAN_DISPATCH_BITS] = {\n"
+          + _rows((f"0x{v:02X}" for v in table), 16, False) + "};\n\n")
+        w("/** Index into kCanMessages for a CAN id, or -1 if it is not decoded. */\n")
+        w("inline int canMessageIndex(uint32_t id) {\n")
+        w("    uint8_t m = kCanDispatch[(uint32_t)(id * CAN_DISPATCH_MULT)"
+          " >> (32 - CAN_DISPATCH_BITS)];\n")
+        w("    return (m != 0xFF && kCanMessages[m].id == id) ? m : -1;\n")
+        w("}\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("input", help="DBC file or signal table")
+    ap.add_argument("-o", "--output", required=True, help="header to write")
+    ap.add_argument("--tune", help="file with @tune and @log lines "
+                    "(default: the signal table itself)")
+    args = ap.parse_args()
+
+    if args.input.lower().endswith(".dbc"):
+        signals = parse_dbc(args.input)
+        tunes = parse_tunes(args.tune) if args.tune else {}
+        logs = parse_logs(args.tune) if args.tune else None
+    else:
+        signals = parse_sig(args.input)
+        tunes = parse_tunes(args.tune or args.input)
+        logs = parse_logs(args.tune or args.input)
+    validate(signals)
+    validate_tunes(signals, tunes, logs)
+
+    src = os.path.relpath(args.input).replace(os.sep, "/")
+    with open(args.output, "w", newline="\n") as out:
+        emit(signals, tunes, logs, src, out)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,349 @@
+#!/usr/bin/env python3
+"""
+gauge2rgl.py
+Compile a text gauge layout into the binary .rgl format read by
+roundie/gauge_layout.h, and optionally into a header that builds it into
+the firmware as the default layout.
+
+Usage:
+    python3 tools/gauge2rgl.py tools/engine.gauge -o engine.rgl
+    python3 tools/gauge2rgl.py tools/engine.gauge \\
+        --header roundie/gauge_layout_default.h
+
+Layout file
+  One widget per line, drawn in file order; '#' starts a comment.  A line is
+  a kind followed by key=value pairs (values with spaces in double quotes):
+
+      screen   bg=000000
+      arc      ch=COOLANT_C size=450 width=10 start=150 sweep=240 color=00BFFF
+               track=303030 metric=C:40..130 imperial=F:100..270
+      scale    ch=RPM size=400 start=135 sweep=270 major=2 range=krpm:0..8/0.5
+      needle   ch=RPM length=150 tail=20 width=4 start=135 sweep=270
+               color=FF8000 range=rpm:0..8000
+      readout  ch=OIL_PRESS_KPA y=90 cell=28x48 stroke=6 digits=3 metric=kPa
+               imperial=psi
+      text     text="OIL" y=54 font=8 color=AAAAAA
+      unit     ch=OIL_PRESS_KPA y=130 font=16
+
+  (A widget is one line; it is wrapped here for width.)  Common keys: x, y
+  (offset of the widget's centre from the screen centre), color (RRGGBB),
+  ch (channel name from the signal table).  Units are given per unit system
+  as metric=UNIT[:LO..HI[/STEP]] and imperial=..., or range=... for both;
+  STEP is a scale's minor tick spacing.  Units:
+      raw kPa bar psi C F lambda AFR rpm krpm
+  and each must match the dimension of the channel's unit in the signal
+  table (kPa, degC, lambda, rpm); raw fits any channel.
+
+Channels
+  Widgets bind channels by index, so the layout is compiled against the
+  signal table the firmware's can_signals.h was generated from (--signals,
+  default tools/haltech_v2.sig, and --tune as given to dbc2header.py).  A
+  hash of the channel names goes into the blob and the firmware refuses a
+  layout whose hash differs.  Only displayed channels (with a @tune line)
+  can be bound: the others never wake the UI.
+"""
+
+import argparse
+import os
+import re
+import shlex
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from dbc2header import (_channel_name, channel_order, parse_dbc, parse_sig,  # noqa: E402
+                        parse_tunes, validate)
+
+MAGIC = b"RGL1"
+VERSION = 1
+MAX_WIDGETS = 24
+MAX_TEXT = 512
+NO_CHANNEL = 0xFF
+
+HEADER = struct.Struct("<4sBBHII")                  # GaugeLayoutHeader, 16 bytes
+RECORD = struct.Struct("<BB2B6h4B2I2H2f2f2f")       # GaugeWidgetRec, 56 bytes
+
+KINDS = {"arc": 1, "needle": 2, "scale": 3, "readout": 4, "text": 5, "unit": 6}
+
+# Same order as enum GaugeUnit; name → dimension (None = any)
+UNITS = [("raw", None), ("kPa", "pressure"), ("bar", "pressure"), ("psi", "pressure"),
+         ("C", "temperature"), ("F", "temperature"), ("lambda", "mixture"),
+         ("AFR", "mixture"), ("rpm", "speed"), ("krpm", "speed")]
+UNIT_IDS = {name.lower(): i for i, (name, _) in enumerate(UNITS)}
+
+# Signal table unit text → dimension
+SIGNAL_DIMENSIONS = {"kpa": "pressure", "kpa_abs": "pressure", "degc": "temperature",
+                     "c": "temperature", "lambda": "mixture", "rpm": "speed"}
+
+# Keys each kind accepts, beyond x, y and color
+KIND_KEYS = {
+    "arc":     {"ch", "size", "width", "start", "sweep", "track", "metric", "imperial", "range"},
+    "needle":  {"ch", "length", "tail", "width", "start", "sweep", "metric", "imperial", "range"},
+    "scale":   {"ch", "size", "start", "sweep", "major", "width", "decimals", "font", "rim",
+                "metric", "imperial", "range"},
+    "readout": {"ch", "cell", "stroke", "digits", "decimals", "metric", "imperial", "range"},
+    "text":    {"text", "font"},
+    "unit":    {"ch", "font", "metric", "imperial", "range"},
+}
+
+_UNIT_RE = re.compile(r"^(\w+)(?::([-+0-9.eE]+)\.\.([-+0-9.eE]+)(?:/([-+0-9.eE]+))?)?$")
+
+
+def channel_hash(names):
+    """FNV-1a over the names, each with its terminating NUL (gaugeChannelHash())."""
+    h = 2166136261
+    for name in names:
+        for b in name.encode() + b"\0":
+            h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def load_channels(path, tune=None):
+    """(name, dimension, displayed) of each channel in SensorChannel order."""
+    dbc = path.lower().endswith(".dbc")
+    signals = parse_dbc(path) if dbc else parse_sig(path)
+    validate(signals)
+    if tune:
+        tunes = parse_tunes(tune)
+    else:
+        tunes = {} if dbc else parse_tunes(path)
+    return [(_channel_name(s.name), SIGNAL_DIMENSIONS.get(s.unit.lower()),
+             _channel_name(s.name) in tunes) for s in channel_order(signals, tunes)]
+
+
+class Widget:
+    def __init__(self, kind):
+        self.kind = kind
+        self.channel = NO_CHANNEL
+        self.unit = [0, 0]
+        self.x = self.y = self.size = self.aux = self.start = self.sweep = 0
+        self.stroke = self.digits = self.decimals = self.font = 0
+        self.color = 0xFFFFFF
+        self.color2 = 0x303030
+        self.text = 0
+        self.lo = [0.0, 0.0]
+        self.hi = [0.0, 0.0]
+        self.step = [0.0, 0.0]
+
+    def pack(self):
+        return RECORD.pack(KINDS[self.kind], self.channel, *self.unit,
+                           self.x, self.y, self.size, self.aux, self.start, self.sweep,
+                           self.stroke, self.digits, self.decimals, self.font,
+                           self.color, self.color2, self.text, 0,
+                           *self.lo, *self.hi, *self.step)
+
+
+class Layout:
+    def __init__(self, channels):
+        self.channels = channels
+        self.bg = 0x000000
+        self.widgets = []
+        self.strings = bytearray()
+
+    def add_string(self, s):
+        off = len(self.strings)
+        self.strings += s.encode() + b"\0"
+        return off
+
+
+def parse_layout(path, channels):
+    names = {c[0]: i for i, c in enumerate(channels)}
+    layout = Layout(channels)
+    with open(path, encoding="utf-8") as f:
+        for lineno, line in enumerate(f, 1):
+            def fail(msg):
+                sys.exit(f"{path}:{lineno}: {msg}")
+
+            try:
+                tokens = shlex.split(line, comments=True)
+            except ValueError as e:
+                fail(str(e))
+            if not tokens:
+                continue
+            kind, pairs = tokens[0].lower(), tokens[1:]
+            args = {}
+            for p in pairs:
+                if "=" not in p:
+                    fail(f"expected key=value, got '{p}'")
+                k, v = p.split("=", 1)
+                args[k.lower()] = v
+
+            if kind == "screen":
+                layout.bg = _color(args.pop("bg", "000000"), fail)
+                if args:
+                    fail(f"unknown key(s) {', '.join(sorted(args))}")
+                continue
+            if kind not in KINDS:
+                fail(f"unknown widget kind '{kind}'")
+            unknown = set(args) - KIND_KEYS[kind] - {"x", "y", "color"}
+            if unknown:
+                fail(f"'{kind}' does not take {', '.join(sorted(unknown))}")
+            layout.widgets.append(_widget(kind, args, names, channels, layout, fail))
+    if len(layout.widgets) > MAX_WIDGETS:
+        sys.exit(f"{path}: {len(layout.widgets)} widgets, at most {MAX_WIDGETS}")
+    if len(layout.strings) > MAX_TEXT:
+        sys.exit(f"{path}: {len(layout.strings)} bytes of text, at most {MAX_TEXT}")
+    return layout
+
+
+def _int(args, key, fail, default=None, lo=-32768, hi=32767):
+    if key not in args:
+        if default is None:
+            fail(f"missing {key}=")
+        return default
+    try:
+        v = int(args[key], 0)
+    except ValueError:
+        fail(f"{key}={args[key]} is not an integer")
+    if not lo <= v <= hi:
+        fail(f"{key}={v} outside {lo}..{hi}")
+    return v
+
+
+def _color(text, fail):
+    t = text.lstrip("#")
+    if not re.fullmatch(r"[0-9A-Fa-f]{6}", t):
+        fail(f"colour '{text}' is not RRGGBB")
+    return int(t, 16)
+
+
+def _units(w, args, dim, fail, need_range, need_step):
+    specs = [args.get("metric", args.get("range")), args.get("imperial", args.get("range"))]
+    for us, spec in enumerate(specs):
+        if spec is None:
+            fail("missing metric= and imperial= (or range=)")
+        m = _UNIT_RE.match(spec)
+        if not m:
+            fail(f"unit '{spec}' is not UNIT[:LO..HI[/STEP]]")
+        uid = UNIT_IDS.get(m.group(1).lower())
+        if uid is None:
+            fail(f"unknown unit '{m.group(1)}'")
+        udim = UNITS[uid][1]
+        if udim is not None and udim != dim:
+            fail(f"unit {UNITS[uid][0]} does not fit a {dim or 'dimensionless'} channel")
+        w.unit[us] = uid
+        if need_range:
+            if m.group(2) is None:
+                fail(f"unit '{spec}' needs a range LO..HI")
+            w.lo[us], w.hi[us] = float(m.group(2)), float(m.group(3))
+            if w.hi[us] <= w.lo[us]:
+                fail(f"empty range in '{spec}'")
+        if need_step:
+            if m.group(4) is None or float(m.group(4)) <= 0:
+                fail(f"scale unit '{spec}' needs a tick step /STEP")
+            w.step[us] = float(m.group(4))
+            ticks = round((w.hi[us] - w.lo[us]) / w.step[us]) + 1
+            if not 2 <= ticks <= 121:
+                fail(f"'{spec}' gives {ticks} ticks, 2..121 allowed")
+            if ticks / w.aux > 25:
+                fail(f"'{spec}' gives more than 25 major ticks")
+
+
+def _widget(kind, args, names, channels, layout, fail):
+    w = Widget(kind)
+    w.x = _int(args, "x", fail, 0)
+    w.y = _int(args, "y", fail, 0)
+    if "color" in args:
+        w.color = _color(args["color"], fail)
+    if kind == "text":
+        w.text = layout.add_string(args.get("text", ""))
+        w.font = _int(args, "font", fail, 0, 0, 255)
+        return w
+
+    ch = args.get("ch")
+    if ch is None:
+        fail("missing ch=")
+    if ch.upper() not in names:
+        fail(f"unknown channel '{ch}' (have {', '.join(names)})")
+    w.channel = names[ch.upper()]
+    _, dim, shown = channels[w.channel]
+    if not shown:
+        fail(f"channel '{ch}' is not displayed (no @tune line)")
+
+    if kind in ("arc", "needle", "scale"):
+        w.start = _int(args, "start", fail, 0, 0, 359)
+        w.sweep = _int(args, "sweep", fail, None, 1, 360)
+    if kind == "arc":
+        w.size = _int(args, "size", fail, None, 8, 1000)
+        w.aux = _int(args, "width", fail, 10, 1, 200)
+        if "track" in args:
+            w.color2 = _color(args["track"], fail)
+    elif kind == "needle":
+        w.size = _int(args, "length", fail, None, 1, 1000)
+        w.aux = _int(args, "tail", fail, 0, 0, 1000)
+        w.stroke = _int(args, "width", fail, 4, 1, 255)
+    elif kind == "scale":
+        w.size = _int(args, "size", fail, None, 8, 1000)
+        w.aux = _int(args, "major", fail, 1, 1, 121)
+        w.stroke = _int(args, "width", fail, 2, 1, 255)
+        w.decimals = _int(args, "decimals", fail, 0, 0, 4)
+        w.font = _int(args, "font", fail, 0, 0, 255)
+        w.color2 = _color(args.get("rim", "444444"), fail)
+    elif kind == "readout":
+        cell = args.get("cell", "44x72")
+        m = re.fullmatch(r"(\d+)x(\d+)", cell)
+        if not m:
+            fail(f"cell={cell} is not WxH")
+        w.size, w.aux = int(m.group(1)), int(m.group(2))
+        w.stroke = _int(args, "stroke", fail, max(1, w.size // 5), 1, 255)
+        w.digits = _int(args, "digits", fail, 4, 1, 6)
+        w.decimals = _int(args, "decimals", fail, 0, 0, w.digits - 1)
+    elif kind == "unit":
+        w.font = _int(args, "font", fail, 16, 0, 255)
+        w.color = _color(args.get("color", "AAAAAA"), fail)
+    _units(w, args, dim, fail, need_range=kind in ("arc", "needle", "scale"),
+           need_step=(kind == "scale"))
+    return w
+
+
+def encode(layout):
+    names = [c[0] for c in layout.channels]
+    blob = HEADER.pack(MAGIC, VERSION, len(layout.widgets), len(layout.strings),
+                       channel_hash(names), layout.bg)
+    blob += b"".join(w.pack() for w in layout.widgets)
+    return blob + bytes(layout.strings)
+
+
+def emit_header(blob, src, out):
+    w = out.write
+    w("/**\n")
+    w(" * gauge_layout_default.h\n")
+    w(f" * GENERATED by tools/gauge2rgl.py from {src} – do not edit.\n")
+    w(" *\n")
+    w(" * The layout screen's built-in layout (gauge_layout.h), used when no\n")
+    w(" * layout file overrides it.\n")
+    w(" */\n\n")
+    w("#pragma once\n\n")
+    w("#include <stdint.h>\n\n")
+    w(f"static const uint8_t kGaugeLayoutDefault[{len(blob)}] = {{\n")
+    for i in range(0, len(blob), 12):
+        w("    " + ", ".join(f"0x{b:02X}" for b in blob[i:i + 12]) + ",\n")
+    w("};\n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("input", help="text layout (.gauge)")
+    ap.add_argument("-o", "--output", help="binary layout to write (.rgl)")
+    ap.add_argument("--header", help="C header to write with the layout as a byte array")
+    ap.add_argument("--signals", default=os.path.join(os.path.dirname(__file__), "haltech_v2.sig"),
+                    help="DBC file or signal table the firmware was generated from")
+    ap.add_argument("--tune", help="file with its @tune lines (default: the signal table itself)")
+    args = ap.parse_args()
+    if not args.output and not args.header:
+        ap.error("nothing to do: give -o and/or --header")
+
+    layout = parse_layout(args.input, load_channels(args.signals, args.tune))
+    blob = encode(layout)
+    if args.output:
+        with open(args.output, "wb") as out:
+            out.write(blob)
+    if args.header:
+        src = os.path.relpath(args.input).replace(os.sep, "/")
+        with open(args.header, "w", newline="\n") as out:
+            emit_header(blob, src, out)
+    print(f"{args.input}: {len(layout.widgets)} widgets, {len(blob)} bytes", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
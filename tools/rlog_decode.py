@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""
+rlog_decode.py
+Decode a roundie data log (roundie/data_logger.h) into CSV.
+
+Usage:
+    python3 tools/rlog_decode.py log0001.rlog > log0001.csv
+    python3 tools/rlog_decode.py log0001.rlog -o log0001.csv --raw
+    python3 tools/rlog_decode.py log0001.rlog --info
+
+Output
+  One row per decoded CAN frame: time_s (seconds since the first row) and
+  every channel in physical units (raw * scale + offset), or as the raw
+  integers with --raw.  --info prints the header, block count and encoded
+  size per row instead.
+
+A log cut short by a power loss or a full file system ends in a partial
+block; it is reported on stderr and skipped.
+"""
+
+import argparse
+import struct
+import sys
+
+FILE_MAGIC = b"RLG1"
+BLOCK_MAGIC = 0x4B4C4252
+NAME_LEN = 20
+BLOCK_HEADER = 16
+
+
+class LogFormatError(Exception):
+    pass
+
+
+class Channel:
+    def __init__(self, name, scale, offset):
+        self.name = name
+        self.scale = scale
+        self.offset = offset
+
+
+def _varint(buf, pos):
+    """Unsigned LEB128 varint at buf[pos]; returns (value, next pos)."""
+    value = shift = 0
+    while True:
+        if pos >= len(buf):
+            raise LogFormatError("varint runs past the block")
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if b < 0x80:
+            return value, pos
+        shift += 7
+
+
+def _unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def _s32(v):
+    v &= 0xFFFFFFFF
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+def read_header(data):
+    if data[:4] != FILE_MAGIC:
+        raise LogFormatError("not a roundie log (bad magic)")
+    count = data[4]
+    pos = 8
+    channels = []
+    for _ in range(count):
+        scale, offset = struct.unpack_from("<ff", data, pos)
+        name = data[pos + 8:pos + 8 + NAME_LEN].split(b"\0", 1)[0].decode("ascii")
+        channels.append(Channel(name, scale, offset))
+        pos += 8 + NAME_LEN
+    return channels, pos
+
+
+def decode_block(payload, rows, first_ts, nch):
+    """Return (timestamps, [column per channel]) of one block."""
+    ts = [first_ts]
+    pos = 0
+    for _ in range(rows - 1):
+        d, pos = _varint(payload, pos)
+        ts.append((ts[-1] + d) & 0xFFFFFFFF)
+    cols = []
+    for _ in range(nch):
+        col = []
+        prev = 0
+        for _ in range(rows):
+            d, pos = _varint(payload, pos)
+            prev = _s32(prev + _unzigzag(d))
+            col.append(prev)
+        cols.append(col)
+    if pos != len(payload):
+        raise LogFormatError("block payload has %d trailing bytes" % (len(payload) - pos))
+    return ts, cols
+
+
+def read_blocks(data, pos, nch):
+    """Yield (timestamps, columns) per block; stops at a truncated tail."""
+    while pos < len(data):
+        if len(data) - pos < BLOCK_HEADER:
+            print("rlog_decode: truncated block header at %d, ignored" % pos, file=sys.stderr)
+            return
+        magic, rows, _pad, size, first_ts = struct.unpack_from("<IHHII", data, pos)
+        if magic != BLOCK_MAGIC:
+            raise LogFormatError("bad block magic at offset %d" % pos)
+        pos += BLOCK_HEADER
+        if len(data) - pos < size:
+            print("rlog_decode: truncated block at %d (%d rows), ignored" % (pos - BLOCK_HEADER, rows),
+                  file=sys.stderr)
+            return
+        yield decode_block(data[pos:pos + size], rows, first_ts, nch)
+        pos += size
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("input", help=".rlog file written by the firmware or the simulator")
+    ap.add_argument("-o", "--output", help="CSV to write (default: stdout)")
+    ap.add_argument("--raw", action="store_true", help="raw integer values, not physical units")
+    ap.add_argument("--info", action="store_true", help="print a summary instead of CSV")
+    args = ap.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    try:
+        channels, pos = read_header(data)
+        nch = len(channels)
+
+        if args.info:
+            blocks = rows = 0
+            for ts, _cols in read_blocks(data, pos, nch):
+                blocks += 1
+                rows += len(ts)
+            print("channels: %s" % ", ".join(
+                "%s (x%g%+g)" % (c.name, c.scale, c.offset) for c in channels))
+            print("blocks: %d, rows: %d, %.2f bytes/row" %
+                  (blocks, rows, (len(data) - pos) / rows if rows else 0.0))
+            return
+
+        out = open(args.output, "w", newline="\n") if args.output else sys.stdout
+        out.write("time_s," + ",".join(c.name.lower() for c in channels) + "\n")
+        t0 = None
+        elapsed = 0
+        prev_ts = None
+        for ts, cols in read_blocks(data, pos, nch):
+            for r, t in enumerate(ts):
+                if t0 is None:
+                    t0 = t
+                else:
+                    elapsed += (t - prev_ts) & 0xFFFFFFFF   # micros() wraps every 71 min
+                prev_ts = t
+                if args.raw:
+                    vals = ["%d" % cols[c][r] for c in range(nch)]
+                else:
+                    vals = ["%.6g" % (cols[c][r] * channels[c].scale + channels[c].offset)
+                            for c in range(nch)]
+                out.write("%.6f,%s\n" % (elapsed / 1e6, ",".join(vals)))
+        if out is not sys.stdout:
+            out.close()
+    except (LogFormatError, struct.error) as e:
+        sys.exit("rlog_decode: %s: %s" % (args.input, e))
+
+
+if __name__ == "__main__":
+    main()